@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "itch_parser.h"
+#include "replay.h"
+#include "types/usings.h"
+
+/**
+ * @brief Book and strategy parameters shared by every backtested day
+ */
+struct BacktestConfig
+{
+    OrderbookId target_book = 0;
+    Quantity    order_qty   = 100;
+    Position    max_pos     = 1000;
+    Position    min_pos     = 0;       ///< Negative allows short positions
+    bool        resync      = false;   ///< Skip corrupt framing (ItchParser::set_resync)
+};
+
+/**
+ * @brief Outcome of replaying one capture
+ */
+struct DayResult
+{
+    std::string path;              ///< Capture file
+    bool        opened = false;    ///< File could be read
+    ReplayStats stats;             ///< Replay counters
+    int64_t     pnl = 0;           ///< Realized PnL after end-of-day settlement
+    Position    position = 0;      ///< Position at the end of the replay
+    size_t      fills = 0;         ///< Simulated fills
+    Quantity    bought = 0;        ///< Total quantity bought
+    Quantity    sold = 0;          ///< Total quantity sold
+    ResyncStats resync;            ///< Resync counters (resync mode only)
+    double      wall_ms = 0;       ///< Replay time of this day
+};
+
+/**
+ * @brief Sum of a backtest's day results
+ */
+struct BacktestTotals
+{
+    size_t   days = 0;             ///< Days replayed (files that opened)
+    size_t   failed = 0;           ///< Files that could not be read
+    size_t   msgs = 0;
+    int64_t  pnl = 0;
+    size_t   fills = 0;
+    Quantity bought = 0;
+    Quantity sold = 0;
+    int64_t  worst_day_pnl = 0;    ///< Lowest daily PnL
+    int64_t  best_day_pnl = 0;     ///< Highest daily PnL
+};
+
+/**
+ * @brief Capture files of a backtest
+ * @param path A capture file, or a directory whose regular files are all captures
+ * @return File paths, sorted by name (so day order follows date-stamped names)
+ */
+std::vector<std::string> list_captures(const std::string& path);
+
+/**
+ * @brief Replays many days in parallel, one worker per day at a time
+ * @param days Capture files, one trading day each
+ * @param config Book and strategy parameters
+ * @param workers Worker threads (0 = one per hardware thread), never more than days
+ * @return One result per day, in the order of days
+ *
+ * @details Days are independent: every worker builds its own parser,
+ * Orderbook and Strategy per day, so workers share nothing but an atomic
+ * day counter and write to their own result slots. Strategy logging is
+ * silenced and the NullObserver is used, so workers never contend on
+ * std::cout.
+ */
+std::vector<DayResult> run_backtest(const std::vector<std::string>& days,
+                                    const BacktestConfig& config,
+                                    size_t workers = 0);
+
+/**
+ * @brief Replays a single day (the body of each worker)
+ */
+DayResult run_day(const std::string& path, const BacktestConfig& config);
+
+/**
+ * @brief Sums day results
+ */
+BacktestTotals summarize(const std::vector<DayResult>& days);
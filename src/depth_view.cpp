@@ -0,0 +1,42 @@
+#include "depth_view.h"
+#include <algorithm>
+
+/**
+ * @details Implementation notes:
+ * - Binary search for the level, O(log n); insert/erase shift the tail,
+ *   which is short for levels near the top where most updates land
+ * - Bids compare descending, asks ascending, so index 0 is always the best
+ */
+void DepthView::apply(const LevelDelta& delta)
+{
+    const bool is_bid = (delta.side == Side::Buy);
+    std::vector<Level>& levels = is_bid ? bids_ : asks_;
+
+    auto it = std::lower_bound(levels.begin(), levels.end(), delta.price,
+        [is_bid](const Level& l, Price p) { return is_bid ? l.price > p : l.price < p; });
+    const bool found = (it != levels.end() && it->price == delta.price);
+
+    if (delta.num_orders == 0 && delta.aggregate == 0) {
+        if (found) levels.erase(it);
+        return;
+    }
+    if (found) {
+        it->aggregate  = delta.aggregate;
+        it->num_orders = delta.num_orders;
+    } else {
+        levels.insert(it, Level{ delta.price, delta.aggregate, delta.num_orders });
+    }
+}
+
+void DepthView::snapshot_n(size_t n, DisplayLevel& bids_out, DisplayLevel& asks_out) const
+{
+    bids_out.clear();
+    asks_out.clear();
+
+    for (size_t i = 0; i < bids_.size() && bids_out.size() < n; ++i) {
+        if (bids_[i].aggregate > 0) bids_out.emplace_back(bids_[i].price, bids_[i].aggregate);
+    }
+    for (size_t i = 0; i < asks_.size() && asks_out.size() < n; ++i) {
+        if (asks_[i].aggregate > 0) asks_out.emplace_back(asks_[i].price, asks_[i].aggregate);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "types/usings.h"
+#include "types/level_delta.h"
+
+/**
+ * @brief Aggregated depth maintained incrementally from LevelDelta records
+ *
+ * @details Consumer-side mirror of the order book's L2 state. Each side is a
+ * flat vector sorted best-first, so updates near the top touch only the
+ * front of the array and top-N reads are a straight copy.
+ */
+class DepthView
+{
+public:
+    /**
+     * @brief One aggregated price level
+     */
+    struct Level
+    {
+        Price    price;         ///< Level price
+        Quantity aggregate;     ///< Total quantity at the level
+        uint32_t num_orders;    ///< Number of orders at the level
+    };
+
+    /**
+     * @brief Applies one level delta
+     * @param delta New state of a level (aggregate 0 and no orders removes it)
+     */
+    void apply(const LevelDelta& delta);
+
+    /**
+     * @brief Applies a run of level deltas in order
+     * @param deltas Deltas drained from Orderbook's depth sink
+     */
+    void apply(const std::vector<LevelDelta>& deltas) {
+        for (const auto& d : deltas) apply(d);
+    }
+
+    /**
+     * @brief Creates a snapshot of top N price levels
+     * @param n Number of levels per side
+     * @param bids_out Output bid levels (price, quantity), best first
+     * @param asks_out Output ask levels (price, quantity), best first
+     *
+     * Same contract as Orderbook::snapshot_n (levels with quantity 0 skipped).
+     */
+    void snapshot_n(size_t n, DisplayLevel& bids_out, DisplayLevel& asks_out) const;
+
+    const std::vector<Level>& bids() const { return bids_; }   ///< Bid levels, best first
+    const std::vector<Level>& asks() const { return asks_; }   ///< Ask levels, best first
+    void clear() { bids_.clear(); asks_.clear(); }
+
+private:
+    std::vector<Level> bids_;   ///< Sorted by price descending
+    std::vector<Level> asks_;   ///< Sorted by price ascending
+};
@@ -0,0 +1,22 @@
+#include "feed_arbiter.h"
+#include "moldudp64.h"
+
+/**
+ * @details Implementation notes:
+ * - Heartbeats and end-of-session packets count as offered but are neither
+ *   wins nor late (they carry no messages)
+ */
+size_t FeedArbiter::offer(int line, const char* data, size_t len)
+{
+    const int l = line == LINE_B ? LINE_B : LINE_A;
+    ++stats_.packets[l];
+
+    const size_t fresh = seq_.offer(data, len);
+
+    mold::PacketHeader h{};
+    if (mold::read_header(data, len, h) && !h.heartbeat() && !h.end_of_session()) {
+        if (fresh > 0) ++stats_.wins[l];
+        else           ++stats_.late[l];
+    }
+    return fresh;
+}
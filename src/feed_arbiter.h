@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "mold_sequencer.h"
+
+/**
+ * @brief Per-line counters kept by FeedArbiter
+ */
+struct ArbiterStats
+{
+    uint64_t packets[2] = {0, 0};   ///< Packets offered per line
+    uint64_t wins[2]    = {0, 0};   ///< Packets that delivered new messages first
+    uint64_t late[2]    = {0, 0};   ///< Packets already covered by the other line
+};
+
+/**
+ * @brief A/B line arbitration for redundant MoldUDP64 feeds
+ *
+ * @details Both lines carry the same session and sequence numbers, so
+ * arbitration is sequencing: packets from either line go through one
+ * MoldSequencer keyed on session + sequence, the first copy of every
+ * message is released and the other line's copy is a duplicate. A packet
+ * missing on one line is filled by the other without any request.
+ * The fast path (in-order packet from the leading line) releases the
+ * packet in place, so arbitration adds no copy and no wait.
+ */
+class FeedArbiter
+{
+public:
+    static constexpr int LINE_A = 0;
+    static constexpr int LINE_B = 1;
+
+    explicit FeedArbiter(uint64_t first_seq = 0, size_t max_buffered = 4096)
+    : seq_(first_seq, max_buffered) {}
+
+    /**
+     * @brief Offers a packet received on one line
+     * @param line LINE_A or LINE_B
+     * @return New messages contributed (0 if the other line was first)
+     *
+     * @details Released packets are available via ready() until the next offer().
+     */
+    size_t offer(int line, const char* data, size_t len);
+
+    const std::vector<MoldSequencer::View>& ready() const { return seq_.ready(); }
+    MoldSequencer& sequencer() { return seq_; }
+    const MoldSequencer& sequencer() const { return seq_; }
+    const ArbiterStats& stats() const { return stats_; }
+
+private:
+    MoldSequencer seq_;     ///< Shared sequence state of both lines
+    ArbiterStats  stats_;
+};
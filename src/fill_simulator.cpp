@@ -0,0 +1,133 @@
+#include "fill_simulator.h"
+
+#include <algorithm>
+
+/**
+ * @details Implementation notes:
+ * - Priority is the level's last order at placement; with an empty level
+ *   nothing is ahead and every later order queues behind
+ */
+uint32_t QueueFillSimulator::place(uint32_t owner, Side side, Price price, Quantity quantity, Timestamp ts)
+{
+    const uint32_t id = static_cast<uint32_t>(orders_.size());
+    VirtualOrder v{ owner, side, price, quantity, 0, 0, 0 };
+    orders_.push_back(v);
+    if (quantity == 0 || (side != Side::Buy && side != Side::Sell)) {
+        orders_[id].remaining = 0;
+        return id;
+    }
+
+    // marketable: crosses the opposite best price
+    const bool crosses = side == Side::Buy
+        ? (book_.best_ask_price() != 0 && price >= book_.best_ask_price())
+        : (book_.best_bid_price() != 0 && price <= book_.best_bid_price());
+    if (crosses) {
+        fill(id, quantity, ts);
+        return id;
+    }
+
+    if (const PriceLevel* level = book_.find_level(side, price)) {
+        orders_[id].ahead           = level->aggregate;
+        orders_[id].ranking_time    = level->fifo.back().ranking_time;
+        orders_[id].ranking_seq_num = level->fifo.back().ranking_seq_num;
+    }
+    if (side == Side::Buy) bids_[price].push_back(id);
+    else                   asks_[price].push_back(id);
+    ++resting_;
+    return id;
+}
+
+bool QueueFillSimulator::cancel(uint32_t order)
+{
+    if (order >= orders_.size() || orders_[order].remaining == 0) return false;
+    VirtualOrder& v = orders_[order];
+    v.remaining = 0;
+    if (v.side == Side::Buy) compact(bids_, bids_.find(v.price));
+    else                     compact(asks_, asks_.find(v.price));
+    return true;
+}
+
+void QueueFillSimulator::apply(const std::vector<QueueChange>& changes)
+{
+    if (resting_ == 0) return;
+    for (const QueueChange& c : changes) {
+        if (c.side == Side::Buy) apply_side(bids_, c, std::greater<Price>());
+        else                     apply_side(asks_, c, std::less<Price>());
+    }
+}
+
+/**
+ * @details Implementation notes:
+ * - Levels are ordered best first, so a sweep only walks the levels better
+ *   than the execution price and stops
+ * - Orders ahead are the ones at or before the cutoff priority; the
+ *   ahead > 0 test keeps later orders with an equal ranking from counting
+ */
+template <typename Levels, typename Better>
+void QueueFillSimulator::apply_side(Levels& levels, const QueueChange& c, Better better)
+{
+    const bool traded = c.cause == MessageType::ExecuteOrder || c.cause == MessageType::ExecuteWithPrice;
+
+    // swept: an execution behind a better virtual price took the whole level
+    if (traded) {
+        for (auto level = levels.begin(); level != levels.end() && better(level->first, c.price); ) {
+            for (uint32_t id : level->second) fill(id, orders_[id].remaining, c.timestamp);
+            resting_ -= level->second.size();
+            level = levels.erase(level);
+        }
+    }
+
+    auto level = levels.find(c.price);
+    if (level == levels.end()) return;
+
+    for (uint32_t id : level->second) {
+        VirtualOrder& v = orders_[id];
+        const bool ahead = v.ahead > 0 &&
+            (c.ranking_time < v.ranking_time ||
+             (c.ranking_time == v.ranking_time && c.ranking_seq_num <= v.ranking_seq_num));
+        if (ahead) {
+            v.ahead -= std::min(v.ahead, c.quantity);
+        } else if (traded) {
+            fill(id, std::min(v.remaining, c.quantity), c.timestamp);
+        }
+    }
+    compact(levels, level);
+}
+
+template <typename Levels>
+void QueueFillSimulator::compact(Levels& levels, typename Levels::iterator level)
+{
+    if (level == levels.end()) return;
+    Resting& ids = level->second;
+    const size_t before = ids.size();
+    ids.erase(std::remove_if(ids.begin(), ids.end(),
+                             [this](uint32_t id) { return orders_[id].remaining == 0; }),
+              ids.end());
+    resting_ -= before - ids.size();
+    if (ids.empty()) levels.erase(level);
+}
+
+void QueueFillSimulator::fill(uint32_t id, Quantity quantity, Timestamp ts)
+{
+    if (quantity == 0) return;
+    VirtualOrder& v = orders_[id];
+    v.remaining -= quantity;
+
+    VirtualFill f;
+    f.timestamp = ts;
+    f.owner     = v.owner;
+    f.order     = id;
+    f.price     = v.price;
+    f.quantity  = quantity;
+    f.side      = v.side;
+    fills_.push_back(f);
+}
+
+void QueueFillSimulator::reset()
+{
+    orders_.clear();
+    bids_.clear();
+    asks_.clear();
+    fills_.clear();
+    resting_ = 0;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "orderbook.h"
+#include "types/queue_change.h"
+
+/**
+ * @brief A (partial) fill of a virtual order
+ */
+struct VirtualFill
+{
+    Timestamp timestamp = 0;         ///< Time of the book event that filled it
+    uint32_t  owner = 0;             ///< Strategy that placed the order
+    uint32_t  order = 0;             ///< Virtual order id returned by place()
+    Price     price = 0;             ///< Limit price (passive fills trade at the limit)
+    Quantity  quantity = 0;          ///< Filled quantity
+    Side      side = Side::Unknown;
+};
+
+/**
+ * @brief Queue-position-aware fills for virtual (simulated) limit orders
+ *
+ * @details A virtual order joins the back of its price level: everything
+ * resting there when it is placed stands ahead of it, and its priority is
+ * that of the level's last order. It is filled only once the real book's
+ * executions have consumed the queue ahead:
+ * - execution of an order ahead: the queue ahead shrinks
+ * - execution of an order behind: the virtual order would have traded
+ *   first, so it fills by that quantity
+ * - execution at a worse price on the same side: the level was swept, the
+ *   virtual order fills completely
+ * - deletion / replace of an order ahead: the queue ahead shrinks
+ * A virtual order that crosses the opposite best price fills immediately
+ * at its limit.
+ *
+ * The real book is only read (QueueChange records from its queue sink plus
+ * find_level() at placement); it is never mutated. Virtual orders of
+ * different owners never interact, so one simulator serves many strategies
+ * (a parameter sweep) over one replay. A queue change costs one map lookup
+ * plus the virtual orders resting at that price.
+ */
+class QueueFillSimulator
+{
+public:
+    explicit QueueFillSimulator(const Orderbook& book) : book_(book) {}
+
+    /**
+     * @brief Places a virtual limit order
+     * @param owner Strategy id reported in the order's fills
+     * @param side Buy or Sell
+     * @param price Limit price
+     * @param quantity Order quantity
+     * @param ts Placement time (marketable orders fill at this time)
+     * @return Virtual order id
+     */
+    uint32_t place(uint32_t owner, Side side, Price price, Quantity quantity, Timestamp ts);
+
+    /**
+     * @brief Cancels the unfilled rest of a virtual order
+     * @return false if the order is unknown or already done
+     */
+    bool cancel(uint32_t order);
+
+    /**
+     * @brief Advances virtual queues by the book's queue changes
+     * @param changes Records from Orderbook::set_queue_sink, in book order
+     */
+    void apply(const std::vector<QueueChange>& changes);
+
+    /**
+     * @brief Fills produced since the last clear_fills()
+     */
+    const std::vector<VirtualFill>& fills() const { return fills_; }
+    void clear_fills() { fills_.clear(); }
+
+    /**
+     * @brief Quantity still ahead of a virtual order in its level
+     */
+    Quantity queue_ahead(uint32_t order) const { return order < orders_.size() ? orders_[order].ahead : 0; }
+
+    /**
+     * @brief Unfilled quantity of a virtual order (0 once filled or cancelled)
+     */
+    Quantity remaining(uint32_t order) const { return order < orders_.size() ? orders_[order].remaining : 0; }
+
+    /**
+     * @brief Virtual orders still resting
+     */
+    size_t resting() const { return resting_; }
+
+    /**
+     * @brief Drops every virtual order and fill (next day)
+     */
+    void reset();
+
+private:
+    struct VirtualOrder
+    {
+        uint32_t      owner;
+        Side          side;
+        Price         price;
+        Quantity      remaining;
+        Quantity      ahead;             ///< Real quantity queued in front
+        RankingTime   ranking_time;      ///< Priority cutoff: orders at or before it are ahead
+        RankingSeqNum ranking_seq_num;
+    };
+
+    using Resting = std::vector<uint32_t>;   ///< Virtual order ids at one price
+
+    const Orderbook& book_;
+    std::vector<VirtualOrder> orders_;       ///< Indexed by virtual order id
+    std::map<Price, Resting, std::greater<Price>> bids_;
+    std::map<Price, Resting, std::less<Price>>    asks_;
+    std::vector<VirtualFill> fills_;
+    size_t resting_ = 0;
+
+    void fill(uint32_t id, Quantity quantity, Timestamp ts);
+
+    template <typename Levels, typename Better>
+    void apply_side(Levels& levels, const QueueChange& change, Better better);
+
+    /// Removes done orders from a level, erasing it when empty
+    template <typename Levels>
+    void compact(Levels& levels, typename Levels::iterator level);
+};
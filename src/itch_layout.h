@@ -0,0 +1,277 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "types/event.h"
+#include "util/endian.h"
+#include "util/parse_utils.h"
+
+/**
+ * @brief Compile-time ITCH message layouts
+ *
+ * @details A message is a list of field descriptors, each naming its wire
+ * width and the Event member it maps to. Everything else is generated:
+ * - decode(): reads each field at a constant offset; the recursion is
+ *   inlined, so decoding is fully unrolled straight-line code
+ * - encode(): writes the same bytes (synthetic tapes, tests)
+ * - size: body length after the type byte, used as the bounds check and
+ *   static_asserted against the specification below
+ *
+ * Adding a message type is one Message<> alias here and one line in the
+ * parser's dispatch table; no offsets are written by hand.
+ */
+namespace itch
+{
+    namespace detail
+    {
+        template <size_t W> struct BigEndian;
+
+        template <> struct BigEndian<1> {
+            static uint8_t read(const char* p) { return static_cast<uint8_t>(p[0]); }
+            static void write(char* p, uint64_t v) { p[0] = static_cast<char>(v); }
+        };
+        template <> struct BigEndian<2> {
+            static uint16_t read(const char* p) { return endian::read_u16_be(p); }
+            static void write(char* p, uint64_t v) { endian::write_u16_be(p, static_cast<uint16_t>(v)); }
+        };
+        template <> struct BigEndian<4> {
+            static uint32_t read(const char* p) { return endian::read_u32_be(p); }
+            static void write(char* p, uint64_t v) { endian::write_u32_be(p, static_cast<uint32_t>(v)); }
+        };
+        template <> struct BigEndian<8> {
+            static uint64_t read(const char* p) { return endian::read_u64_be(p); }
+            static void write(char* p, uint64_t v) { endian::write_u64_be(p, v); }
+        };
+    }
+
+    /**
+     * @brief Unsigned big-endian integer of W bytes stored in Event::*M
+     */
+    template <size_t W, typename T, T Event::*M>
+    struct Uint {
+        static constexpr size_t size = W;
+        static void decode(const char* p, Event& e) { e.*M = static_cast<T>(detail::BigEndian<W>::read(p)); }
+        static void encode(char* p, const Event& e) { detail::BigEndian<W>::write(p, static_cast<uint64_t>(e.*M)); }
+    };
+
+    /**
+     * @brief Side byte ('B' / 'S')
+     */
+    template <Side Event::*M>
+    struct SideCode {
+        static constexpr size_t size = 1;
+        static void decode(const char* p, Event& e) { e.*M = ParseSide(*p); }
+        static void encode(char* p, const Event& e) {
+            *p = e.*M == Side::Buy ? 'B' : (e.*M == Side::Sell ? 'S' : ' ');
+        }
+    };
+
+    /**
+     * @brief Yes/no flag byte ('Y' / 'N')
+     */
+    template <bool Event::*M>
+    struct YesNo {
+        static constexpr size_t size = 1;
+        static void decode(const char* p, Event& e) { e.*M = *p == 'Y'; }
+        static void encode(char* p, const Event& e) { *p = e.*M ? 'Y' : 'N'; }
+    };
+
+    /**
+     * @brief Single character code
+     */
+    template <char Event::*M>
+    struct Char {
+        static constexpr size_t size = 1;
+        static void decode(const char* p, Event& e) { e.*M = *p; }
+        static void encode(char* p, const Event& e) { *p = e.*M; }
+    };
+
+    /**
+     * @brief Space-padded alphanumeric field (padding stripped on decode)
+     */
+    template <size_t N, std::string Event::*M>
+    struct Alpha {
+        static constexpr size_t size = N;
+        static void decode(const char* p, Event& e) {
+            size_t n = N;
+            while (n > 0 && p[n-1] == ' ') --n;
+            (e.*M).assign(p, n);
+        }
+        static void encode(char* p, const Event& e) {
+            const std::string& s = e.*M;
+            std::memset(p, ' ', N);
+            std::memcpy(p, s.data(), s.size() < N ? s.size() : N);
+        }
+    };
+
+    /**
+     * @brief Bytes the decoder ignores (reserved or unused fields), encoded as zeros
+     */
+    template <size_t N>
+    struct Skip {
+        static constexpr size_t size = N;
+        static void decode(const char*, Event&) {}
+        static void encode(char* p, const Event&) { std::memset(p, 0, N); }
+    };
+
+    /**
+     * @brief 'T' message second, kept in Event::timestamp as nanoseconds
+     */
+    struct SecondField {
+        static constexpr size_t size = 4;
+        static constexpr Timestamp NS_PER_SECOND = 1000000000ull;
+        static void decode(const char* p, Event& e) {
+            e.timestamp = static_cast<Timestamp>(endian::read_u32_be(p)) * NS_PER_SECOND;
+        }
+        static void encode(char* p, const Event& e) {
+            endian::write_u32_be(p, static_cast<uint32_t>(e.timestamp / NS_PER_SECOND));
+        }
+    };
+
+    /**
+     * @brief Fields laid out back to back; offsets are computed at compile time
+     */
+    template <typename... Fields> struct Layout;
+
+    template <>
+    struct Layout<> {
+        static constexpr size_t size = 0;
+        static void decode(const char*, Event&) {}
+        static void encode(char*, const Event&) {}
+    };
+
+    template <typename F, typename... Rest>
+    struct Layout<F, Rest...> {
+        static constexpr size_t size = F::size + Layout<Rest...>::size;
+        static void decode(const char* p, Event& e) {
+            F::decode(p, e);
+            Layout<Rest...>::decode(p + F::size, e);
+        }
+        static void encode(char* p, const Event& e) {
+            F::encode(p, e);
+            Layout<Rest...>::encode(p + F::size, e);
+        }
+    };
+
+    /**
+     * @brief A message type byte plus its body layout
+     */
+    template <MessageType Type, typename... Fields>
+    struct Message : Layout<Fields...> {
+        using Body = Layout<Fields...>;
+        static constexpr MessageType type = Type;
+    };
+
+    /**
+     * @brief Byte offset of field G in a body layout, -1 if the layout has none
+     */
+    template <typename L, typename G> struct OffsetOf;
+
+    template <typename G>
+    struct OffsetOf<Layout<>, G> {
+        static constexpr int value = -1;
+    };
+
+    template <typename F, typename... Rest, typename G>
+    struct OffsetOf<Layout<F, Rest...>, G> {
+        static constexpr int rest = OffsetOf<Layout<Rest...>, G>::value;
+        static constexpr int value = std::is_same<F, G>::value ? 0
+                                   : (rest < 0 ? -1 : static_cast<int>(F::size) + rest);
+    };
+
+// Integer field of W bytes mapped to Event::member
+#define ITCH_UINT(W, member) ::itch::Uint<W, decltype(Event::member), &Event::member>
+
+    using Ns   = ITCH_UINT(4, nanosec);
+    using Book = ITCH_UINT(4, orderbook_id);
+    using Id   = ITCH_UINT(8, order_id);
+    using Qty  = ITCH_UINT(8, quantity);
+    using Px   = ITCH_UINT(4, price);
+    using OrderSide = SideCode<&Event::side>;
+
+    /**
+     * @brief Body offset of a message's orderbook_id (-1 for market-wide
+     * messages), so a subscription filter can peek at it without decoding
+     */
+    template <typename M>
+    struct BookOffset {
+        static constexpr int value = OffsetOf<typename M::Body, Book>::value;
+    };
+
+    // ----- time and reference data -----
+    using Seconds = Message<MessageType::Seconds, SecondField>;
+
+    using OrderbookDirectory = Message<MessageType::OrderbookDirectory,
+        Ns, Book, Alpha<32, &Event::symbol>,
+        Skip<32 + 12 + 1 + 3>,          // long name, ISIN, financial product, currency
+        ITCH_UINT(2, price_decimals),
+        Skip<2 + 4>,                    // nominal decimals, odd lot size
+        ITCH_UINT(4, round_lot),
+        Skip<4 + 8 + 1 + 4 + 4 + 4 + 2 + 1 + 1>>;   // block lot .. ranking type
+
+    using CombinationLeg = Message<MessageType::CombinationLeg,
+        Ns, Book, ITCH_UINT(4, leg_orderbook_id), OrderSide, ITCH_UINT(4, leg_ratio)>;
+
+    using TickSize = Message<MessageType::TickSize,
+        Ns, Book, ITCH_UINT(8, tick_size), Px, ITCH_UINT(4, price_to)>;
+
+    using SystemEvent = Message<MessageType::SystemEvent, Ns, Char<&Event::event_code>>;
+
+    using OrderbookState = Message<MessageType::OrderbookState,
+        Ns, Book, Alpha<20, &Event::orderbook_state>>;
+
+    // ----- order book updates -----
+    using AddOrder = Message<MessageType::AddOrder,
+        Ns, Id, Book, OrderSide, ITCH_UINT(4, ranking_seq_num), Qty, Px,
+        Skip<2 + 1>,                    // order attributes, lot type
+        ITCH_UINT(8, ranking_time)>;
+
+    using ExecuteOrder = Message<MessageType::ExecuteOrder,
+        Ns, Id, Book, OrderSide, Qty, ITCH_UINT(8, match_id),
+        Skip<4 + 7 + 7>>;               // combo group id, reserved
+
+    using ExecuteWithPrice = Message<MessageType::ExecuteWithPrice,
+        Ns, Id, Book, OrderSide, Qty, ITCH_UINT(8, match_id),
+        Skip<4 + 7 + 7>, Px, YesNo<&Event::at_cross>, YesNo<&Event::printable>>;
+
+    using ReplaceOrder = Message<MessageType::ReplaceOrder,
+        Ns, Id, Book, OrderSide, ITCH_UINT(4, ranking_seq_num), Qty, Px,
+        Skip<2>>;                       // order attributes
+
+    using DeleteOrder = Message<MessageType::DeleteOrder, Ns, Id, Book, OrderSide>;
+
+    // ----- trades and auctions -----
+    using Trade = Message<MessageType::Trade,
+        Ns, ITCH_UINT(8, match_id), Skip<4>, OrderSide, Qty, Book, Px,
+        Skip<7 + 7>, YesNo<&Event::printable>, YesNo<&Event::at_cross>>;
+
+    using EquilibriumPrice = Message<MessageType::EquilibriumPrice,
+        Ns, Book, Qty, ITCH_UINT(8, ask_quantity), Px,
+        ITCH_UINT(4, best_bid), ITCH_UINT(4, best_ask),
+        Skip<8 + 8>>;                   // best bid/ask quantities
+
+#undef ITCH_UINT
+
+    // Body sizes from the BISTECH ITCH specification
+    static_assert(Seconds::size            == 4,   "Seconds layout");
+    static_assert(OrderbookDirectory::size == 129, "OrderbookDirectory layout");
+    static_assert(CombinationLeg::size     == 17,  "CombinationLeg layout");
+    static_assert(TickSize::size           == 24,  "TickSize layout");
+    static_assert(SystemEvent::size        == 5,   "SystemEvent layout");
+    static_assert(OrderbookState::size     == 28,  "OrderbookState layout");
+    static_assert(AddOrder::size           == 44,  "AddOrder layout");
+    static_assert(ExecuteOrder::size       == 51,  "ExecuteOrder layout");
+    static_assert(ExecuteWithPrice::size   == 57,  "ExecuteWithPrice layout");
+    static_assert(ReplaceOrder::size       == 35,  "ReplaceOrder layout");
+    static_assert(DeleteOrder::size        == 17,  "DeleteOrder layout");
+    static_assert(Trade::size              == 49,  "Trade layout");
+    static_assert(EquilibriumPrice::size   == 52,  "EquilibriumPrice layout");
+
+    static_assert(BookOffset<AddOrder>::value    == 12, "AddOrder orderbook_id");
+    static_assert(BookOffset<DeleteOrder>::value == 12, "DeleteOrder orderbook_id");
+    static_assert(BookOffset<Trade>::value       == 25, "Trade orderbook_id");
+    static_assert(BookOffset<Seconds>::value     == -1, "Seconds is market-wide");
+}
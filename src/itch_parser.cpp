@@ -1,206 +1,397 @@
 #include "itch_parser.h"
+#include "itch_layout.h"
+#include "moldudp64.h"
+#include "orderbook_filter.h"
 #include "util/endian.h"
-#include "util/parse_utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
 namespace {
-    constexpr size_t MOLDUDP64_HEADER_SIZE = 20;
     constexpr size_t MAX_MESSAGE_COUNT = 10000;
     constexpr size_t MAX_MESSAGE_LENGTH = 65535;
+    constexpr size_t TIMESTAMP_OFFSET = 1;     // after the type byte
+    constexpr Timestamp NS_PER_SECOND = 1000000000ull;
+    constexpr size_t MAX_UNKNOWN_LOGS = 5;            // per parser
+    constexpr size_t RESYNC_BLOCK = 64 * 1024;        // bytes read per scan step
+    constexpr uint64_t RESYNC_SEQ_WINDOW = 1u << 20;  // largest sequence gap accepted
+
+    /**
+     * @brief Decodes one message body (after the type byte) into event
+     * @return false if the body is shorter than the message layout
+     */
+    using Decoder = bool (*)(const char* body, size_t len, Event& event);
+
+    template <typename Message>
+    bool decode(const char* body, size_t len, Event& event) {
+        if (__builtin_expect(len < Message::size, 0)) return false;
+        Message::decode(body, event);
+        return true;
+    }
+
+    /**
+     * @brief Decoder and orderbook_id offset per type byte
+     * (nullptr = unknown type, offset -1 = no orderbook_id)
+     */
+    struct DispatchTable {
+        Decoder by_type[256];
+        int16_t book_at[256];
+
+        DispatchTable() : by_type() {
+            std::fill(book_at, book_at + 256, int16_t(-1));
+            add<itch::Seconds>();
+            add<itch::OrderbookDirectory>();
+            add<itch::CombinationLeg>();
+            add<itch::TickSize>();
+            add<itch::SystemEvent>();
+            add<itch::OrderbookState>();
+            add<itch::AddOrder>();
+            add<itch::ExecuteOrder>();
+            add<itch::ExecuteWithPrice>();
+            add<itch::ReplaceOrder>();
+            add<itch::DeleteOrder>();
+            add<itch::Trade>();
+            add<itch::EquilibriumPrice>();
+        }
+
+        template <typename Message>
+        void add() {
+            by_type[static_cast<uint8_t>(Message::type)] = &decode<Message>;
+            book_at[static_cast<uint8_t>(Message::type)] = itch::BookOffset<Message>::value;
+        }
+    };
+
+    const DispatchTable DISPATCH;
+
+    /**
+     * @brief Peeks at a message's orderbook_id without decoding it
+     * @return false only for a message of an unsubscribed book; market-wide,
+     *         unknown and short messages are left to the decoder
+     */
+    inline bool subscribed(const char* msg, size_t len, const OrderbookFilter& filter) {
+        const int at = DISPATCH.book_at[static_cast<uint8_t>(msg[0])];
+        if (at < 0 || len < 1 + static_cast<size_t>(at) + sizeof(OrderbookId)) return true;
+        return filter.contains(endian::read_u32_be(msg + 1 + at));
+    }
 }
 
-ItchParser::ItchParser(std::istream& in) : in_(in) {
+ItchParser::ItchParser(std::istream& in) : in_(&in) {
     buffer_.reserve(MAX_MESSAGE_LENGTH);  // pre-allocate buffer once
 }
 
+ItchParser::ItchParser() : in_(nullptr) {}
+
 std::vector<Event> ItchParser::next_packet() {
     std::vector<Event> events;
+    if (!next_raw_packet(buffer_)) return events;  // EOF/corrupt header -> no messages
+
+    parse_packet(buffer_.data(), buffer_.size(), events);
+    return events;
+}
+
+/**
+ * @details Implementation notes:
+ * - Copies header and messages into out unchanged, so the result can be
+ *   decoded by parse_packet() or re-sent as a datagram
+ * - A truncated message is dropped and the header count patched, so out
+ *   is always a well-formed packet
+ * - The resync mode tracks the stream offset itself; tellg() costs a
+ *   system call per packet on file streams
+ */
+bool ItchParser::next_raw_packet(std::vector<char>& out) {
+    out.clear();
+    if (!in_) return false;
+
+    Frame frame = frame_packet(out);
+    if (!resync_) return frame == Frame::Ok || frame == Frame::Truncated;
+
+    if (frame == Frame::Corrupt) frame = resync(pos_, out);
+    switch (frame) {
+        case Frame::Ok:
+        case Frame::Truncated: {
+            mold::PacketHeader h{};
+            mold::read_header(out.data(), out.size(), h);
+            if (!have_session_) {
+                std::memcpy(session_, h.session, mold::SESSION_SIZE);
+                have_session_ = true;
+            }
+            next_seq_ = h.next_seq();
+            pos_ += static_cast<std::streamoff>(out.size());
+            return true;
+        }
+        case Frame::Control:
+            pos_ += static_cast<std::streamoff>(mold::HEADER_SIZE);
+            out.clear();
+            return false;
+        default:
+            out.clear();
+            return false;
+    }
+}
 
+void ItchParser::set_resync(bool on) {
+    resync_ = on && in_ != nullptr;
+    if (resync_) {
+        pos_ = in_->tellg();
+        if (pos_ < 0) {
+            std::cerr << "[ITCH] Resync needs a seekable stream\n";
+            resync_ = false;
+        }
+    }
+}
+
+ItchParser::Frame ItchParser::frame_packet(std::vector<char>& out) {
     // read MoldUDP64 header
-    char header[MOLDUDP64_HEADER_SIZE];
-    in_.read(header, sizeof(header));
-    if (!in_) return events; // EOF/short read -> no messages
+    out.resize(mold::HEADER_SIZE);
+    in_->read(&out[0], mold::HEADER_SIZE);
+    if (!*in_) { out.clear(); return Frame::Eof; } // EOF/short read
 
-    const std::string session(header, 10);
-    const uint64_t seq_num = endian::read_u64_be(header + 10);
-    (void)seq_num; 
-    const uint16_t count   = endian::read_u16_be(header + 18);
+    const uint16_t count = endian::read_u16_be(&out[mold::SESSION_SIZE + 8]);
+
+    if (resync_) {
+        if (!plausible_header(out.data())) return Frame::Corrupt;
+        if (count == mold::HEARTBEAT || count == mold::END_OF_SESSION) return Frame::Control;
+    }
 
     // sanity check count (protect against corruption)
     if (count == 0 || count > MAX_MESSAGE_COUNT) {
         std::cerr << "[ITCH] Invalid message count: " << count << "\n";
-        return events;
+        out.clear();
+        return Frame::Corrupt;
     }
 
-    events.reserve(count);
-
     // read each length-prefixed message
-    for (uint16_t i = 0; i < count; ++i) {
-        char lenbuf[2];
-        in_.read(lenbuf, 2);
-        if (!in_) {
+    uint16_t complete = 0;
+    for (; complete < count; ++complete) {
+        const size_t at = out.size();
+        out.resize(at + mold::LENGTH_SIZE);
+        in_->read(&out[at], mold::LENGTH_SIZE);
+        if (!*in_) {
             std::cerr << "[ITCH] Short read on length\n";
+            out.resize(at);
             break;
         }
 
-        const uint16_t msg_len = endian::read_u16_be(lenbuf);
+        const uint16_t msg_len = endian::read_u16_be(&out[at]);
 
         // at least 1 byte for type, max 65535 bytes for payload
         if (msg_len < 1 || msg_len > MAX_MESSAGE_LENGTH) {
+            if (resync_) return Frame::Corrupt;
             std::cerr << "[ITCH] Invalid message length: " << msg_len << "\n";
+            out.resize(at);
             break;
         }
-		
-		// copy message to buffer
-        buffer_.resize(msg_len);
-        in_.read(&buffer_[0], msg_len);
-        if (!in_) {
+
+        out.resize(at + mold::LENGTH_SIZE + msg_len);
+        in_->read(&out[at + mold::LENGTH_SIZE], msg_len);
+        if (!*in_) {
             std::cerr << "[ITCH] Short read on payload\n";
+            out.resize(at);
             break;
         }
 
-        // safety check: ensure buffer has data
-        if (buffer_.empty() || msg_len == 0) {
-            std::cerr << "[ITCH] Empty buffer or message\n";
-            continue;
-        }
-        
-        Event ev = parse_message(&buffer_[0], msg_len);
-        if (ev.type != MessageType::Other) {
-            events.push_back(ev);
-        } else {
-            static int unknown_dbg = 0;
-            if (unknown_dbg < 5) {
-                std::cerr << "[ITCH] Unknown message type: 0x"
-                          << std::hex << (unsigned)(unsigned char)buffer_[0]
-                          << std::dec << "\n";
-                ++unknown_dbg;
-            }
-        }
+        // every ITCH type code is an upper-case letter
+        const char type = out[at + mold::LENGTH_SIZE];
+        if (resync_ && (type < 'A' || type > 'Z')) return Frame::Corrupt;
     }
 
-    return events;
+    if (complete != count) {
+        endian::write_u16_be(&out[mold::SESSION_SIZE + 8], complete);
+        return Frame::Truncated;
+    }
+    return Frame::Ok;
 }
 
-Event ItchParser::parse_message(const char* msg, size_t len)
-{
-    /**
-     * @brief Helper struct for safe message parsing with bounds checking
-     * 
-     * Provides a safe interface for reading from message buffers with
-     * automatic bounds checking and position tracking.
-     */
-    struct Cur {
-        const char* p;      // Current position in message buffer
-        const char* end;    // End of message buffer
-        bool ok(size_t n) const { 
-            return __builtin_expect(size_t(end - p) >= n, 1);  
-        }
-        const char* take(size_t n) { const char* r = p; p += n; return r; }
-        size_t remaining() const { return size_t(end - p); }
-    };
-    
-    // Helper lambda functions for big-endian reading
-    auto BE32 = [](const char* p){ return endian::read_u32_be(p); };
-    auto BE64 = [](const char* p){ return endian::read_u64_be(p); };
-
-    Event event{};       
-    if (len < 1) return event;
+bool ItchParser::plausible_header(const char* p) const {
+    mold::PacketHeader h{};
+    mold::read_header(p, mold::HEADER_SIZE, h);
 
-    const MessageType type = ParseMessageType(msg[0]);
-    event.type = type;
+    const bool control = h.heartbeat() || h.end_of_session();
+    if (!control && h.count > MAX_MESSAGE_COUNT) return false;
 
-    Cur cur{ msg + 1, msg + len }; 
-
-    switch (type) {
-    case MessageType::OrderbookState: {
-        // ns(4) + book(4) + state(20 space-padded) = 28
-        if (__builtin_expect(!cur.ok(4 + 4 + 20), 0)) { 
-            event.type = MessageType::Other; 
-            return event; 
-        }
-        event.nanosec      = BE32(cur.take(4));
-        event.orderbook_id = BE32(cur.take(4));
-        
-        const char* state_start = cur.take(20);
-        size_t state_len = 20;
-        while (state_len > 0 && state_start[state_len-1] == ' ') --state_len;
-        event.orderbook_state.assign(state_start, state_len);
-        
-        break;
+    if (have_session_) {
+        return mold::same_session(h.session, session_) &&
+               h.seq >= next_seq_ && h.seq - next_seq_ <= RESYNC_SEQ_WINDOW;
     }
-
-    case MessageType::AddOrder: {
-        // ns(4) + id(8) + book(4) + side(1) + ranking_seq_num(4) + qty(8) + price(4) + attrs(2) + lot_type(1) + ranking_time(8) = 51
-        if (__builtin_expect(!cur.ok(4 + 8 + 4 + 1 + 4 + 8 + 4 + 2 + 1 + 8), 0)) { 
-            event.type = MessageType::Other; 
-            return event; 
-        }
-        event.nanosec          = BE32(cur.take(4));
-        event.order_id         = BE64(cur.take(8));
-        event.orderbook_id     = BE32(cur.take(4));
-        event.side             = ParseSide(*cur.take(1));
-        event.ranking_seq_num  = BE32(cur.take(4));
-        event.quantity         = BE64(cur.take(8));
-        event.price            = BE32(cur.take(4));
-        (void)cur.take(2); // skip Order Attributes
-        (void)cur.take(1); // skip Lot Type
-        event.ranking_time     = BE64(cur.take(8));
-        break;
+    // first packet: sessions are space-padded printable text
+    for (size_t i = 0; i < mold::SESSION_SIZE; ++i) {
+        if (h.session[i] < 0x20 || h.session[i] > 0x7E) return false;
     }
+    return true;
+}
 
-    case MessageType::ExecuteOrder: {
-        // ns(4) + id(8) + book(4) + side(1) + qty(8) + match(8) + combo(4) + res(7) + res(7) = 51
-        if (__builtin_expect(!cur.ok(4 + 8 + 4 + 1 + 8), 0)) { 
-            event.type = MessageType::Other; 
-            return event; 
+/**
+ * @details Implementation notes:
+ * - Reads the stream in RESYNC_BLOCK chunks and checks the header at every
+ *   byte offset; candidates are confirmed by framing a full packet, so a
+ *   header-like byte pattern inside a message is not accepted
+ * - Without a confirmed packet before EOF, the rest of the stream counts
+ *   as skipped and the stream is left at EOF
+ */
+ItchParser::Frame ItchParser::resync(std::streamoff from, std::vector<char>& out) {
+    ++resync_stats_.resyncs;
+    scan_.resize(RESYNC_BLOCK);
+
+    std::streamoff block = from + 1;
+    for (;;) {
+        in_->clear();
+        in_->seekg(block);
+        in_->read(scan_.data(), static_cast<std::streamsize>(scan_.size()));
+        const size_t got = static_cast<size_t>(in_->gcount());
+        if (got < mold::HEADER_SIZE) break;
+
+        for (size_t i = 0; i + mold::HEADER_SIZE <= got; ++i) {
+            if (!plausible_header(&scan_[i])) continue;
+
+            const std::streamoff at = block + static_cast<std::streamoff>(i);
+            in_->clear();
+            in_->seekg(at);
+            out.clear();
+            const Frame frame = frame_packet(out);
+            if (frame == Frame::Corrupt || frame == Frame::Eof) continue;
+
+            mold::PacketHeader h{};
+            mold::read_header(&scan_[i], mold::HEADER_SIZE, h);
+            if (have_session_) resync_stats_.lost_messages += h.seq - next_seq_;
+            resync_stats_.skipped_bytes += static_cast<uint64_t>(at - from);
+            std::cerr << "[ITCH] Resync: skipped " << (at - from) << " bytes\n";
+            pos_ = at;
+            return frame;
         }
 
-        event.nanosec      = BE32(cur.take(4));
-        event.order_id     = BE64(cur.take(8));
-        event.orderbook_id = BE32(cur.take(4));
-        event.side         = ParseSide(*cur.take(1));
-        event.quantity     = BE64(cur.take(8));   // Executed Quantity
-
-        // Consume remaining fields if present
-        if (cur.remaining() >= 8)  (void)BE64(cur.take(8));  // Match ID
-        if (cur.remaining() >= 4)  (void)BE32(cur.take(4));  // Combo Group ID
-        if (cur.remaining() >= 7)  (void)cur.take(7);        // Reserved
-        if (cur.remaining() >= 7)  (void)cur.take(7);        // Reserved
-
-        break;
-    }
-
-    case MessageType::DeleteOrder: {
-        // ns(4) + order_id(8) + book(4) + side(1) = 13
-        if (__builtin_expect(!cur.ok(4 + 8 + 4 + 1), 0)) { 
-            event.type = MessageType::Other; 
-            return event; 
+        if (got < scan_.size()) {
+            block += static_cast<std::streamoff>(got);
+            break;
         }
-        event.nanosec      = BE32(cur.take(4));
-        event.order_id     = BE64(cur.take(8));
-        event.orderbook_id = BE32(cur.take(4));
-        event.side         = ParseSide(*cur.take(1));
-        break;
+        block += static_cast<std::streamoff>(got - mold::HEADER_SIZE + 1);
     }
 
-    default:
-        event.type = MessageType::Other;
-        break;
-    }
-
-    return event;
+    // no clean packet up to EOF
+    resync_stats_.skipped_bytes += static_cast<uint64_t>(block - from);
+    std::cerr << "[ITCH] Resync: no header before EOF, skipped " << (block - from) << " bytes\n";
+    out.clear();
+    in_->clear();
+    in_->seekg(0, std::ios::end);
+    in_->setstate(std::ios::eofbit);
+    return Frame::Eof;
 }
 
+/**
+ * @details Implementation notes:
+ * - Messages are decoded in place from data; nothing is copied
+ * - Bounds are checked against len, since datagrams can be truncated
+ * - With a filter set, messages of other books are skipped after reading
+ *   4 bytes at their layout's orderbook_id offset; only subscribed books
+ *   pay for the full decode (and the state string copy)
+ */
+size_t ItchParser::parse_packet(const char* data, size_t len, std::vector<Event>& out) {
+    mold::PacketHeader header;
+    if (!mold::read_header(data, len, header)) return 0;
+    if (header.heartbeat() || header.end_of_session()) return 0;
+
+    if (header.count > MAX_MESSAGE_COUNT) {
+        std::cerr << "[ITCH] Invalid message count: " << header.count << "\n";
+        return 0;
+    }
 
+    // grow geometrically: callers often append many packets to one vector
+    const size_t need = out.size() + header.count;
+    if (need > out.capacity()) out.reserve(std::max(need, 2 * out.capacity()));
 
+    const char* p   = data + mold::HEADER_SIZE;
+    const char* end = data + len;
+    size_t n = 0;
+    for (; n < header.count; ++n) {
+        if (size_t(end - p) < mold::LENGTH_SIZE) {
+            std::cerr << "[ITCH] Truncated packet at message " << n << "\n";
+            break;
+        }
+        const uint16_t msg_len = endian::read_u16_be(p);
+        p += mold::LENGTH_SIZE;
+        if (msg_len < 1 || msg_len > size_t(end - p)) {
+            std::cerr << "[ITCH] Truncated packet at message " << n << "\n";
+            break;
+        }
 
+        if (filter_ && !subscribed(p, msg_len, *filter_)) {
+            ++filtered_;
+            p += msg_len;
+            continue;
+        }
 
+        Event ev = parse_message(p, msg_len);
+        if (ev.type != MessageType::Other) {
+            out.push_back(ev);
+        } else {
+            if (unknown_logged_ < MAX_UNKNOWN_LOGS) {
+                // formatted locally: std::hex would change the shared
+                // std::cerr flags under parallel replays
+                char code[4];
+                std::snprintf(code, sizeof(code), "%x", static_cast<unsigned>(static_cast<unsigned char>(p[0])));
+                std::cerr << "[ITCH] Unknown message type: 0x" << code << "\n";
+                ++unknown_logged_;
+            }
+        }
+        p += msg_len;
+    }
 
+    return n;
+}
 
+/**
+ * @details Implementation notes:
+ * - Only the type byte and timestamp of each message are read
+ * - Scanning stops at the first non-'T' message; 'T' messages ahead of it
+ *   still move seconds forward
+ */
+bool ItchParser::packet_time(const char* data, size_t len, uint32_t& seconds, uint64_t& time_ns) {
+    mold::PacketHeader header{};
+    if (!mold::read_header(data, len, header)) return false;
+    if (header.heartbeat() || header.end_of_session()) return false;
+
+    const char* p   = data + mold::HEADER_SIZE;
+    const char* end = data + len;
+    for (size_t n = 0; n < header.count; ++n) {
+        if (size_t(end - p) < mold::LENGTH_SIZE) return false;
+        const uint16_t msg_len = endian::read_u16_be(p);
+        p += mold::LENGTH_SIZE;
+        if (msg_len > size_t(end - p) || msg_len < TIMESTAMP_OFFSET + 4) return false;
+
+        const uint32_t stamp = endian::read_u32_be(p + TIMESTAMP_OFFSET);
+        if (p[0] == static_cast<char>(MessageType::Seconds)) {
+            seconds = stamp;
+        } else {
+            time_ns = static_cast<uint64_t>(seconds) * NS_PER_SECOND + stamp;
+            return true;
+        }
+        p += msg_len;
+    }
+    return false;
+}
 
+/**
+ * @details Implementation notes:
+ * - One indexed load picks the decoder; no switch or compare chain, so
+ *   new message types cost nothing on the hot path
+ * - Decoders are generated from the itch_layout.h descriptors and only
+ *   fill fields; the full timestamp is derived here once
+ */
+Event ItchParser::parse_message(const char* msg, size_t len)
+{
+    Event event{};
+    if (len < 1) return event;
 
+    const Decoder decode = DISPATCH.by_type[static_cast<uint8_t>(msg[0])];
+    if (__builtin_expect(decode == nullptr, 0)) return event;   // unknown type
 
+    event.type = static_cast<MessageType>(msg[0]);
+    if (__builtin_expect(!decode(msg + 1, len - 1, event), 0)) {
+        event.type = MessageType::Other;   // shorter than its layout
+        return event;
+    }
 
-
-
+    if (event.type == MessageType::Seconds) second_ns_ = event.timestamp;
+    else                                    event.timestamp = second_ns_ + event.nanosec;
+    return event;
+}
@@ -1,16 +1,37 @@
 #pragma once
 #include <istream>
 #include <vector>
+#include "moldudp64.h"
 #include "types/event.h"
 
+class OrderbookFilter;
+
+/**
+ * @brief Counters of the parser's resync mode
+ */
+struct ResyncStats
+{
+    size_t   resyncs = 0;         ///< Corrupt spots skipped over
+    uint64_t skipped_bytes = 0;   ///< Bytes discarded while scanning for a header
+    uint64_t lost_messages = 0;   ///< Sequence numbers missing across a resync
+};
+
 /**
  * @brief Parser for ITCH protocol messages from MoldUDP64 packets
- * 
+ *
  * @details Reads binary data from an input stream and parses individual ITCH messages
  * into Event objects. Handles MoldUDP64 packet structure and ITCH message parsing.
- * Supports ITCH message types: OrderbookState, AddOrder, ExecuteOrder, and DeleteOrder.
+ * Supports the BISTECH ITCH message set: Seconds, OrderbookDirectory,
+ * CombinationLeg, TickSize, SystemEvent, OrderbookState, AddOrder,
+ * ExecuteOrder, ExecuteWithPrice, ReplaceOrder, DeleteOrder, Trade and
+ * EquilibriumPrice. Seconds ('T') messages set the second that later
+ * events' timestamp is based on.
+ *
+ * Framing and decoding are separate: next_raw_packet() only frames one packet
+ * out of the stream, parse_packet() decodes a packet already in memory. Live
+ * sources (UDP datagrams) use parse_packet() directly without any stream.
  */
-class ItchParser 
+class ItchParser
 {
 public:
     /**
@@ -19,28 +40,153 @@ public:
      */
     explicit ItchParser(std::istream& in);
 
+    /**
+     * @brief Constructs a stream-less parser for in-memory packets
+     *
+     * @details Only parse_packet() is usable; good() is always false.
+     */
+    ItchParser();
+
     /**
      * @brief Parses next MoldUDP64 packet and returns all ITCH messages
      * @return Vector of parsed Event objects (empty if end of stream)
-     * 
+     *
      * @details Reads a complete MoldUDP64 packet from the input stream,
      * parses the header to determine message count, then processes each
      * length-prefixed ITCH message within the packet.
      */
     std::vector<Event> next_packet();
 
-private: 
-    std::istream& in_;  ///< Input stream reference for reading ITCH data
-    std::vector<char> buffer_;  ///< Pre-allocated buffer for message parsing
+    /**
+     * @brief Frames the next MoldUDP64 packet from the stream without decoding
+     * @param out Receives header + length-prefixed messages exactly as on the wire
+     * @return false on EOF or a corrupt header (out is then empty)
+     *
+     * @details On a short read inside the packet, out holds the complete
+     * messages read so far and its header count is lowered to match.
+     * In resync mode a corrupt packet is never returned; framing continues
+     * at the next plausible header instead (see set_resync()).
+     */
+    bool next_raw_packet(std::vector<char>& out);
+
+    /**
+     * @brief Recovers from corrupt framing instead of stopping on it
+     * @param on Enables the mode; the stream must be seekable (files)
+     *
+     * @details A header is plausible when its session matches the first
+     * packet's, its count is sane and its sequence number continues the
+     * last packet (gaps up to a window are allowed and counted as lost).
+     * A bad count, a bad message length or a message type byte that is not
+     * an ITCH code makes the parser scan forward from the corrupt packet
+     * for the next plausible header that also frames cleanly. Heartbeats
+     * and end-of-session packets are skipped silently.
+     */
+    void set_resync(bool on);
+
+    /**
+     * @brief Counters of the resync mode so far
+     */
+    const ResyncStats& resync_stats() const { return resync_stats_; }
+
+    /**
+     * @brief Decodes one MoldUDP64 packet held in memory
+     * @param data Packet start (header included)
+     * @param len Packet length in bytes
+     * @param out Decoded events are appended here
+     * @return Number of messages found in the packet (decoded or not)
+     *
+     * @details Heartbeats and end-of-session packets yield no events.
+     * A message running past len ends the packet.
+     */
+    size_t parse_packet(const char* data, size_t len, std::vector<Event>& out);
+
+    /**
+     * @brief Capture timestamp of a packet, without decoding it
+     * @param data Packet start (header included)
+     * @param len Packet length in bytes
+     * @param seconds Seconds of the last 'T' (Seconds) message; updated
+     *        in place by any 'T' message in this packet
+     * @param time_ns seconds * 1e9 + nanoseconds of the first timestamped message
+     * @return false if the packet holds no timestamped message
+     *
+     * @details Every ITCH message carries its 4-byte timestamp right after
+     * the type byte (seconds for 'T', nanoseconds within the second for
+     * all other types). Used by the replayer to pace packets.
+     */
+    static bool packet_time(const char* data, size_t len, uint32_t& seconds, uint64_t& time_ns);
+
+    /**
+     * @brief Decodes only messages for subscribed order books
+     * @param filter Subscribed ids (nullptr decodes everything); must outlive
+     *        the parser or be reset
+     *
+     * @details Messages of other books are dropped from parse_packet()
+     * output before decoding. Market-wide messages (Seconds, System Event)
+     * are always decoded, so timestamps stay correct.
+     */
+    void set_filter(const OrderbookFilter* filter) { filter_ = filter; }
+
+    /**
+     * @brief Messages skipped by the filter so far
+     */
+    size_t filtered() const { return filtered_; }
+
+    /**
+     * @brief Checks whether the underlying stream can still be read
+     * @return true while the input stream has not hit EOF or an error
+     */
+    bool good() const { return in_ && in_->good(); }
+
+private:
+    std::istream* in_;  ///< Input stream for ITCH data (nullptr for in-memory use)
+    std::vector<char> buffer_;  ///< Pre-allocated buffer for packet framing
+    Timestamp second_ns_ = 0;   ///< Last 'T' message, in ns (base of Event::timestamp)
+    const OrderbookFilter* filter_ = nullptr;   ///< Subscribed books (nullptr = all)
+    size_t filtered_ = 0;       ///< Messages skipped by filter_
+    size_t unknown_logged_ = 0; ///< Unknown types reported (per parser, so workers never share it)
+
+    // resync mode
+    bool resync_ = false;
+    bool have_session_ = false;         ///< session_/next_seq_ are known
+    char session_[mold::SESSION_SIZE];  ///< Session of the first packet
+    uint64_t next_seq_ = 0;             ///< Sequence expected in the next packet
+    std::streamoff pos_ = 0;            ///< Stream offset of the next packet
+    std::vector<char> scan_;            ///< Block buffer for header scanning
+    ResyncStats resync_stats_;
+
+    /**
+     * @brief Outcome of framing one packet
+     */
+    enum class Frame { Ok, Truncated, Eof, Control, Corrupt };
+
+    /**
+     * @brief Frames one packet at the stream position into out
+     * @return Ok / Truncated (short read; out holds the complete messages),
+     *         Eof (no header), Control (heartbeat/end of session) or
+     *         Corrupt (bad header, or a bad message in resync mode)
+     */
+    Frame frame_packet(std::vector<char>& out);
+
+    /**
+     * @brief Header check of resync mode (session, count, sequence)
+     */
+    bool plausible_header(const char* p) const;
+
+    /**
+     * @brief Scans forward from a corrupt packet for the next clean one
+     * @param from Stream offset of the corrupt packet
+     * @return Framing result of the packet found (Eof if none)
+     */
+    Frame resync(std::streamoff from, std::vector<char>& out);
 
     /**
      * @brief Parses individual ITCH message into Event
      * @param msg Raw message buffer pointer
      * @param len Length of message in bytes
      * @return Parsed Event object with all relevant fields populated
-     * 
-     * @details Parses the message type byte and routes to appropriate
-     * parsing logic based on the ITCH protocol specification.
+     *
+     * @details The type byte indexes a 256-entry decoder table; unknown
+     * types and messages shorter than their layout return type Other.
      */
     Event parse_message(const char* msg, size_t len);
 };
@@ -0,0 +1,132 @@
+#include "latency_model.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+LatencyModel LatencyModel::fixed(Timestamp ns)
+{
+    LatencyModel m;
+    m.kind_ = Kind::Fixed;
+    m.fixed_ns_ = ns;
+    return m;
+}
+
+LatencyModel LatencyModel::normal(Timestamp mean_ns, Timestamp stddev_ns, uint64_t seed)
+{
+    LatencyModel m;
+    m.kind_ = Kind::Normal;
+    m.rng_.seed(seed);
+    m.normal_ = std::normal_distribution<double>(static_cast<double>(mean_ns), static_cast<double>(stddev_ns));
+    return m;
+}
+
+/**
+ * @details Implementation notes:
+ * - Empty buckets are dropped so a draw never lands in one
+ * - A histogram without observations degrades to zero latency
+ */
+LatencyModel LatencyModel::histogram(const std::vector<LatencyBucket>& buckets, uint64_t seed)
+{
+    LatencyModel m;
+    m.kind_ = Kind::Histogram;
+    m.rng_.seed(seed);
+
+    Timestamp lower = 0;
+    uint64_t total = 0;
+    for (const LatencyBucket& b : buckets) {
+        if (b.upper_ns < lower) {
+            std::cerr << "[WARN] LatencyModel: histogram bucket " << b.upper_ns << " out of order, skipped\n";
+            continue;
+        }
+        if (b.count > 0) {
+            total += b.count;
+            m.lower_.push_back(lower);
+            m.upper_.push_back(b.upper_ns);
+            m.cumulative_.push_back(total);
+        }
+        lower = b.upper_ns;
+    }
+    if (total == 0) {
+        std::cerr << "[WARN] LatencyModel: empty histogram, using zero latency\n";
+        return fixed(0);
+    }
+    return m;
+}
+
+bool LatencyModel::load_histogram(const std::string& path, std::vector<LatencyBucket>& out)
+{
+    std::ifstream in(path.c_str());
+    if (!in) {
+        std::cerr << "[ERROR] LatencyModel: cannot open histogram " << path << "\n";
+        return false;
+    }
+    out.clear();
+    uint64_t total = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        std::istringstream fields(line);
+        LatencyBucket b;
+        if (!(fields >> b.upper_ns >> b.count)) continue;
+        total += b.count;
+        out.push_back(b);
+    }
+    if (total == 0) {
+        std::cerr << "[ERROR] LatencyModel: no observations in " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @details Implementation notes:
+ * - Fixed: no random draw at all
+ * - Histogram: O(log buckets) bucket pick, then one uniform draw inside it
+ */
+Timestamp LatencyModel::sample()
+{
+    switch (kind_) {
+    case Kind::Fixed:
+        return fixed_ns_;
+    case Kind::Normal: {
+        const double ns = normal_(rng_);
+        return ns > 0 ? static_cast<Timestamp>(ns) : 0;
+    }
+    case Kind::Histogram: {
+        const uint64_t pick = rng_() % cumulative_.back();
+        const size_t i = std::upper_bound(cumulative_.begin(), cumulative_.end(), pick) - cumulative_.begin();
+        const Timestamp width = upper_[i] - lower_[i];
+        return width == 0 ? upper_[i] : lower_[i] + 1 + rng_() % width;
+    }
+    }
+    return 0;
+}
+
+Timestamp LatencyQueue::send(uint32_t owner, Side side, Price price, Quantity quantity, Timestamp now)
+{
+    const Timestamp latency = model_.sample();
+
+    DelayedOrder order;
+    order.sent     = now;
+    order.arrival  = now + latency;
+    order.seq      = next_seq_++;
+    order.owner    = owner;
+    order.side     = side;
+    order.price    = price;
+    order.quantity = quantity;
+    heap_.push(order);
+
+    ++stats_.sent;
+    stats_.total_latency += latency;
+    stats_.max_latency = std::max(stats_.max_latency, latency);
+    return order.arrival;
+}
+
+void LatencyQueue::clear()
+{
+    stats_.dropped += heap_.size();
+    while (!heap_.empty()) heap_.pop();
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "types/usings.h"
+#include "types/side.h"
+
+/**
+ * @brief One bucket of a measured latency histogram
+ */
+struct LatencyBucket
+{
+    Timestamp upper_ns = 0;   ///< Bucket covers (previous upper, upper_ns]
+    uint64_t  count = 0;      ///< Observations in the bucket
+};
+
+/**
+ * @brief Order-to-exchange latency, sampled once per order
+ *
+ * @details Three shapes, all deterministic for a given seed so replays are
+ * reproducible:
+ * - fixed(): every order takes the same time
+ * - normal(): mean plus Gaussian jitter, truncated at zero
+ * - histogram(): measured latencies; a bucket is picked by its share of
+ *   the observations (binary search over cumulative counts) and the value
+ *   is drawn uniformly inside it
+ */
+class LatencyModel
+{
+public:
+    /// Zero latency: orders arrive in the batch after the decision
+    LatencyModel() = default;
+
+    static LatencyModel fixed(Timestamp ns);
+    static LatencyModel normal(Timestamp mean_ns, Timestamp stddev_ns, uint64_t seed = 1);
+    static LatencyModel histogram(const std::vector<LatencyBucket>& buckets, uint64_t seed = 1);
+
+    /**
+     * @brief Reads a histogram from "upper_ns count" lines ('#' starts a comment)
+     * @param path Text file, e.g. exported from a wire capture
+     * @param out Buckets in file order (must be increasing)
+     * @return false if the file cannot be read or holds no observations
+     */
+    static bool load_histogram(const std::string& path, std::vector<LatencyBucket>& out);
+
+    /**
+     * @brief Draws the latency of the next order
+     */
+    Timestamp sample();
+
+private:
+    enum class Kind { Fixed, Normal, Histogram };
+
+    Kind kind_ = Kind::Fixed;
+    Timestamp fixed_ns_ = 0;
+    std::mt19937_64 rng_;
+    std::normal_distribution<double> normal_;
+    std::vector<Timestamp> lower_;       ///< Histogram bucket lower bounds (exclusive)
+    std::vector<Timestamp> upper_;       ///< Histogram bucket upper bounds (inclusive)
+    std::vector<uint64_t>  cumulative_;  ///< Running observation counts
+};
+
+/**
+ * @brief A strategy order on its way to the exchange
+ */
+struct DelayedOrder
+{
+    Timestamp sent = 0;        ///< Decision time (batch timestamp)
+    Timestamp arrival = 0;     ///< sent + sampled latency
+    uint64_t  seq = 0;         ///< Send order, breaks arrival ties
+    uint32_t  owner = 0;       ///< Strategy that sent it
+    Side      side = Side::Unknown;
+    Price     price = 0;
+    Quantity  quantity = 0;
+};
+
+/**
+ * @brief Counters of a LatencyQueue
+ */
+struct LatencyStats
+{
+    size_t    sent = 0;
+    size_t    arrived = 0;
+    size_t    dropped = 0;          ///< Still in flight at clear()
+    Timestamp total_latency = 0;    ///< Sum over sent orders
+    Timestamp max_latency = 0;
+};
+
+/**
+ * @brief Event-time priority queue of orders in flight
+ *
+ * @details A binary min-heap on (arrival, seq): send() and each released
+ * order cost O(log n) in the orders in flight, so one queue serves any
+ * number of strategies over a full day. Orders with equal arrival times
+ * are released in send order.
+ */
+class LatencyQueue
+{
+public:
+    explicit LatencyQueue(LatencyModel model = LatencyModel()) : model_(model) {}
+
+    /**
+     * @brief Samples a latency and queues the order
+     * @return Arrival time at the exchange
+     */
+    Timestamp send(uint32_t owner, Side side, Price price, Quantity quantity, Timestamp now);
+
+    /**
+     * @brief Releases every order that arrives at or before a time
+     * @param now Timestamp of the next book batch
+     * @param deliver Callable(const DelayedOrder&), called in arrival order
+     *
+     * @details The driver calls this before applying the batch stamped now,
+     * so the book reflects every event strictly before the arrival time.
+     */
+    template <typename Deliver>
+    void release(Timestamp now, Deliver deliver) {
+        while (!heap_.empty() && heap_.top().arrival <= now) {
+            const DelayedOrder order = heap_.top();
+            heap_.pop();
+            ++stats_.arrived;
+            deliver(order);
+        }
+    }
+
+    /**
+     * @brief Drops every order in flight (market close)
+     */
+    void clear();
+
+    size_t in_flight() const { return heap_.size(); }
+    const LatencyStats& stats() const { return stats_; }
+
+private:
+    struct LaterArrival {
+        bool operator()(const DelayedOrder& a, const DelayedOrder& b) const {
+            return a.arrival != b.arrival ? a.arrival > b.arrival : a.seq > b.seq;
+        }
+    };
+
+    LatencyModel model_;
+    std::priority_queue<DelayedOrder, std::vector<DelayedOrder>, LaterArrival> heap_;
+    uint64_t next_seq_ = 0;
+    LatencyStats stats_;
+};
@@ -0,0 +1,196 @@
+#include "mold_retransmit.h"
+#include "itch_parser.h"
+#include "util/endian.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    bool make_addr(const std::string& addr, uint16_t port, sockaddr_in& out) {
+        std::memset(&out, 0, sizeof(out));
+        out.sin_family = AF_INET;
+        out.sin_port   = htons(port);
+        return inet_pton(AF_INET, addr.c_str(), &out.sin_addr) == 1;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// MoldRequestClient
+// ---------------------------------------------------------------------------
+
+MoldRequestClient::MoldRequestClient(const std::string& server_addr, uint16_t server_port, uint16_t max_count)
+    : max_count_(max_count == 0 ? 1 : max_count)
+{
+    sockaddr_in server;
+    if (!make_addr(server_addr, server_port, server)) {
+        std::cerr << "[ERROR] MoldUDP64 bad request server address: " << server_addr << std::endl;
+        return;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&server), sizeof(server)) != 0) {
+        std::cerr << "[ERROR] MoldUDP64 request socket failed: " << std::strerror(errno) << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    fd_ = fd;
+}
+
+MoldRequestClient::~MoldRequestClient()
+{
+    if (fd_ >= 0) close(fd_);
+}
+
+bool MoldRequestClient::request(const char* session, uint64_t seq, uint64_t count)
+{
+    if (fd_ < 0 || count == 0) return false;
+
+    mold::PacketHeader h{};
+    std::memcpy(h.session, session, mold::SESSION_SIZE);
+    h.seq = seq;
+    h.count = static_cast<uint16_t>(count < max_count_ ? count : max_count_);
+
+    char buf[mold::HEADER_SIZE];
+    mold::write_header(buf, h);
+    if (send(fd_, buf, sizeof(buf), 0) != static_cast<ssize_t>(sizeof(buf))) {
+        std::cerr << "[ERROR] MoldUDP64 request send failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ++requests_;
+    return true;
+}
+
+bool MoldRequestClient::poll(std::vector<char>& packet)
+{
+    if (fd_ < 0) return false;
+    packet.resize(65536);
+    const ssize_t n = recv(fd_, &packet[0], packet.size(), MSG_DONTWAIT);
+    if (n <= 0) {
+        packet.clear();
+        return false;
+    }
+    packet.resize(static_cast<size_t>(n));
+    ++responses_;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// MoldRequestServer
+// ---------------------------------------------------------------------------
+
+/**
+ * @details Implementation notes:
+ * - Packets are framed with ItchParser::next_raw_packet and their messages
+ *   copied into one flat buffer; offsets_[i] is message first_seq_ + i
+ * - Sequences are assumed contiguous from the first packet (a capture of
+ *   one session)
+ */
+MoldRequestServer::MoldRequestServer(std::istream& capture, const std::string& bind_addr,
+                                     uint16_t port, size_t max_bytes)
+    : max_bytes_(max_bytes)
+{
+    std::memset(session_, ' ', mold::SESSION_SIZE);
+
+    ItchParser framer(capture);
+    std::vector<char> packet;
+    bool first = true;
+    while (framer.good()) {
+        if (!framer.next_raw_packet(packet)) continue;
+        mold::PacketHeader h{};
+        mold::read_header(packet.data(), packet.size(), h);
+        if (first) {
+            std::memcpy(session_, h.session, mold::SESSION_SIZE);
+            first_seq_ = h.seq;
+            first = false;
+        }
+        const char* p = packet.data() + mold::HEADER_SIZE;
+        const char* end = packet.data() + packet.size();
+        while (p < end) {
+            const size_t len = mold::LENGTH_SIZE + endian::read_u16_be(p);
+            offsets_.push_back(messages_.size());
+            messages_.insert(messages_.end(), p, p + len);
+            p += len;
+        }
+    }
+    offsets_.push_back(messages_.size());
+
+    sockaddr_in addr;
+    if (!make_addr(bind_addr, port, addr)) {
+        std::cerr << "[ERROR] MoldUDP64 bad server address: " << bind_addr << std::endl;
+        return;
+    }
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "[ERROR] MoldUDP64 server bind failed: " << std::strerror(errno) << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    fd_ = fd;
+}
+
+MoldRequestServer::~MoldRequestServer()
+{
+    if (fd_ >= 0) close(fd_);
+}
+
+uint16_t MoldRequestServer::local_port() const
+{
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (fd_ < 0 || getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+/**
+ * @details Implementation notes:
+ * - Requests for another session or beyond the capture are ignored
+ * - The answer is split into packets of at most max_bytes_
+ */
+size_t MoldRequestServer::serve(int timeout_ms)
+{
+    if (fd_ < 0) return 0;
+
+    size_t served = 0;
+    pollfd pfd{fd_, POLLIN, 0};
+    std::vector<char> out;
+    while (::poll(&pfd, 1, served == 0 ? timeout_ms : 0) > 0) {
+        char req[64];
+        sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        const ssize_t n = recvfrom(fd_, req, sizeof(req), 0, reinterpret_cast<sockaddr*>(&from), &from_len);
+        if (n < 0) break;
+
+        mold::PacketHeader h{};
+        if (!mold::read_header(req, static_cast<size_t>(n), h)) continue;
+        if (!mold::same_session(h.session, session_) || h.seq < first_seq_) continue;
+
+        uint64_t index = h.seq - first_seq_;
+        const uint64_t end_index = std::min<uint64_t>(index + h.count, messages());
+        while (index < end_index) {
+            out.assign(mold::HEADER_SIZE, 0);
+            mold::PacketHeader resp;
+            std::memcpy(resp.session, session_, mold::SESSION_SIZE);
+            resp.seq = first_seq_ + index;
+            resp.count = 0;
+            while (index < end_index) {
+                const size_t len = offsets_[index + 1] - offsets_[index];
+                if (resp.count != 0 && out.size() + len > max_bytes_) break;
+                out.insert(out.end(), messages_.begin() + offsets_[index], messages_.begin() + offsets_[index + 1]);
+                ++resp.count;
+                ++index;
+            }
+            mold::write_header(&out[0], resp);
+            sendto(fd_, out.data(), out.size(), 0, reinterpret_cast<sockaddr*>(&from), from_len);
+        }
+        ++served;
+    }
+    return served;
+}
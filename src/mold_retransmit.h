@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "moldudp64.h"
+
+/**
+ * @brief MoldUDP64 retransmission request client
+ *
+ * @details A request is a bare 20-byte header (session, first sequence,
+ * message count) sent to the exchange's request server, which answers with
+ * ordinary downstream packets to the requesting socket. Responses are
+ * polled without blocking and handed to the sequencer like live packets.
+ */
+class MoldRequestClient
+{
+public:
+    /**
+     * @param server_addr Request server address
+     * @param server_port Request server port
+     * @param max_count Largest message count asked for in one request
+     */
+    MoldRequestClient(const std::string& server_addr, uint16_t server_port, uint16_t max_count = 500);
+    ~MoldRequestClient();
+
+    MoldRequestClient(const MoldRequestClient&) = delete;
+    MoldRequestClient& operator=(const MoldRequestClient&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+
+    /**
+     * @brief Sends one request (count is capped at max_count)
+     * @return false if the request could not be sent
+     */
+    bool request(const char* session, uint64_t seq, uint64_t count);
+
+    /**
+     * @brief Takes one response packet if any is queued
+     * @param packet Receives the packet bytes
+     * @return false if nothing is pending
+     */
+    bool poll(std::vector<char>& packet);
+
+    uint64_t requests() const  { return requests_; }    ///< Requests sent
+    uint64_t responses() const { return responses_; }   ///< Response packets received
+
+private:
+    int      fd_ = -1;          ///< Socket connected to the request server
+    uint16_t max_count_;        ///< Per-request message cap
+    uint64_t requests_ = 0;
+    uint64_t responses_ = 0;
+};
+
+/**
+ * @brief Stand-in MoldUDP64 request server backed by a capture file
+ *
+ * @details Indexes every message of the capture by sequence number and
+ * answers requests with packets of up to max_bytes. Used by tests and for
+ * exercising recovery against a recorded session; not a production server.
+ */
+class MoldRequestServer
+{
+public:
+    /**
+     * @param capture Capture file (MoldUDP64 packets back to back)
+     * @param bind_addr Local address to serve on
+     * @param port Local port (0 = ephemeral, see local_port())
+     * @param max_bytes Largest response packet
+     */
+    MoldRequestServer(std::istream& capture, const std::string& bind_addr = "127.0.0.1",
+                      uint16_t port = 0, size_t max_bytes = mold::MAX_PACKET);
+    ~MoldRequestServer();
+
+    MoldRequestServer(const MoldRequestServer&) = delete;
+    MoldRequestServer& operator=(const MoldRequestServer&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+
+    /**
+     * @brief Answers the requests that arrive within timeout_ms
+     * @return Number of requests served
+     */
+    size_t serve(int timeout_ms);
+
+    uint16_t local_port() const;
+    uint64_t first_seq() const { return first_seq_; }
+    uint64_t messages() const  { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+private:
+    int       fd_ = -1;                  ///< Bound socket
+    size_t    max_bytes_;                ///< Response packet limit
+    char      session_[mold::SESSION_SIZE];
+    uint64_t  first_seq_ = 0;            ///< Sequence of messages_[0]
+    std::vector<char>   messages_;       ///< Length-prefixed messages, back to back
+    std::vector<size_t> offsets_;        ///< Start of each message (+ end sentinel)
+};
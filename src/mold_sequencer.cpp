@@ -0,0 +1,165 @@
+#include "mold_sequencer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/endian.h"
+
+MoldSequencer::MoldSequencer(uint64_t first_seq, size_t max_buffered)
+    : expected_(first_seq)
+    , known_end_(first_seq)
+    , max_buffered_(max_buffered)
+{
+    std::memset(session_, ' ', mold::SESSION_SIZE);
+    ready_.reserve(8);
+}
+
+/**
+ * @details Implementation notes:
+ * - Views from the previous call are invalidated first (released_ cleared)
+ * - known_end_ tracks the highest sequence announced by any packet,
+ *   heartbeat or end-of-session, so a gap is detected even when the
+ *   missing messages are the last ones sent before a quiet period
+ * - A gap is counted once, when the sequencer goes from no gap to gap
+ */
+size_t MoldSequencer::offer(const char* data, size_t len)
+{
+    ready_.clear();
+    released_.clear();
+
+    mold::PacketHeader h{};
+    if (!mold::read_header(data, len, h)) return 0;
+    ++stats_.packets;
+
+    if (!have_session_) {
+        std::memcpy(session_, h.session, mold::SESSION_SIZE);
+        have_session_ = true;
+        if (expected_ == 0) expected_ = known_end_ = h.seq;
+    } else if (!mold::same_session(session_, h.session)) {
+        ++stats_.session_changes;
+        reset(h);
+    }
+
+    const bool was_gap = in_gap();
+    size_t fresh = 0;
+
+    if (h.heartbeat()) {
+        known_end_ = std::max(known_end_, h.seq);
+    } else if (h.end_of_session()) {
+        end_seq_ = h.seq;
+        known_end_ = std::max(known_end_, h.seq);
+    } else if (h.next_seq() <= expected_) {
+        ++stats_.duplicates;
+    } else if (h.seq > expected_) {
+        // early: hold until the gap before it is filled
+        known_end_ = std::max(known_end_, h.next_seq());
+        auto it = early_.find(h.seq);
+        if (it != early_.end() && it->second.size() >= len) {
+            ++stats_.duplicates;
+        } else if (it == early_.end() && early_.size() >= max_buffered_) {
+            ++stats_.dropped;
+        } else {
+            early_[h.seq].assign(data, data + len);
+            ++stats_.buffered;
+            fresh = h.count;
+        }
+    } else {
+        known_end_ = std::max(known_end_, h.next_seq());
+        fresh = release(data, len, h);
+        drain_early();
+    }
+
+    if (end_seq_ != 0 && expected_ >= end_seq_) ended_ = true;
+    if (!was_gap && in_gap()) ++stats_.gaps;
+    return fresh;
+}
+
+/**
+ * @details Implementation notes:
+ * - Fast path: packet starts exactly at expected_ -> released in place
+ * - Overlap: the already-seen leading messages are skipped and the rest
+ *   is copied behind a rewritten header (seq = expected_)
+ */
+size_t MoldSequencer::release(const char* data, size_t len, const mold::PacketHeader& h)
+{
+    const uint64_t skip = expected_ - h.seq;
+    const uint64_t count = h.count - skip;
+
+    if (skip == 0) {
+        ready_.push_back(View{data, len});
+    } else {
+        ++stats_.overlaps;
+        const char* p = data + mold::HEADER_SIZE;
+        const char* end = data + len;
+        for (uint64_t i = 0; i < skip; ++i) {
+            if (size_t(end - p) < mold::LENGTH_SIZE) return 0;
+            const size_t msg_len = endian::read_u16_be(p);
+            if (msg_len > size_t(end - p) - mold::LENGTH_SIZE) return 0;
+            p += mold::LENGTH_SIZE + msg_len;
+        }
+
+        released_.push_back(std::vector<char>(mold::HEADER_SIZE));
+        std::vector<char>& out = released_.back();
+        mold::PacketHeader trimmed = h;
+        trimmed.seq = expected_;
+        trimmed.count = static_cast<uint16_t>(count);
+        mold::write_header(&out[0], trimmed);
+        out.insert(out.end(), p, end);
+        ready_.push_back(View{out.data(), out.size()});
+    }
+
+    expected_ = h.next_seq();
+    stats_.delivered += count;
+    return static_cast<size_t>(count);
+}
+
+void MoldSequencer::drain_early()
+{
+    while (!early_.empty() && early_.begin()->first <= expected_) {
+        auto it = early_.begin();
+        mold::PacketHeader h{};
+        mold::read_header(it->second.data(), it->second.size(), h);
+        if (h.next_seq() <= expected_) {
+            ++stats_.duplicates;
+            early_.erase(it);
+            continue;
+        }
+        // keep the bytes alive behind the view until the next offer()
+        released_.push_back(std::move(it->second));
+        early_.erase(it);
+        const std::vector<char>& pkt = released_.back();
+        release(pkt.data(), pkt.size(), h);
+    }
+}
+
+uint64_t MoldSequencer::missing_count() const
+{
+    if (!in_gap()) return 0;
+    uint64_t end = known_end_;
+    if (!early_.empty()) end = std::min(end, early_.begin()->first);
+    return end - expected_;
+}
+
+uint64_t MoldSequencer::skip_gap()
+{
+    ready_.clear();
+    released_.clear();
+
+    const uint64_t missing = missing_count();
+    if (missing == 0) return 0;
+
+    expected_ += missing;
+    stats_.lost += missing;
+    drain_early();
+    if (end_seq_ != 0 && expected_ >= end_seq_) ended_ = true;
+    return missing;
+}
+
+void MoldSequencer::reset(const mold::PacketHeader& h)
+{
+    std::memcpy(session_, h.session, mold::SESSION_SIZE);
+    expected_ = known_end_ = h.seq;
+    early_.clear();
+    ended_ = false;
+    end_seq_ = 0;
+}
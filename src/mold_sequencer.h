@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "moldudp64.h"
+
+/**
+ * @brief Counters kept by MoldSequencer
+ */
+struct SequencerStats
+{
+    uint64_t packets = 0;          ///< Packets offered
+    uint64_t delivered = 0;        ///< Messages released in sequence
+    uint64_t duplicates = 0;       ///< Packets carrying only already-seen messages
+    uint64_t overlaps = 0;         ///< Packets partially seen (trimmed before delivery)
+    uint64_t gaps = 0;             ///< Distinct gaps opened
+    uint64_t buffered = 0;         ///< Packets held back because they arrived early
+    uint64_t lost = 0;             ///< Messages given up on via skip_gap()
+    uint64_t dropped = 0;          ///< Early packets dropped because the buffer was full
+    uint64_t session_changes = 0;  ///< Session name switches (sequence restarts)
+};
+
+/**
+ * @brief Per-session MoldUDP64 sequence tracking with gap/duplicate handling
+ *
+ * @details Packets are offered in arrival order and released strictly in
+ * sequence, at message granularity:
+ * - in-order packets are released as they are (no copy)
+ * - packets wholly below the expected sequence are duplicates and dropped
+ * - packets straddling the expected sequence are trimmed to the new messages
+ * - packets above the expected sequence open a gap and are buffered until
+ *   the gap is filled (by the other line or a retransmission)
+ *
+ * Released packets are views valid until the next offer(); they are
+ * well-formed MoldUDP64 packets, so ItchParser::parse_packet() decodes them.
+ */
+class MoldSequencer
+{
+public:
+    /**
+     * @brief Packet released in sequence
+     */
+    struct View
+    {
+        const char* data;
+        size_t      len;
+    };
+
+    /**
+     * @param first_seq Sequence expected first (1 for a session start;
+     *        0 takes the sequence of the first packet seen)
+     * @param max_buffered Early packets kept while a gap is open
+     */
+    explicit MoldSequencer(uint64_t first_seq = 0, size_t max_buffered = 4096);
+
+    /**
+     * @brief Offers one received packet
+     * @param data Packet start (MoldUDP64 header included)
+     * @param len Packet length
+     * @return Number of new messages this packet contributed (0 for a
+     *         duplicate, heartbeat or malformed packet)
+     *
+     * @details Packets released by this call are available via ready().
+     */
+    size_t offer(const char* data, size_t len);
+
+    const std::vector<View>& ready() const { return ready_; }   ///< Released by the last offer()
+
+    uint64_t expected() const { return expected_; }             ///< Next sequence to release
+    bool     in_gap() const { return known_end_ > expected_; }  ///< Messages known to be missing?
+    bool     ended() const { return ended_; }                   ///< End-of-session seen and reached
+
+    /**
+     * @brief First missing range: [expected(), expected() + missing_count())
+     * @return Messages to request, 0 if there is no gap
+     */
+    uint64_t missing_count() const;
+
+    /**
+     * @brief Gives up on the first missing range and releases what follows
+     * @return Number of messages skipped
+     *
+     * @details For feeds without recovery: the book is then known to be
+     * wrong and the caller should log it. Released packets are in ready().
+     */
+    uint64_t skip_gap();
+
+    const char* session() const { return session_; }
+    const SequencerStats& stats() const { return stats_; }
+
+private:
+    uint64_t expected_;                 ///< Next sequence to release
+    uint64_t known_end_;                ///< One past the highest sequence seen
+    size_t   max_buffered_;             ///< Early packet capacity
+    bool     have_session_ = false;     ///< session_ is set
+    bool     ended_ = false;            ///< End of session released
+    uint64_t end_seq_ = 0;              ///< Sequence of the end-of-session packet (0 = none)
+    char     session_[mold::SESSION_SIZE];
+
+    std::map<uint64_t, std::vector<char>> early_;   ///< Early packets by first sequence
+    std::vector<std::vector<char>> released_;       ///< Storage behind ready_ views
+    std::vector<View> ready_;                       ///< Packets released by the last offer()
+    SequencerStats stats_;
+
+    /// Releases a packet whose first message is at or below expected_
+    size_t release(const char* data, size_t len, const mold::PacketHeader& h);
+    void   drain_early();
+    void   reset(const mold::PacketHeader& h);
+};
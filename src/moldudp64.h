@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "util/endian.h"
+
+/**
+ * @brief MoldUDP64 downstream packet framing
+ *
+ * @details A packet is a 20-byte header (session, sequence number of the
+ * first message, message count) followed by count length-prefixed messages.
+ * Count 0 is a heartbeat and 0xFFFF marks the end of the session; both
+ * carry no messages.
+ */
+namespace mold
+{
+    constexpr size_t   SESSION_SIZE   = 10;
+    constexpr size_t   HEADER_SIZE    = 20;
+    constexpr size_t   LENGTH_SIZE    = 2;        ///< Per-message length prefix
+    constexpr uint16_t HEARTBEAT      = 0;        ///< Message count of a heartbeat
+    constexpr uint16_t END_OF_SESSION = 0xFFFF;   ///< Message count of the last packet
+    constexpr size_t   MAX_PACKET     = 1500;     ///< Largest datagram on a standard MTU
+
+    /**
+     * @brief Decoded MoldUDP64 header
+     */
+    struct PacketHeader
+    {
+        char     session[SESSION_SIZE];   ///< Session name, space padded
+        uint64_t seq;                     ///< Sequence number of the first message
+        uint16_t count;                   ///< Number of messages in the packet
+
+        bool heartbeat() const      { return count == HEARTBEAT; }
+        bool end_of_session() const { return count == END_OF_SESSION; }
+        uint64_t next_seq() const   { return seq + (heartbeat() || end_of_session() ? 0 : count); }
+    };
+
+    /**
+     * @brief Decodes a header from raw bytes
+     * @param p Packet start
+     * @param len Bytes available
+     * @param h Destination header
+     * @return false if fewer than HEADER_SIZE bytes are available
+     */
+    inline bool read_header(const char* p, size_t len, PacketHeader& h) noexcept
+    {
+        if (len < HEADER_SIZE) return false;
+        std::memcpy(h.session, p, SESSION_SIZE);
+        h.seq   = endian::read_u64_be(p + SESSION_SIZE);
+        h.count = endian::read_u16_be(p + SESSION_SIZE + 8);
+        return true;
+    }
+
+    /**
+     * @brief Encodes a header into raw bytes
+     * @param p Destination (must have room for HEADER_SIZE bytes)
+     * @param h Header to write
+     */
+    inline void write_header(char* p, const PacketHeader& h) noexcept
+    {
+        std::memcpy(p, h.session, SESSION_SIZE);
+        endian::write_u64_be(p + SESSION_SIZE, h.seq);
+        endian::write_u16_be(p + SESSION_SIZE + 8, h.count);
+    }
+
+    /**
+     * @brief Compares two session names
+     */
+    inline bool same_session(const char* a, const char* b) noexcept
+    {
+        return std::memcmp(a, b, SESSION_SIZE) == 0;
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * @brief How a NodeArena backs its chunks
+ */
+enum class HugePages
+{
+    Off,            ///< Regular 4 KB pages (transparent huge pages refused)
+    Transparent,    ///< 2 MB-aligned chunks with madvise(MADV_HUGEPAGE)
+    Explicit        ///< MAP_HUGETLB chunks from the reserved huge-page pool
+};
+
+const char* to_string(HugePages mode);
+
+/**
+ * @brief Bytes and nodes held by one structure
+ */
+struct MemoryUse
+{
+    uint64_t bytes = 0;          ///< Bytes currently allocated
+    uint64_t peak_bytes = 0;     ///< High-water mark of bytes
+    uint64_t nodes = 0;          ///< Single-element allocations outstanding
+    uint64_t allocations = 0;    ///< allocate() calls over the lifetime
+
+    void add(size_t n, bool node)
+    {
+        bytes += n;
+        if (bytes > peak_bytes) peak_bytes = bytes;
+        if (node) ++nodes;
+        ++allocations;
+    }
+
+    void sub(size_t n, bool node)
+    {
+        bytes -= n;
+        if (node) --nodes;
+    }
+};
+
+/**
+ * @brief Chunk and usage counters of a NodeArena
+ */
+struct ArenaStats
+{
+    uint64_t reserved_bytes = 0;     ///< Bytes mapped for chunks
+    uint64_t chunks = 0;             ///< Chunks mapped
+    uint64_t used_bytes = 0;         ///< Node bytes handed out and not returned
+    uint64_t peak_used_bytes = 0;    ///< High-water mark of used_bytes
+    uint64_t large_bytes = 0;        ///< Outstanding blocks too big for a size class (heap)
+};
+
+/**
+ * @brief Node pool for the order book's containers
+ *
+ * @details Carves list, tree and hash nodes out of large mmap'ed chunks
+ * instead of scattering them over the heap, so the nodes of a book sit on
+ * few pages and, with huge pages, behind few TLB entries. Requests are
+ * rounded up to 16-byte size classes; freed nodes go onto a free list per
+ * class and are reused before the chunk grows. Blocks larger than
+ * MAX_NODE (hash bucket arrays, queue indexes) come from the heap.
+ *
+ * Chunks are only returned to the system when the arena is destroyed. An
+ * arena may be shared by many books, but only from one thread.
+ */
+class NodeArena
+{
+public:
+    static constexpr size_t HUGE_PAGE_BYTES = 2u << 20;   ///< x86-64 huge page
+    static constexpr size_t GRAIN = 16;                   ///< Size-class granularity
+    static constexpr size_t MAX_NODE = 512;               ///< Largest pooled request
+
+    /**
+     * @param mode Page backing; Explicit falls back to Transparent with a
+     *             warning when no huge pages are reserved
+     * @param chunk_bytes Bytes mapped per chunk (rounded up to 2 MB)
+     */
+    explicit NodeArena(HugePages mode = HugePages::Transparent, size_t chunk_bytes = HUGE_PAGE_BYTES);
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    void* allocate(size_t bytes);
+    void  deallocate(void* p, size_t bytes);
+
+    /// Backing in effect (after any fallback)
+    HugePages mode() const { return mode_; }
+
+    const ArenaStats& stats() const { return stats_; }
+
+private:
+    HugePages mode_;
+    size_t    chunk_bytes_;
+    std::vector<void*> chunks_;
+    char*     cursor_ = nullptr;
+    char*     end_ = nullptr;
+    void*     free_[MAX_NODE / GRAIN] = {};   ///< Free list head per size class
+    ArenaStats stats_;
+
+    /// Maps one more chunk; false if the system refused
+    bool grow();
+};
+
+/**
+ * @brief Where an ArenaAllocator draws from and reports to
+ */
+struct MemoryAccount
+{
+    MemoryUse  use;                  ///< This structure
+    MemoryUse* total = nullptr;      ///< Owner-wide sum (optional)
+    NodeArena* arena = nullptr;      ///< Node pool, or nullptr for the heap
+};
+
+/**
+ * @brief STL allocator that counts into a MemoryAccount
+ *
+ * @details A default-constructed allocator has no account and behaves
+ * like std::allocator. Copies and rebinds share the account, so every
+ * node type of a container (list node, tree node, hash node, bucket
+ * array) is charged to the same structure.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    ArenaAllocator() = default;
+    explicit ArenaAllocator(MemoryAccount* account) : account_(account) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : account_(other.account()) {}
+
+    T* allocate(size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+        if (!account_) return static_cast<T*>(::operator new(bytes));
+        void* p = account_->arena ? account_->arena->allocate(bytes) : ::operator new(bytes);
+        account_->use.add(bytes, n == 1);
+        if (account_->total) account_->total->add(bytes, n == 1);
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+        if (!account_) { ::operator delete(p); return; }
+        if (account_->arena) account_->arena->deallocate(p, bytes);
+        else                 ::operator delete(p);
+        account_->use.sub(bytes, n == 1);
+        if (account_->total) account_->total->sub(bytes, n == 1);
+    }
+
+    MemoryAccount* account() const { return account_; }
+
+private:
+    MemoryAccount* account_ = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.account() == b.account(); }
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.account() != b.account(); }
@@ -0,0 +1,446 @@
+#include "order_gateway.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    constexpr size_t TX_BATCH  = 64;            ///< Most messages coalesced into one send()
+    constexpr size_t RX_BUFFER = 1 << 17;       ///< Room for any frame plus a partial one
+    constexpr int    POLL_MS   = 50;            ///< Stub exchange shutdown check interval
+
+    constexpr uint32_t REJECT_INVALID   = 1;    ///< Zero price or quantity
+    constexpr uint32_t REJECT_DUPLICATE = 2;    ///< Token already resting
+    constexpr uint32_t CANCEL_REQUESTED = 1;    ///< Canceled on the client's request
+
+    bool make_addr(const std::string& addr, uint16_t port, sockaddr_in& out) {
+        std::memset(&out, 0, sizeof(out));
+        out.sin_family = AF_INET;
+        out.sin_port   = htons(port);
+        return inet_pton(AF_INET, addr.c_str(), &out.sin_addr) == 1;
+    }
+
+    void set_nodelay(int fd) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    bool send_all(int fd, const char* p, size_t n) {
+        while (n > 0) {
+            const ssize_t sent = send(fd, p, n, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += sent;
+            n -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+}
+
+uint64_t OrderGateway::now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+LatencySummary OrderGateway::summarize(std::vector<uint64_t> samples)
+{
+    LatencySummary s;
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    s.count = samples.size();
+    s.p50 = samples[(s.count - 1) * 50 / 100];
+    s.p99 = samples[(s.count - 1) * 99 / 100];
+    s.max = samples.back();
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// OrderGateway
+// ---------------------------------------------------------------------------
+
+OrderGateway::OrderGateway(const std::string& server_addr, uint16_t server_port, size_t ring_capacity)
+    : outbound_(ring_capacity), inbound_(ring_capacity)
+{
+    orders_.reserve(ring_capacity);
+    ack_ns_.reserve(ring_capacity);
+    wire_ns_.reserve(ring_capacity);
+
+    sockaddr_in server;
+    if (!make_addr(server_addr, server_port, server)) {
+        std::cerr << "[ERROR] OrderGateway bad exchange address: " << server_addr << std::endl;
+        return;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&server), sizeof(server)) != 0) {
+        std::cerr << "[ERROR] OrderGateway connect failed: " << std::strerror(errno) << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    set_nodelay(fd);
+    fd_ = fd;
+    connected_ = true;
+    running_ = true;
+    io_ = std::thread(&OrderGateway::run, this);
+}
+
+OrderGateway::~OrderGateway()
+{
+    stop();
+}
+
+void OrderGateway::stop()
+{
+    running_ = false;
+    if (io_.joinable()) io_.join();
+    connected_ = false;
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) - encodes in place into the claimed ring slot
+ * - Tokens are dense (1, 2, ...), so the order table is a plain vector
+ */
+uint64_t OrderGateway::enter(uint32_t owner, OrderbookId book, Side side, Price price, Quantity quantity, uint64_t tick_ns)
+{
+    if (!ok()) return 0;
+    Outbound* slot = outbound_.claim();
+    if (!slot) {
+        ++ring_full_;
+        return 0;
+    }
+    const uint64_t tick = tick_ns != 0 ? tick_ns : now_ns();
+    const uint64_t token = next_token_++;
+
+    ouch::Message m;
+    m.type = ouch::Type::EnterOrder;
+    m.token = token;
+    m.book = book;
+    m.side = side;
+    m.quantity = quantity;
+    m.price = price;
+    slot->length = static_cast<uint8_t>(ouch::encode(slot->bytes, m));
+    slot->tick_ns = tick;
+    outbound_.publish();
+
+    OpenOrder o;
+    o.owner = owner;
+    o.book = book;
+    o.side = side;
+    o.price = price;
+    o.remaining = quantity;
+    o.tick_ns = tick;
+    o.answered = false;
+    o.open = true;
+    orders_.push_back(o);
+    ++open_;
+    ++sent_;
+    return token;
+}
+
+bool OrderGateway::cancel(uint64_t token)
+{
+    if (!ok() || token == 0 || token > orders_.size() || !orders_[token - 1].open) return false;
+    Outbound* slot = outbound_.claim();
+    if (!slot) {
+        ++ring_full_;
+        return false;
+    }
+    ouch::Message m;
+    m.type = ouch::Type::CancelOrder;
+    m.token = token;
+    slot->length = static_cast<uint8_t>(ouch::encode(slot->bytes, m));
+    slot->tick_ns = 0;
+    outbound_.publish();
+    ++cancels_;
+    return true;
+}
+
+/**
+ * @details Implementation notes:
+ * - Reports for closed or unknown tokens are dropped
+ * - Executed reduces the open quantity; Canceled and Rejected close the
+ *   order and report whatever was still open
+ */
+bool OrderGateway::resolve(const Inbound& in, ExecutionReport& report)
+{
+    const ouch::Message& m = in.msg;
+    if (m.token == 0 || m.token > orders_.size()) return false;
+    OpenOrder& o = orders_[m.token - 1];
+    if (!o.open) return false;
+
+    report.type = m.type;
+    report.token = m.token;
+    report.owner = o.owner;
+    report.book = o.book;
+    report.side = o.side;
+    report.price = o.price;
+    report.tick_ns = o.tick_ns;
+    report.received_ns = in.received_ns;
+
+    switch (m.type) {
+    case ouch::Type::Accepted:
+        ++accepted_;
+        report.quantity = o.remaining;
+        break;
+    case ouch::Type::Executed:
+        ++executed_;
+        report.quantity = std::min(m.quantity, o.remaining);
+        report.price = m.price;
+        o.remaining -= report.quantity;
+        break;
+    case ouch::Type::Canceled:
+        ++canceled_;
+        report.quantity = o.remaining;
+        o.remaining = 0;
+        break;
+    case ouch::Type::Rejected:
+        ++rejected_;
+        report.quantity = o.remaining;
+        o.remaining = 0;
+        break;
+    default:
+        return false;
+    }
+
+    if (!o.answered) {
+        o.answered = true;
+        ack_ns_.push_back(in.received_ns > o.tick_ns ? in.received_ns - o.tick_ns : 0);
+    }
+    if (o.remaining == 0) {
+        o.open = false;
+        --open_;
+    }
+    return true;
+}
+
+/**
+ * @details Implementation notes:
+ * - Everything queued (up to TX_BATCH messages) goes out in one send()
+ * - Reads never block; a partial frame stays in the buffer for the next read
+ * - Yields the CPU only when a pass found nothing to send or read
+ * - A full inbound ring stalls reading until the strategy thread polls
+ */
+void OrderGateway::run()
+{
+    std::vector<char> tx(TX_BATCH * ouch::MAX_FRAME);
+    uint64_t ticks[TX_BATCH];
+    std::vector<char> rx(RX_BUFFER);
+    size_t rx_len = 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        bool idle = true;
+
+        size_t tx_len = 0, batch = 0;
+        for (Outbound* o = outbound_.front(); o && batch < TX_BATCH; o = outbound_.front()) {
+            std::memcpy(&tx[tx_len], o->bytes, o->length);
+            tx_len += o->length;
+            ticks[batch++] = o->tick_ns;
+            outbound_.pop();
+        }
+        if (tx_len > 0) {
+            idle = false;
+            if (!send_all(fd_, tx.data(), tx_len)) {
+                std::cerr << "[ERROR] OrderGateway send failed: " << std::strerror(errno) << std::endl;
+                break;
+            }
+            const uint64_t wire = now_ns();
+            for (size_t i = 0; i < batch; ++i) {
+                if (ticks[i] != 0) wire_ns_.push_back(wire > ticks[i] ? wire - ticks[i] : 0);
+            }
+        }
+
+        const ssize_t n = recv(fd_, &rx[rx_len], rx.size() - rx_len, MSG_DONTWAIT);
+        if (n > 0) {
+            idle = false;
+            rx_len += static_cast<size_t>(n);
+            const uint64_t received = now_ns();
+            size_t off = 0;
+            ouch::Message m;
+            for (size_t used; (used = ouch::decode(&rx[off], rx_len - off, m)) != 0; off += used) {
+                if (m.type == ouch::Type::Unknown) continue;
+                Inbound* slot;
+                while (!(slot = inbound_.claim())) {
+                    if (!running_.load(std::memory_order_relaxed)) return;
+                    std::this_thread::yield();
+                }
+                slot->msg = m;
+                slot->received_ns = received;
+                inbound_.publish();
+            }
+            std::memmove(&rx[0], &rx[off], rx_len - off);
+            rx_len -= off;
+        } else if (n == 0) {
+            std::cerr << "[WARN] OrderGateway: exchange closed the session" << std::endl;
+            break;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            std::cerr << "[ERROR] OrderGateway recv failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        if (idle) std::this_thread::yield();
+    }
+    connected_ = false;
+}
+
+// ---------------------------------------------------------------------------
+// StubExchange
+// ---------------------------------------------------------------------------
+
+StubExchange::StubExchange(bool fill, const std::string& bind_addr, uint16_t port)
+    : fill_(fill)
+{
+    sockaddr_in addr;
+    if (!make_addr(bind_addr, port, addr)) {
+        std::cerr << "[ERROR] StubExchange bad address: " << bind_addr << std::endl;
+        return;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 1) != 0) {
+        std::cerr << "[ERROR] StubExchange listen failed: " << std::strerror(errno) << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    fd_ = fd;
+    running_ = true;
+    thread_ = std::thread(&StubExchange::run, this);
+}
+
+StubExchange::~StubExchange()
+{
+    stop();
+}
+
+void StubExchange::stop()
+{
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+uint16_t StubExchange::local_port() const
+{
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (fd_ < 0 || getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+void StubExchange::run()
+{
+    while (running_.load(std::memory_order_relaxed)) {
+        pollfd p{ fd_, POLLIN, 0 };
+        if (::poll(&p, 1, POLL_MS) <= 0) continue;
+        const int client = accept(fd_, nullptr, nullptr);
+        if (client < 0) continue;
+        set_nodelay(client);
+        serve(client);
+        close(client);
+    }
+}
+
+/**
+ * @details Implementation notes:
+ * - Answers to one read are coalesced into one send()
+ * - Order ids and match ids count up from 1 per session
+ */
+void StubExchange::serve(int client)
+{
+    std::vector<char> rx(RX_BUFFER);
+    size_t rx_len = 0;
+    std::vector<char> tx;
+    std::unordered_map<uint64_t, Resting> resting;
+    uint64_t order_id = 0, match_id = 0;
+
+    auto reply = [&](const ouch::Message& m) {
+        char frame[ouch::MAX_FRAME];
+        const size_t n = ouch::encode(frame, m);
+        tx.insert(tx.end(), frame, frame + n);
+    };
+
+    while (running_.load(std::memory_order_relaxed)) {
+        pollfd p{ client, POLLIN, 0 };
+        if (::poll(&p, 1, POLL_MS) <= 0) continue;
+        const ssize_t n = recv(client, &rx[rx_len], rx.size() - rx_len, 0);
+        if (n <= 0) return;
+        rx_len += static_cast<size_t>(n);
+
+        tx.clear();
+        size_t off = 0;
+        ouch::Message in;
+        for (size_t used; (used = ouch::decode(&rx[off], rx_len - off, in)) != 0; off += used) {
+            ouch::Message out;
+            out.timestamp = OrderGateway::now_ns();
+            out.token = in.token;
+            out.book = in.book;
+            out.side = in.side;
+
+            if (in.type == ouch::Type::EnterOrder) {
+                orders_.fetch_add(1, std::memory_order_relaxed);
+                if (in.quantity == 0 || in.price == 0 || resting.count(in.token)) {
+                    out.type = ouch::Type::Rejected;
+                    out.reason = resting.count(in.token) ? REJECT_DUPLICATE : REJECT_INVALID;
+                    reply(out);
+                    continue;
+                }
+                out.type = ouch::Type::Accepted;
+                out.order_id = ++order_id;
+                out.quantity = in.quantity;
+                out.price = in.price;
+                reply(out);
+                if (fill_) {
+                    out.type = ouch::Type::Executed;
+                    out.match_id = ++match_id;
+                    reply(out);
+                } else {
+                    Resting r;
+                    r.book = in.book;
+                    r.side = in.side;
+                    r.quantity = in.quantity;
+                    resting[in.token] = r;
+                }
+            } else if (in.type == ouch::Type::CancelOrder) {
+                cancels_.fetch_add(1, std::memory_order_relaxed);
+                const auto it = resting.find(in.token);
+                if (it == resting.end()) continue;      // unknown or already gone: ignored
+                out.type = ouch::Type::Canceled;
+                out.book = it->second.book;
+                out.side = it->second.side;
+                out.quantity = it->second.quantity;
+                out.reason = CANCEL_REQUESTED;
+                resting.erase(it);
+                reply(out);
+            }
+        }
+        std::memmove(&rx[0], &rx[off], rx_len - off);
+        rx_len -= off;
+
+        if (!tx.empty() && !send_all(client, tx.data(), tx.size())) {
+            std::cerr << "[ERROR] StubExchange send failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+    }
+}
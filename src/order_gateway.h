@@ -0,0 +1,254 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ouch.h"
+#include "spsc_ring.h"
+#include "types/usings.h"
+#include "types/side.h"
+
+/**
+ * @brief Exchange answer to one of the gateway's orders
+ *
+ * @details Order fields the message does not carry (owner, side, limit
+ * price) are filled in from the gateway's own order table.
+ */
+struct ExecutionReport
+{
+    ouch::Type  type = ouch::Type::Unknown;   ///< Accepted, Executed, Canceled or Rejected
+    uint64_t    token = 0;
+    uint32_t    owner = 0;                    ///< Owner id given to enter()
+    OrderbookId book = 0;
+    Side        side = Side::Unknown;
+    Price       price = 0;                    ///< Execution price (Executed), else limit price
+    Quantity    quantity = 0;                 ///< Executed / canceled / rejected quantity
+    uint64_t    tick_ns = 0;                  ///< Tick time given to enter()
+    uint64_t    received_ns = 0;              ///< When the gateway read the report
+};
+
+/**
+ * @brief Count and percentiles of a set of latency samples (ns)
+ */
+struct LatencySummary
+{
+    size_t   count = 0;
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+};
+
+/**
+ * @brief Order-entry session to an exchange over TCP
+ *
+ * @details The strategy thread encodes each decision straight into a slot
+ * of a preallocated outbound ring; a dedicated I/O thread drains the ring,
+ * batching whatever is queued into one send(), and decodes the exchange's
+ * answers into a preallocated inbound ring that the strategy thread
+ * drains with poll(). Neither thread locks on the order path, and the
+ * rings are allocated once up front.
+ *
+ * Latency is measured from the tick time handed to enter() (the time the
+ * triggering market data was seen, or the decision time by default) to
+ * the moment the order was written to the socket and to the moment its
+ * first report was read back.
+ */
+class OrderGateway
+{
+public:
+    /**
+     * @param server_addr Exchange order-entry address
+     * @param server_port Exchange order-entry port
+     * @param ring_capacity Slots per ring (orders in flight to the I/O thread)
+     */
+    OrderGateway(const std::string& server_addr, uint16_t server_port, size_t ring_capacity = 4096);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    bool ok() const { return fd_ >= 0 && connected_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Queues an Enter Order message
+     * @param owner Id echoed back in this order's reports
+     * @param book Orderbook id
+     * @param side Buy or Sell
+     * @param price Limit price
+     * @param quantity Order quantity
+     * @param tick_ns Tick time (now_ns() clock), 0 = now
+     * @return Order token, 0 if the outbound ring is full or the session is down
+     */
+    uint64_t enter(uint32_t owner, OrderbookId book, Side side, Price price, Quantity quantity, uint64_t tick_ns = 0);
+
+    /**
+     * @brief Queues a Cancel Order message for an open order
+     * @return false if the token is not open or the ring is full
+     */
+    bool cancel(uint64_t token);
+
+    /**
+     * @brief Hands every report read so far to deliver(const ExecutionReport&)
+     * @return Number of reports delivered
+     */
+    template <typename F>
+    size_t poll(F&& deliver)
+    {
+        size_t n = 0;
+        for (Inbound* in = inbound_.front(); in; in = inbound_.front()) {
+            ExecutionReport report;
+            const bool mine = resolve(*in, report);
+            inbound_.pop();
+            if (!mine) continue;
+            deliver(static_cast<const ExecutionReport&>(report));
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Orders without a final report (fully executed, canceled or rejected)
+     */
+    size_t open_orders() const { return open_; }
+
+    /**
+     * @brief Stops the I/O thread and closes the session (idempotent)
+     */
+    void stop();
+
+    uint64_t sent() const      { return sent_; }        ///< Orders queued
+    uint64_t cancels() const   { return cancels_; }     ///< Cancel requests queued
+    uint64_t ring_full() const { return ring_full_; }   ///< enter()/cancel() calls refused by a full ring
+    uint64_t accepted() const  { return accepted_; }
+    uint64_t executed() const  { return executed_; }    ///< Execution reports (partial fills count each)
+    uint64_t canceled() const  { return canceled_; }
+    uint64_t rejected() const  { return rejected_; }
+
+    /**
+     * @brief Tick-to-wire latency of every order sent (valid after stop())
+     */
+    LatencySummary tick_to_wire() const { return summarize(wire_ns_); }
+
+    /**
+     * @brief Tick-to-first-report latency of every answered order
+     */
+    LatencySummary tick_to_ack() const { return summarize(ack_ns_); }
+
+    /// Clock used for tick and report times (steady, ns)
+    static uint64_t now_ns();
+
+    static LatencySummary summarize(std::vector<uint64_t> samples);
+
+private:
+    /// One framed message on its way to the socket
+    struct Outbound
+    {
+        char     bytes[ouch::MAX_FRAME];
+        uint8_t  length;
+        uint64_t tick_ns;               ///< 0 for cancels (not timed)
+    };
+
+    /// One decoded report on its way to the strategy thread
+    struct Inbound
+    {
+        ouch::Message msg;
+        uint64_t      received_ns;
+    };
+
+    /// Strategy-thread view of an order
+    struct OpenOrder
+    {
+        uint32_t    owner;
+        OrderbookId book;
+        Side        side;
+        Price       price;
+        Quantity    remaining;
+        uint64_t    tick_ns;
+        bool        answered;           ///< A report was seen (ack latency taken)
+        bool        open;               ///< No final report yet
+    };
+
+    int fd_ = -1;                       ///< Connected TCP socket
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::thread io_;
+
+    SpscRing<Outbound> outbound_;       ///< Strategy thread -> I/O thread
+    SpscRing<Inbound>  inbound_;        ///< I/O thread -> strategy thread
+
+    // strategy thread only
+    uint64_t next_token_ = 1;
+    std::vector<OpenOrder> orders_;     ///< Indexed by token - 1
+    size_t open_ = 0;
+    std::vector<uint64_t> ack_ns_;
+    uint64_t sent_ = 0, cancels_ = 0, ring_full_ = 0;
+    uint64_t accepted_ = 0, executed_ = 0, canceled_ = 0, rejected_ = 0;
+
+    // I/O thread only
+    std::vector<uint64_t> wire_ns_;
+
+    void run();
+
+    /// Fills a report from a decoded message; false for unknown tokens/types
+    bool resolve(const Inbound& in, ExecutionReport& report);
+};
+
+/**
+ * @brief Stand-in exchange order-entry server on a local TCP port
+ *
+ * @details Serves one session at a time on a background thread. Every
+ * Enter Order is answered with Accepted and, when filling, an Executed
+ * for the full quantity at the limit price; orders with a zero price or
+ * quantity are Rejected; Cancel Order answers Canceled for the open
+ * quantity. Used by tests and for end-to-end latency measurement over
+ * loopback; not a matching engine.
+ */
+class StubExchange
+{
+public:
+    /**
+     * @param fill Execute every accepted order at once (false = orders rest until canceled)
+     * @param bind_addr Local address to listen on
+     * @param port Local port (0 = ephemeral, see local_port())
+     */
+    explicit StubExchange(bool fill = true, const std::string& bind_addr = "127.0.0.1", uint16_t port = 0);
+    ~StubExchange();
+
+    StubExchange(const StubExchange&) = delete;
+    StubExchange& operator=(const StubExchange&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+    uint16_t local_port() const;
+
+    /**
+     * @brief Stops serving and closes the listening socket (idempotent)
+     */
+    void stop();
+
+    uint64_t orders() const  { return orders_.load(std::memory_order_relaxed); }    ///< Enter Order messages seen
+    uint64_t cancels() const { return cancels_.load(std::memory_order_relaxed); }   ///< Cancel Order messages seen
+
+private:
+    struct Resting
+    {
+        OrderbookId book;
+        Side        side;
+        Quantity    quantity;
+    };
+
+    int  fd_ = -1;                      ///< Listening socket
+    bool fill_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> orders_{0};
+    std::atomic<uint64_t> cancels_{0};
+    std::thread thread_;
+
+    void run();
+
+    /// Serves one connected session until it closes or stop() is called
+    void serve(int client);
+};
@@ -1,4 +1,5 @@
 #include "orderbook.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -6,6 +7,24 @@ namespace {
     constexpr Quantity MAX_SUSPICIOUS_QUANTITY = 1000000000;  // Maximum reasonable quantity (1 billion)
 }
 
+constexpr size_t Orderbook::PREFETCH_WINDOW;
+
+/**
+ * @details Implementation notes:
+ * - Every account adds into total_mem_; with an arena all four draw
+ *   from it, otherwise from the heap
+ */
+Orderbook::Orderbook(NodeArena* arena)
+	: bids_(std::greater<Price>(), LevelAllocator(&level_mem_))
+	, asks_(std::less<Price>(), LevelAllocator(&level_mem_))
+	, index_(0, std::hash<OrderId>(), std::equal_to<OrderId>(), IndexAllocator(&index_mem_))
+{
+	for (MemoryAccount* account : { &order_mem_, &level_mem_, &index_mem_, &queue_mem_ }) {
+		account->total = &total_mem_;
+		account->arena = arena;
+	}
+}
+
 void Orderbook::apply(const Event& event) 
 {
 	switch (event.type) 
@@ -13,7 +32,10 @@ void Orderbook::apply(const Event& event)
 		case MessageType::OrderbookState : handle_state(event); break;
 		case MessageType::AddOrder : handle_add(event); break;
 		case MessageType::ExecuteOrder : handle_exec(event); break;
+		case MessageType::ExecuteWithPrice : handle_exec(event); break;
+		case MessageType::ReplaceOrder : handle_replace(event); break;
 		case MessageType::DeleteOrder : handle_delete(event); break;
+		case MessageType::EquilibriumPrice : handle_equilibrium(event); break;
 		default : break;
 	} 
 }
@@ -50,11 +72,18 @@ void Orderbook::handle_add(const Event& event)
 			pos = it; break;
 		}
 	}
+	const bool at_back = (pos == level.fifo.end());
 	auto it = level.fifo.insert(pos, order);
+	if (at_back) level.queue.append(it->slot, order.quantity);
+	else         level.queue.invalidate();
 
 	level.aggregate += order.quantity;
 	level.num_orders += 1;
-	index_[order.id] = OrderHandle { order.side, order.price, it };
+	index_[order.id] = OrderHandle { order.side, order.price, it, &level };
+
+	sync_level(order.side, order.price, level.aggregate, level.num_orders);
+	if (depth_sink_) publish_level(order.side, order.price, event);
+	refresh_top(order.side, order.price, event);
 }
 
 /**
@@ -80,15 +109,17 @@ void Orderbook::handle_exec(const Event& event)
 	}
 
 	OrderHandle& handle = hit->second;
-	PriceLevel& level = (handle.side == Side::Buy) 
-						? bids_.at(handle.price) 
-						: asks_.at(handle.price);
+	const Side side = handle.side;
+	const Price price = handle.price;
+	PriceLevel& level = *handle.level;
 
 	// Update last executed price
 	Price current_price = event.price;
 	if (current_price == 0) current_price = handle.price; // fallback
 	last_exec_price_ = current_price;
 
+	if (queue_sink_) publish_queue(*handle.it, std::min(event.quantity, handle.it->quantity), event);
+
 	if (event.quantity >= handle.it->quantity) 
 	{
 		// sanity checks before mutation 
@@ -98,18 +129,25 @@ void Orderbook::handle_exec(const Event& event)
         "Trying to remove order from empty level");
 
 		// remove order completely
+		level.queue.remove(handle.it->slot, handle.it->quantity, true);
 		level.aggregate -= handle.it->quantity;
 		level.num_orders -= 1;
 		level.fifo.erase(handle.it);
 		index_.erase(hit);
-		erase_level_if_empty(handle.side, handle.price);
+		sync_level(side, price, level.aggregate, level.num_orders);
+		release_level(side, price, level);
 	}
 	else 
 	{
 		// partial execution - reduce order quantity
+		level.queue.remove(handle.it->slot, event.quantity, false);
 		handle.it->quantity -= event.quantity;
 		level.aggregate -= event.quantity;
+		sync_level(side, price, level.aggregate, level.num_orders);
 	}
+
+	if (depth_sink_) publish_level(side, price, event);
+	refresh_top(side, price, event);
 }
 
 /**
@@ -129,14 +167,178 @@ void Orderbook::handle_delete(const Event& event)
 	}
 
 	OrderHandle& handle = hit->second;
-	PriceLevel& level = (handle.side == Side::Buy) ? bids_.at(handle.price) : asks_.at(handle.price);
+	const Side side = handle.side;
+	const Price price = handle.price;
+	PriceLevel& level = *handle.level;
+	if (queue_sink_) publish_queue(*handle.it, handle.it->quantity, event);
 
 	// remove order completely
+	level.queue.remove(handle.it->slot, handle.it->quantity, true);
 	level.aggregate -= handle.it->quantity;
 	level.num_orders -= 1;
 	level.fifo.erase(handle.it);
 	index_.erase(hit);
-	erase_level_if_empty(handle.side, handle.price);
+	sync_level(side, price, level.aggregate, level.num_orders);
+	release_level(side, price, level);
+
+	if (depth_sink_) publish_level(side, price, event);
+	refresh_top(side, price, event);
+}
+
+/**
+ * @details Implementation notes:
+ * - Same price and lower quantity: reduced in place, time priority kept
+ * - Otherwise the order loses priority: it is removed and re-queued at the
+ *   back of its (new) level, with a ranking time no earlier than the
+ *   level's last order so later adds still sort behind it
+ * - Both touched levels are published; the side never changes, so one
+ *   top refresh covers both
+ */
+void Orderbook::handle_replace(const Event& event)
+{
+	auto hit = index_.find(event.order_id);
+	if (hit == index_.end())
+	{
+		std::cerr << "\033[31m[WARN]\033[0m REPLACE for unknown order_id=" << event.order_id
+				  << " qty=" << event.quantity << " px=" << event.price << "\n";
+		return;
+	}
+
+	OrderHandle& handle = hit->second;
+	const Side side = handle.side;
+	const Price old_price = handle.price;
+	PriceLevel& old_level = *handle.level;
+
+	if (event.price == old_price && event.quantity <= handle.it->quantity && event.quantity > 0)
+	{
+		if (queue_sink_ && event.quantity < handle.it->quantity)
+			publish_queue(*handle.it, handle.it->quantity - event.quantity, event);
+		old_level.queue.remove(handle.it->slot, handle.it->quantity - event.quantity, false);
+		old_level.aggregate -= handle.it->quantity - event.quantity;
+		handle.it->quantity = event.quantity;
+		sync_level(side, old_price, old_level.aggregate, old_level.num_orders);
+		if (depth_sink_) publish_level(side, old_price, event);
+		refresh_top(side, old_price, event);
+		return;
+	}
+
+	Order order = *handle.it;
+	if (queue_sink_) publish_queue(order, order.quantity, event);
+	old_level.queue.remove(order.slot, order.quantity, true);
+	old_level.aggregate -= order.quantity;
+	old_level.num_orders -= 1;
+	old_level.fifo.erase(handle.it);
+	index_.erase(hit);
+	sync_level(side, old_price, old_level.aggregate, old_level.num_orders);
+	release_level(side, old_price, old_level);
+	if (depth_sink_ && old_price != event.price) publish_level(side, old_price, event);
+
+	order.price = event.price;
+	order.quantity = event.quantity;
+	order.ranking_seq_num = event.ranking_seq_num;
+
+	PriceLevel& level = level_for(side, event.price);
+	if (!level.fifo.empty() && level.fifo.back().ranking_time > order.ranking_time)
+		order.ranking_time = level.fifo.back().ranking_time;
+	auto it = level.fifo.insert(level.fifo.end(), order);
+	level.queue.append(it->slot, order.quantity);
+
+	level.aggregate += order.quantity;
+	level.num_orders += 1;
+	index_[order.id] = OrderHandle { side, order.price, it, &level };
+	sync_level(side, order.price, level.aggregate, level.num_orders);
+
+	if (depth_sink_) publish_level(side, order.price, event);
+	const bool new_is_closer = (side == Side::Buy) ? order.price > old_price : order.price < old_price;
+	refresh_top(side, new_is_closer ? order.price : old_price, event);
+}
+
+/**
+ * @details Implementation notes:
+ * - Auction only: the book itself does not change until the uncross
+ *   executions arrive
+ */
+void Orderbook::handle_equilibrium(const Event& event)
+{
+	equilibrium_price_ = event.price;
+	equilibrium_quantity_ = event.quantity < event.ask_quantity ? event.quantity : event.ask_quantity;
+}
+
+/**
+ * @details Implementation notes:
+ * - The window's lookups are independent of each other, so the CPU can
+ *   have their misses in flight together; by the time an event is
+ *   applied its hash node, FIFO node and level are already cached
+ * - Hints are only hints: every event still does its own lookup, so an
+ *   earlier event in the window removing or moving the hinted order (or
+ *   adding the one a later event refers to) costs nothing
+ * - While batch_ is set, release_level() queues emptied levels and
+ *   refresh_top() only remembers the last event that moved the top; empty
+ *   levels left in the tree
+ *   meanwhile are already invisible to every query (num_orders == 0) and
+ *   level_for() simply reuses one when an order arrives at its price
+ * - Each emptied level is queued once (PriceLevel::emptied); tree nodes
+ *   do not move, and none is erased before the end, so the queued
+ *   pointers stay valid for the whole batch
+ */
+BatchSummary Orderbook::apply_batch(const Event* events, size_t count)
+{
+	BatchSummary summary;
+	summary.events = count;
+	summary.old_bid = best_bid_;
+	summary.old_ask = best_ask_;
+	const size_t orders_before = index_.size();
+
+	batch_ = &summary;
+	emptied_.clear();
+	top_event_ = nullptr;
+
+	for (size_t start = 0; start < count; start += PREFETCH_WINDOW) {
+		const size_t end = std::min(count, start + PREFETCH_WINDOW);
+		for (size_t i = start; i < end; ++i) prefetch(events[i]);
+		for (size_t i = start; i < end; ++i) apply(events[i]);
+	}
+	batch_ = nullptr;
+
+	// deferred cleanup: a level refilled since it was emptied stays
+	for (const auto& emptied : emptied_) {
+		PriceLevel& level = *emptied.second;
+		level.emptied = false;
+		if (level.num_orders != 0) ++summary.levels_revived;
+		else if (erase_level_if_empty(emptied.first, level.price)) ++summary.levels_erased;
+	}
+
+	// deferred top record: net change, attributed to the last event that moved it
+	if (top_event_) publish_top(summary.old_bid, summary.old_ask, top_side_, *top_event_);
+
+	summary.new_bid = best_bid_;
+	summary.new_ask = best_ask_;
+	summary.orders = static_cast<int64_t>(index_.size()) - static_cast<int64_t>(orders_before);
+	return summary;
+}
+
+/**
+ * @details Implementation notes:
+ * - std::unordered_map does not expose bucket addresses, so the hash
+ *   lookup itself is done here; the dependent FIFO node and level are
+ *   prefetched for write
+ * - Adds are not hinted: finding their level is a tree walk, the very
+ *   cost a hint would try to hide
+ */
+void Orderbook::prefetch(const Event& event) const
+{
+	switch (event.type)
+	{
+		case MessageType::ExecuteOrder :
+		case MessageType::ExecuteWithPrice :
+		case MessageType::DeleteOrder :
+		case MessageType::ReplaceOrder : break;
+		default : return;
+	}
+	const auto hit = index_.find(event.order_id);
+	if (hit == index_.end()) return;
+	__builtin_prefetch(&*hit->second.it, 1);
+	__builtin_prefetch(hit->second.level, 1);
 }
 
 /**
@@ -148,14 +350,16 @@ PriceLevel& Orderbook::level_for(Side side, Price price)
 {
 	if (side == Side::Buy)
 	{
-		auto result = bids_.emplace(price, PriceLevel{}); // std::pair 
+		auto result = bids_.emplace(price, PriceLevel(&order_mem_, &queue_mem_)); // std::pair 
+		if (batch_ && result.second) ++batch_->levels_created;
 		auto it = result.first;
 		if (it->second.price == 0) it->second.price = price;
 		return it->second;			// return price of that level
 	}
 	else
 	{
-		auto result = asks_.emplace(price, PriceLevel{});
+		auto result = asks_.emplace(price, PriceLevel(&order_mem_, &queue_mem_));
+		if (batch_ && result.second) ++batch_->levels_created;
 		auto it = result.first;
 		if (it->second.price == 0) it->second.price = price;
 		return it->second;
@@ -166,15 +370,16 @@ PriceLevel& Orderbook::level_for(Side side, Price price)
  * @details Implementation notes:
  * - Normalize aggregate to 0 when num_orders reach 0
  * - Only remove level if both num_orders and aggregate are 0
- * - Called after order deletions and executions
+ * - Called (through release_level) after order deletions and executions
  */
-void Orderbook::erase_level_if_empty(Side side, Price price) {
+bool Orderbook::erase_level_if_empty(Side side, Price price) {
     if (side == Side::Buy) {
         auto it = bids_.find(price);
         if (it != bids_.end()) {
             if (it->second.num_orders == 0) it->second.aggregate = 0; 
             if (it->second.num_orders == 0 && it->second.aggregate == 0) {
                 bids_.erase(it);
+                return true;
             }
         }
     } else {
@@ -183,9 +388,215 @@ void Orderbook::erase_level_if_empty(Side side, Price price) {
             if (it->second.num_orders == 0) it->second.aggregate = 0; 
             if (it->second.num_orders == 0 && it->second.aggregate == 0) {
                 asks_.erase(it);
+                return true;
             }
         }
     }
+    return false;
+}
+
+void Orderbook::release_level(Side side, Price price, PriceLevel& level)
+{
+	if (level.num_orders != 0) return;
+	if (!batch_) {
+		erase_level_if_empty(side, price);
+	} else if (!level.emptied) {
+		level.emptied = true;
+		emptied_.emplace_back(side, &level);
+	}
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) typical (first level is non-empty), O(n) worst case
+ * - Only the touched side is rescanned, and only if the touched price is
+ *   at or through its best; anything behind the top cannot move it
+ * - Inside apply_batch() the event is remembered only if the best moved,
+ *   so the batch's single record names the event a per-event record would
+ * - Record is built only when a sink is attached and a price changed
+ */
+void Orderbook::refresh_top(Side side, Price price, const Event& event)
+{
+	Price& best = (side == Side::Buy) ? best_bid_ : best_ask_;
+	const bool reaches_top = best == 0 || (side == Side::Buy ? price >= best : price <= best);
+	if (!reaches_top) return;
+
+	const Price old_bid = best_bid_;
+	const Price old_ask = best_ask_;
+
+	best = (side == Side::Buy) ? first_nonzero_price_bid() : first_nonzero_price_ask();
+
+	if (batch_) {
+		if (best != (side == Side::Buy ? old_bid : old_ask)) {
+			top_event_ = &event;
+			top_side_ = side;
+		}
+		return;
+	}
+	publish_top(old_bid, old_ask, side, event);
+}
+
+void Orderbook::publish_top(Price old_bid, Price old_ask, Side side, const Event& event)
+{
+	if (top_sink_ && (best_bid_ != old_bid || best_ask_ != old_ask)) {
+		TopOfBookChanged change;
+		change.timestamp = event.timestamp;
+		change.old_bid  = old_bid;
+		change.new_bid  = best_bid_;
+		change.old_ask  = old_ask;
+		change.new_ask  = best_ask_;
+		change.order_id = event.order_id;
+		change.cause    = event.type;
+		change.side     = side;
+		top_sink_->push_back(change);
+	}
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(log n) map lookup, only paid when a sink is attached
+ * - Looks the level up after cleanup so erased levels report as empty
+ */
+void Orderbook::publish_level(Side side, Price price, const Event& event)
+{
+	LevelDelta delta;
+	delta.timestamp = event.timestamp;
+	delta.side    = side;
+	delta.price   = price;
+
+	const PriceLevel* level = find_level(side, price);
+	if (level) {
+		delta.aggregate  = level->aggregate;
+		delta.num_orders = level->num_orders;
+	}
+	depth_sink_->push_back(delta);
+}
+
+void Orderbook::publish_queue(const Order& order, Quantity quantity, const Event& event)
+{
+	QueueChange change;
+	change.timestamp       = event.timestamp;
+	change.price           = order.price;
+	change.quantity        = quantity;
+	change.ranking_time    = order.ranking_time;
+	change.ranking_seq_num = order.ranking_seq_num;
+	change.cause           = event.type;
+	change.side            = order.side;
+	queue_sink_->push_back(change);
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) for changes behind a full window, O(K) otherwise,
+ *   plus one O(log n) tree lookup when a full window must be refilled
+ * - Called before erase_level_if_empty, so removed levels arrive as count 0
+ *   and the refill lookup cannot find them again
+ */
+void Orderbook::sync_level(Side side, Price price, Quantity aggregate, uint32_t num_orders)
+{
+	TopLevels& top = (side == Side::Buy) ? bid_top_ : ask_top_;
+	if (!top.update(price, aggregate, num_orders)) return;
+
+	LevelStats next;
+	if (side == Side::Buy) {
+		for (auto it = bids_.upper_bound(top.worst().price); it != bids_.end(); ++it) {
+			if (it->second.num_orders == 0) continue;   // the level being removed
+			next.price = it->first;
+			next.aggregate = it->second.aggregate;
+			next.num_orders = it->second.num_orders;
+			top.push_worst(next);
+			return;
+		}
+	} else {
+		for (auto it = asks_.upper_bound(top.worst().price); it != asks_.end(); ++it) {
+			if (it->second.num_orders == 0) continue;   // the level being removed
+			next.price = it->first;
+			next.aggregate = it->second.aggregate;
+			next.num_orders = it->second.num_orders;
+			top.push_worst(next);
+			return;
+		}
+	}
+}
+
+/**
+ * @details Implementation notes:
+ * - Inside the window: binary search for the cut, prefix sum for the total
+ * - Past a full window: the cached total plus a walk over deeper levels
+ */
+Quantity Orderbook::depth_to(Side side, Price limit) const
+{
+	const TopLevels& top = top_levels(side);
+	const size_t n = top.count_to(limit);
+	Quantity total = top.depth(n);
+	if (n < top.size() || !top.full()) return total;
+
+	if (side == Side::Buy) {
+		for (auto it = bids_.upper_bound(top.worst().price); it != bids_.end() && it->first >= limit; ++it) {
+			if (it->second.num_orders > 0) total += it->second.aggregate;
+		}
+	} else {
+		for (auto it = asks_.upper_bound(top.worst().price); it != asks_.end() && it->first <= limit; ++it) {
+			if (it->second.num_orders > 0) total += it->second.aggregate;
+		}
+	}
+	return total;
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) order lookup, O(log L) level lookup, O(log n)
+ *   prefix sum (O(n) once per level to build the index)
+ */
+bool Orderbook::queue_position(OrderId id, QueuePosition& out) const
+{
+	const auto hit = index_.find(id);
+	if (hit == index_.end()) return false;
+
+	const OrderHandle& handle = hit->second;
+	const PriceLevel& level = *handle.level;
+	if (!level.queue.built()) level.queue.build(level.fifo.begin(), level.fifo.end());
+
+	out.side = handle.side;
+	out.price = handle.price;
+	out.quantity = handle.it->quantity;
+	level.queue.ahead(handle.it->slot, out.quantity_ahead, out.orders_ahead);
+	return true;
+}
+
+BookMemory Orderbook::memory() const
+{
+	BookMemory m;
+	m.orders = order_mem_.use;
+	m.levels = level_mem_.use;
+	m.index  = index_mem_.use;
+	m.queues = queue_mem_.use;
+	m.total  = total_mem_;
+	return m;
+}
+
+double Orderbook::imbalance(size_t k) const
+{
+	const double bid = static_cast<double>(bid_top_.depth(k));
+	const double ask = static_cast<double>(ask_top_.depth(k));
+	return (bid + ask) > 0 ? (bid - ask) / (bid + ask) : 0.0;
+}
+
+/**
+ * @details Implementation notes:
+ * - Levels left with no orders count as absent
+ */
+const PriceLevel* Orderbook::find_level(Side side, Price price) const
+{
+	const PriceLevel* level = nullptr;
+	if (side == Side::Buy) {
+		auto it = bids_.find(price);
+		if (it != bids_.end()) level = &it->second;
+	} else {
+		auto it = asks_.find(price);
+		if (it != asks_.end()) level = &it->second;
+	}
+	return (level && level->num_orders > 0) ? level : nullptr;
 }
 
 /**
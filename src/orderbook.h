@@ -7,6 +7,12 @@
 
 
 #include "types/event.h"
+#include "types/top_of_book.h"
+#include "types/level_delta.h"
+#include "types/queue_change.h"
+#include "top_levels.h"
+#include "queue_index.h"
+#include "node_arena.h"
 
 /**
  * @brief Represents a single order in the order book
@@ -22,6 +28,7 @@ struct Order
 	Quantity 		quantity{};
 	RankingTime 	ranking_time{};
 	RankingSeqNum 	ranking_seq_num{};
+	mutable uint32_t slot{};         ///< Queue slot in its level's QueueIndex
 
     /**
      * @brief Constructs an order with all required fields
@@ -38,6 +45,9 @@ struct Order
       ranking_time(ranking_time), ranking_seq_num(ranking_seq_num) {}
 };
 
+/// FIFO of one price level; nodes are charged to the book's order account
+using OrderList = std::list<Order, ArenaAllocator<Order>>;
+
 /**
  * @brief Represents a price level containing multiple orders
  * 
@@ -49,7 +59,64 @@ struct PriceLevel
     Price price{};                   ///< Price for this level
     Quantity aggregate{};            ///< Total quantity at this level
     uint32_t num_orders{};           ///< Number of orders at this level
-    std::list<Order> fifo;           ///< Orders sorted by time/sequence (FIFO)
+    bool emptied{false};             ///< Queued for erasure at the end of apply_batch()
+    OrderList fifo;                  ///< Orders sorted by time/sequence (FIFO)
+    mutable QueueIndex queue;        ///< Queue-ahead sums, built on first query
+
+    PriceLevel() = default;
+
+    /**
+     * @brief Constructs an empty level whose allocations are accounted
+     * @param orders Account for the FIFO's nodes
+     * @param queues Account for the queue index arrays
+     */
+    PriceLevel(MemoryAccount* orders, MemoryAccount* queues)
+    : fifo(ArenaAllocator<Order>(orders)), queue(queues) {}
+};
+
+/**
+ * @brief Memory held by one book, per structure
+ *
+ * Bytes are what the containers requested (node and array sizes as
+ * allocated), independent of whether a NodeArena or the heap serves them.
+ */
+struct BookMemory
+{
+    MemoryUse orders;     ///< FIFO list nodes (one per resting order)
+    MemoryUse levels;     ///< Price tree nodes (one per level, both sides)
+    MemoryUse index;      ///< Order-id hash nodes and bucket arrays
+    MemoryUse queues;     ///< Queue-position Fenwick arrays
+    MemoryUse total;      ///< All of the above (peak is the book's true peak)
+};
+
+/**
+ * @brief Where an order stands in its level's FIFO
+ */
+struct QueuePosition
+{
+    Side     side = Side::Unknown;
+    Price    price = 0;
+    Quantity quantity = 0;           ///< The order's own remaining quantity
+    Quantity quantity_ahead = 0;     ///< Quantity of the orders in front of it
+    uint32_t orders_ahead = 0;       ///< Orders in front of it (0 = front of the queue)
+};
+
+/**
+ * @brief What one Orderbook::apply_batch() call changed
+ */
+struct BatchSummary
+{
+    size_t   events = 0;             ///< Events applied
+    int64_t  orders = 0;             ///< Net change in resting orders
+    uint32_t levels_created = 0;     ///< Levels inserted into the price tree
+    uint32_t levels_erased = 0;      ///< Levels erased at the end of the batch
+    uint32_t levels_revived = 0;     ///< Levels emptied, then refilled in the batch (erase + insert saved)
+    Price    old_bid = 0;            ///< Best bid before the batch
+    Price    new_bid = 0;            ///< Best bid after the batch
+    Price    old_ask = 0;            ///< Best ask before the batch
+    Price    new_ask = 0;            ///< Best ask after the batch
+
+    bool top_changed() const { return old_bid != new_bid || old_ask != new_ask; }
 };
 
 /**
@@ -62,7 +129,8 @@ struct OrderHandle
 {
     Side side{Side::Unknown};                    ///< Order side
     Price price{};                               ///< Order price
-    std::list<Order>::iterator it;               ///< Iterator to order in FIFO list
+    OrderList::iterator it;                      ///< Iterator to order in FIFO list
+    PriceLevel* level{nullptr};                  ///< Level holding the order (tree nodes never move)
 
     OrderHandle() = default;
     
@@ -71,9 +139,10 @@ struct OrderHandle
      * @param s Order side
      * @param p Order price
      * @param iter Iterator to order in FIFO list
+     * @param lvl Price level the order rests in
      */
-    OrderHandle(Side s, Price p, std::list<Order>::iterator iter)
-    : side(s), price(p), it(iter) {}
+    OrderHandle(Side s, Price p, OrderList::iterator iter, PriceLevel* lvl)
+    : side(s), price(p), it(iter), level(lvl) {}
 };
 
 /**
@@ -86,8 +155,19 @@ struct OrderHandle
 class Orderbook 
 {
 public: 
+    /// Events whose orders apply_batch() looks up before applying any of them
+    static constexpr size_t PREFETCH_WINDOW = 16;
+
     // Constructors and assignment
-    Orderbook() = default; 
+    Orderbook() : Orderbook(nullptr) {}
+
+    /**
+     * @brief Constructs a book whose nodes come from a pool
+     * @param arena Node pool shared by any number of books on this thread,
+     *              or nullptr for the heap; must outlive the book
+     */
+    explicit Orderbook(NodeArena* arena);
+
     Orderbook(const Orderbook&) = delete;                       ///< No copy constructor
     Orderbook& operator=(const Orderbook&) = delete;            ///< No copy assignment
     Orderbook(Orderbook&&) = delete;                            ///< No move constructor
@@ -101,11 +181,49 @@ public:
      * Routes the event to appropriate handler based on message type:
      * - OrderbookState: Updates trading state
      * - AddOrder: Adds new order to appropriate side
-     * - ExecuteOrder: Reduces order quantity or removes if fully executed
+     * - ExecuteOrder / ExecuteWithPrice: Reduces order quantity or removes if fully executed
+     * - ReplaceOrder: Changes price/quantity (priority kept only for a pure size reduction)
      * - DeleteOrder: Removes order from book
+     * - EquilibriumPrice: Records the auction's indicative price and volume
+     *
+     * Other types (reference data, trades, seconds) do not change the book.
      */
     void apply(const Event& event);
 
+    /**
+     * @brief Applies a batch of events (e.g. one nanosecond) as one update
+     * @param events First event
+     * @param count Number of events
+     * @return What the batch changed
+     *
+     * Leaves the book as apply() on each event in turn would, with two
+     * pieces of per-event work moved to the end of the batch:
+     * - Levels emptied by the batch are erased once at the end, so a level
+     *   emptied and refilled inside the batch (cancel/replace at the same
+     *   price) stays in the tree instead of being erased and re-inserted
+     * - The top sink receives at most one TopOfBookChanged, and none if the
+     *   batch left the top where it was. Its prices span batch start -> end;
+     *   timestamp, order_id, cause and side are those of the last event that
+     *   moved the best bid or ask
+     *
+     * Depth and queue sinks see the same records as with apply(). Events
+     * are taken in windows of PREFETCH_WINDOW: every event of a window is
+     * passed to prefetch() before the first one is applied, so the lookups'
+     * cache misses overlap instead of being taken one after the other.
+     */
+    BatchSummary apply_batch(const Event* events, size_t count);
+    BatchSummary apply_batch(const std::vector<Event>& events) { return apply_batch(events.data(), events.size()); }
+
+    /**
+     * @brief Hints that an event is about to be applied
+     * @param event Event applied soon
+     *
+     * For an execution, delete or replace, looks the order up and
+     * prefetches its FIFO node and its price level. Never changes the book;
+     * other event types are ignored.
+     */
+    void prefetch(const Event& event) const;
+
     // Trading state queries
     /**
      * @brief Checks if trading is currently open
@@ -124,7 +242,7 @@ public:
      * @brief Gets the best bid price (highest buy price)
      * @return Best bid price, or 0 if no bids
      */
-    Price best_bid_price() const { return first_nonzero_price_bid(); }
+    Price best_bid_price() const { return best_bid_; }
     
     /**
      * @brief Gets the quantity at best bid price
@@ -136,7 +254,7 @@ public:
      * @brief Gets the best ask price (lowest sell price)
      * @return Best ask price, or 0 if no asks
      */
-    Price best_ask_price() const { return first_nonzero_price_ask(); }
+    Price best_ask_price() const { return best_ask_; }
     
     /**
      * @brief Gets the quantity at best ask price
@@ -150,6 +268,18 @@ public:
      */
     Price last_exec_price() const { return last_exec_price_; }
 
+    /**
+     * @brief Gets the last auction equilibrium (indicative) price
+     * @return Equilibrium price, or 0 if none was published
+     */
+    Price equilibrium_price() const { return equilibrium_price_; }
+
+    /**
+     * @brief Gets the volume matched at the equilibrium price
+     * @return Smaller of the bid and ask volume at equilibrium
+     */
+    Quantity equilibrium_quantity() const { return equilibrium_quantity_; }
+
     /**
      * @brief Gets the total number of active orders
      * @return Number of orders in the book
@@ -176,15 +306,148 @@ public:
                     std::vector<std::pair<Price, Quantity>>& bids_out,
                     std::vector<std::pair<Price, Quantity>>& asks_out) const;
 
+    /**
+     * @brief Sets the destination for top-of-book change records
+     * @param sink Vector the book appends to, or nullptr to disable
+     *
+     * A TopOfBookChanged record is appended only when an applied event
+     * changes the best bid or best ask price. The consumer owns the vector
+     * and clears it after draining.
+     */
+    void set_top_sink(std::vector<TopOfBookChanged>* sink) { top_sink_ = sink; }
+
+    /**
+     * @brief Sets the destination for per-level depth deltas
+     * @param sink Vector the book appends to, or nullptr to disable
+     *
+     * One LevelDelta (side, price, new aggregate, new order count) is
+     * appended for every level an applied event touches, so consumers can
+     * maintain their own depth view instead of calling snapshot_n.
+     */
+    void set_depth_sink(std::vector<LevelDelta>* sink) { depth_sink_ = sink; }
+
+    /**
+     * @brief Sets the destination for queue-priority changes
+     * @param sink Vector the book appends to, or nullptr to disable
+     *
+     * One QueueChange is appended for every execution, deletion and
+     * replace, carrying the removed quantity and the order's priority
+     * before the event (see QueueFillSimulator).
+     */
+    void set_queue_sink(std::vector<QueueChange>* sink) { queue_sink_ = sink; }
+
+    /**
+     * @brief Looks up a price level without creating it
+     * @param side Level side
+     * @param price Level price
+     * @return The level, or nullptr if no order rests at that price
+     */
+    const PriceLevel* find_level(Side side, Price price) const;
+
+    // Depth queries over the best levels (no allocation, no tree walks)
+    /**
+     * @brief Visits the best k levels of one side, best first
+     * @param side Book side
+     * @param k Levels wanted (at most TopLevels::CAPACITY are kept)
+     * @param visit Called as visit(const LevelStats&) for each level
+     * @return Number of levels visited
+     */
+    template <typename F>
+    size_t visit_levels(Side side, size_t k, F&& visit) const
+    {
+        const TopLevels& top = top_levels(side);
+        const size_t n = k < top.size() ? k : top.size();
+        for (size_t i = 0; i < n; ++i) visit(top[i]);
+        return n;
+    }
+
+    /**
+     * @brief Total quantity over the best k levels of one side, O(1)
+     */
+    Quantity depth(Side side, size_t k) const { return top_levels(side).depth(k); }
+
+    /**
+     * @brief Total order count over the best k levels of one side, O(1)
+     */
+    uint64_t depth_orders(Side side, size_t k) const { return top_levels(side).orders(k); }
+
+    /**
+     * @brief Cumulative quantity at prices at least as good as a limit
+     * @param side Book side
+     * @param limit Worst price included (bids: >= limit, asks: <= limit)
+     * @return Quantity a marketable order up to limit would meet
+     *
+     * O(log K) when the limit falls inside the cached levels; a limit past
+     * the K-th level continues through the deeper levels.
+     */
+    Quantity depth_to(Side side, Price limit) const;
+
+    /**
+     * @brief Order book imbalance over the best k levels, O(1)
+     * @return (bid depth - ask depth) / (bid depth + ask depth), 0 if both empty
+     */
+    double imbalance(size_t k) const;
+
+    // Order-level (L3) queries
+    /**
+     * @brief Looks up an order's place in its price level's queue
+     * @param id Order id
+     * @param out Receives side, price, own quantity and what is ahead
+     * @return false if the order is not in the book
+     *
+     * O(log n): the level's QueueIndex is built on its first query (O(n))
+     * and maintained by every later add, execution, replace and delete.
+     */
+    bool queue_position(OrderId id, QueuePosition& out) const;
+
+    // Memory accounting
+    /**
+     * @brief Bytes, peak bytes and outstanding nodes per structure
+     */
+    BookMemory memory() const;
+
+    /**
+     * @brief The node pool backing this book, or nullptr for the heap
+     */
+    NodeArena* arena() const { return order_mem_.arena; }
+
 private: 
+    using LevelAllocator = ArenaAllocator<std::pair<const Price, PriceLevel>>;
+    using IndexAllocator = ArenaAllocator<std::pair<const OrderId, OrderHandle>>;
+
+    // Memory accounts (declared first: the containers below point into them)
+    MemoryUse     total_mem_;        ///< Sum over every account
+    MemoryAccount order_mem_;        ///< FIFO list nodes
+    MemoryAccount level_mem_;        ///< Price tree nodes
+    MemoryAccount index_mem_;        ///< Hash nodes and buckets
+    MemoryAccount queue_mem_;        ///< Queue index arrays
+
     // Data structures
-    std::map<Price, PriceLevel, std::greater<Price>> bids_;  ///< Bid side (price descending)
-    std::map<Price, PriceLevel, std::less<Price>> asks_;     ///< Ask side (price ascending)
-    std::unordered_map<OrderId, OrderHandle> index_;         ///< Order lookup by ID
+    std::map<Price, PriceLevel, std::greater<Price>, LevelAllocator> bids_;  ///< Bid side (price descending)
+    std::map<Price, PriceLevel, std::less<Price>, LevelAllocator> asks_;     ///< Ask side (price ascending)
+    std::unordered_map<OrderId, OrderHandle, std::hash<OrderId>,
+                       std::equal_to<OrderId>, IndexAllocator> index_;       ///< Order lookup by ID
 
     // State
     bool trading_open_{false};       ///< Trading state flag
     Price last_exec_price_{0};       ///< Last execution price
+    Price best_bid_{0};              ///< Cached best bid price (0 if none)
+    Price best_ask_{0};              ///< Cached best ask price (0 if none)
+    Price equilibrium_price_{0};     ///< Last auction equilibrium price
+    Quantity equilibrium_quantity_{0};   ///< Volume matched at equilibrium
+    TopLevels bid_top_{true};        ///< Best bid levels with prefix sums
+    TopLevels ask_top_{false};       ///< Best ask levels with prefix sums
+
+    // Batch state (apply_batch in progress)
+    BatchSummary* batch_{nullptr};                       ///< Summary being filled, nullptr outside a batch
+    std::vector<std::pair<Side, PriceLevel*>> emptied_;  ///< Levels emptied during the batch (each once)
+    const Event* top_event_{nullptr};                    ///< Last batch event that moved the top
+    Side top_side_{Side::Unknown};                       ///< Side that event touched
+
+    // Outputs
+    std::vector<TopOfBookChanged>* top_sink_{nullptr};  ///< BBO change records (optional)
+    std::vector<LevelDelta>* depth_sink_{nullptr};       ///< L2 level deltas (optional)
+    std::vector<QueueChange>* queue_sink_{nullptr};      ///< Queue-priority changes (optional)
 
     // Event handlers
     /**
@@ -211,6 +474,18 @@ private:
      */
     void handle_delete(const Event& event);
 
+    /**
+     * @brief Handles ReplaceOrder events
+     * @param event Replace event carrying the new price/quantity
+     */
+    void handle_replace(const Event& event);
+
+    /**
+     * @brief Handles EquilibriumPrice events
+     * @param event Equilibrium price update
+     */
+    void handle_equilibrium(const Event& event);
+
     // Utility methods
     /**
      * @brief Gets or creates a price level
@@ -224,8 +499,71 @@ private:
      * @brief Removes empty price levels
      * @param side Order side
      * @param price Price level to check
+     * @return true if the level was erased
      */
-    void erase_level_if_empty(Side side, Price price);
+    bool erase_level_if_empty(Side side, Price price);
+
+    /**
+     * @brief Retires a level a handler just took an order out of
+     * @param side Level side
+     * @param price Level price
+     * @param level The level itself
+     *
+     * Nothing to do while the level has orders (no tree lookup); an empty
+     * level is erased now, or at the end of the batch inside apply_batch().
+     */
+    void release_level(Side side, Price price, PriceLevel& level);
+
+    /**
+     * @brief Refreshes the cached best price of one side after a mutation
+     * @param side Side touched by the event
+     * @param price Touched price closest to the top (old or new price of a replace)
+     * @param event Event that caused the mutation
+     *
+     * Emits a TopOfBookChanged record when the best price moved; inside
+     * apply_batch() the record is left to the end of the batch.
+     */
+    void refresh_top(Side side, Price price, const Event& event);
+
+    /**
+     * @brief Appends a TopOfBookChanged to the top sink if the top moved
+     * @param old_bid Best bid before the change
+     * @param old_ask Best ask before the change
+     * @param side Side touched by the causing event
+     * @param event Event that caused the change
+     */
+    void publish_top(Price old_bid, Price old_ask, Side side, const Event& event);
+
+    /**
+     * @brief Appends the current state of one level to the depth sink
+     * @param side Level side
+     * @param price Level price
+     * @param event Event that touched the level
+     *
+     * Reports a removed (or order-less) level as aggregate 0, count 0.
+     */
+    void publish_level(Side side, Price price, const Event& event);
+
+    /**
+     * @brief Appends a quantity leaving an order's queue slot to the queue sink
+     * @param order Order before the event (priority and level)
+     * @param quantity Quantity removed from its slot
+     * @param event Event that caused the removal
+     */
+    void publish_queue(const Order& order, Quantity quantity, const Event& event);
+
+    /**
+     * @brief Reports a level's new state to the side's top-level cache
+     * @param side Level side
+     * @param price Level price
+     * @param aggregate New total quantity
+     * @param num_orders New order count (0 = level removed)
+     *
+     * Refills the cache from the price tree when a full window lost a level.
+     */
+    void sync_level(Side side, Price price, Quantity aggregate, uint32_t num_orders);
+
+    const TopLevels& top_levels(Side side) const { return side == Side::Buy ? bid_top_ : ask_top_; }
 
     // Helper methods for best bid/ask
     /**
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "types/usings.h"
+
+/**
+ * @brief Set of subscribed order book ids, checked once per message
+ *
+ * @details Exchange-assigned ids are dense and small (tens of thousands), so
+ * they live in a bitmap: contains() is one shift, one load and one mask.
+ * Ids at or above DENSE_LIMIT would make the bitmap too large and go to a
+ * sorted vector instead. An empty filter contains nothing.
+ */
+class OrderbookFilter
+{
+public:
+    static constexpr OrderbookId DENSE_LIMIT = 1u << 24;   ///< bitmap of at most 2 MB
+
+    OrderbookFilter() = default;
+
+    OrderbookFilter(std::initializer_list<OrderbookId> ids) {
+        for (OrderbookId id : ids) add(id);
+    }
+
+    /**
+     * @brief Subscribes an order book
+     * @param id Order book id (adding it twice is harmless)
+     */
+    void add(OrderbookId id) {
+        if (contains(id)) return;
+        if (id < DENSE_LIMIT) {
+            const size_t word = id >> 6;
+            if (word >= bits_.size()) bits_.resize(word + 1, 0);
+            bits_[word] |= uint64_t(1) << (id & 63);
+        } else {
+            sparse_.insert(std::lower_bound(sparse_.begin(), sparse_.end(), id), id);
+        }
+        ++count_;
+    }
+
+    /**
+     * @brief Whether messages for an order book should be decoded
+     */
+    bool contains(OrderbookId id) const {
+        const size_t word = id >> 6;
+        if (word < bits_.size()) return (bits_[word] >> (id & 63)) & 1;
+        return !sparse_.empty() && std::binary_search(sparse_.begin(), sparse_.end(), id);
+    }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    std::vector<uint64_t> bits_;         ///< One bit per id below DENSE_LIMIT
+    std::vector<OrderbookId> sparse_;    ///< Sorted ids at or above DENSE_LIMIT
+    size_t count_ = 0;
+};
@@ -0,0 +1,224 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "types/usings.h"
+#include "types/side.h"
+#include "util/endian.h"
+
+/**
+ * @brief OUCH-style binary order entry
+ *
+ * @details Every message travels in a frame of a 2-byte big-endian length
+ * followed by the type byte and a fixed body, as on a SoupBinTCP session.
+ * Order tokens are client-assigned numbers sent as 14 zero-padded ASCII
+ * digits. Only the fields the gateway and the stand-in exchange use are
+ * carried; all integers are big-endian.
+ *
+ * Client to exchange:
+ * - 'O' Enter Order: token, book, side, quantity, price, time in force
+ * - 'X' Cancel Order: token
+ * Exchange to client:
+ * - 'A' Accepted: timestamp, token, book, side, order id, quantity, price
+ * - 'E' Executed: timestamp, token, book, quantity, price, match id
+ * - 'C' Canceled: timestamp, token, book, side, quantity, reason
+ * - 'J' Rejected: timestamp, token, reason
+ */
+namespace ouch
+{
+    constexpr size_t LENGTH_SIZE = 2;       ///< Frame length prefix
+    constexpr size_t TOKEN_SIZE  = 14;      ///< Order token digits
+
+    enum class Type : char
+    {
+        EnterOrder  = 'O',
+        CancelOrder = 'X',
+        Accepted    = 'A',
+        Executed    = 'E',
+        Canceled    = 'C',
+        Rejected    = 'J',
+        Unknown     = 0
+    };
+
+    /// Message size including the type byte (0 for unknown types)
+    inline size_t message_size(Type type) noexcept
+    {
+        switch (type) {
+        case Type::EnterOrder:  return 1 + TOKEN_SIZE + 4 + 1 + 8 + 4 + 1;
+        case Type::CancelOrder: return 1 + TOKEN_SIZE;
+        case Type::Accepted:    return 1 + 8 + TOKEN_SIZE + 4 + 1 + 8 + 8 + 4;
+        case Type::Executed:    return 1 + 8 + TOKEN_SIZE + 4 + 8 + 4 + 8;
+        case Type::Canceled:    return 1 + 8 + TOKEN_SIZE + 4 + 1 + 8 + 1;
+        case Type::Rejected:    return 1 + 8 + TOKEN_SIZE + 4;
+        case Type::Unknown:     break;
+        }
+        return 0;
+    }
+
+    /// Largest framed message
+    constexpr size_t MAX_FRAME = LENGTH_SIZE + 1 + 8 + TOKEN_SIZE + 4 + 1 + 8 + 8 + 4;
+
+    /**
+     * @brief Any order-entry message; fields a type does not carry stay zero
+     */
+    struct Message
+    {
+        Type      type = Type::Unknown;
+        uint64_t  timestamp = 0;        ///< Exchange time (outbound messages)
+        uint64_t  token = 0;            ///< Client order token
+        OrderbookId book = 0;
+        Side      side = Side::Unknown;
+        Quantity  quantity = 0;         ///< Order / executed / canceled quantity
+        Price     price = 0;
+        uint64_t  order_id = 0;         ///< Exchange order id (Accepted)
+        uint64_t  match_id = 0;         ///< Trade id (Executed)
+        uint32_t  reason = 0;           ///< Cancel / reject reason code
+        char      time_in_force = 0;    ///< 0 = day
+    };
+
+    inline void write_token(char* p, uint64_t token) noexcept
+    {
+        for (size_t i = TOKEN_SIZE; i-- > 0; token /= 10) p[i] = static_cast<char>('0' + token % 10);
+    }
+
+    inline uint64_t read_token(const char* p) noexcept
+    {
+        uint64_t token = 0;
+        for (size_t i = 0; i < TOKEN_SIZE; ++i) {
+            if (p[i] >= '0' && p[i] <= '9') token = token * 10 + static_cast<uint64_t>(p[i] - '0');
+        }
+        return token;
+    }
+
+    inline char side_code(Side s) noexcept { return s == Side::Buy ? 'B' : (s == Side::Sell ? 'S' : ' '); }
+    inline Side parse_side(char c) noexcept { return c == 'B' ? Side::Buy : (c == 'S' ? Side::Sell : Side::Unknown); }
+
+    /**
+     * @brief Writes one framed message
+     * @param p Destination (must have room for MAX_FRAME bytes)
+     * @param m Message to encode
+     * @return Bytes written (0 for an unknown type)
+     */
+    inline size_t encode(char* p, const Message& m) noexcept
+    {
+        const size_t size = message_size(m.type);
+        if (size == 0) return 0;
+        endian::write_u16_be(p, static_cast<uint16_t>(size));
+        char* q = p + LENGTH_SIZE;
+        *q++ = static_cast<char>(m.type);
+        switch (m.type) {
+        case Type::EnterOrder:
+            write_token(q, m.token);                       q += TOKEN_SIZE;
+            endian::write_u32_be(q, m.book);               q += 4;
+            *q++ = side_code(m.side);
+            endian::write_u64_be(q, m.quantity);           q += 8;
+            endian::write_u32_be(q, m.price);              q += 4;
+            *q++ = m.time_in_force;
+            break;
+        case Type::CancelOrder:
+            write_token(q, m.token);
+            break;
+        case Type::Accepted:
+            endian::write_u64_be(q, m.timestamp);          q += 8;
+            write_token(q, m.token);                       q += TOKEN_SIZE;
+            endian::write_u32_be(q, m.book);               q += 4;
+            *q++ = side_code(m.side);
+            endian::write_u64_be(q, m.order_id);           q += 8;
+            endian::write_u64_be(q, m.quantity);           q += 8;
+            endian::write_u32_be(q, m.price);
+            break;
+        case Type::Executed:
+            endian::write_u64_be(q, m.timestamp);          q += 8;
+            write_token(q, m.token);                       q += TOKEN_SIZE;
+            endian::write_u32_be(q, m.book);               q += 4;
+            endian::write_u64_be(q, m.quantity);           q += 8;
+            endian::write_u32_be(q, m.price);              q += 4;
+            endian::write_u64_be(q, m.match_id);
+            break;
+        case Type::Canceled:
+            endian::write_u64_be(q, m.timestamp);          q += 8;
+            write_token(q, m.token);                       q += TOKEN_SIZE;
+            endian::write_u32_be(q, m.book);               q += 4;
+            *q++ = side_code(m.side);
+            endian::write_u64_be(q, m.quantity);           q += 8;
+            *q = static_cast<char>(m.reason);
+            break;
+        case Type::Rejected:
+            endian::write_u64_be(q, m.timestamp);          q += 8;
+            write_token(q, m.token);                       q += TOKEN_SIZE;
+            endian::write_u32_be(q, m.reason);
+            break;
+        case Type::Unknown:
+            break;
+        }
+        return LENGTH_SIZE + size;
+    }
+
+    /**
+     * @brief Reads one framed message from a byte stream
+     * @param p Stream position
+     * @param len Bytes available
+     * @param m Destination message (type Unknown for unrecognised types)
+     * @return Bytes consumed, 0 if the frame is not complete yet
+     */
+    inline size_t decode(const char* p, size_t len, Message& m) noexcept
+    {
+        if (len < LENGTH_SIZE) return 0;
+        const size_t size = endian::read_u16_be(p);
+        if (len < LENGTH_SIZE + size) return 0;
+        m = Message();
+        if (size == 0) return LENGTH_SIZE;
+
+        const char* q = p + LENGTH_SIZE;
+        const Type type = static_cast<Type>(*q++);
+        if (message_size(type) != size) return LENGTH_SIZE + size;   // skipped as Unknown
+        m.type = type;
+        switch (type) {
+        case Type::EnterOrder:
+            m.token = read_token(q);                       q += TOKEN_SIZE;
+            m.book = endian::read_u32_be(q);               q += 4;
+            m.side = parse_side(*q++);
+            m.quantity = endian::read_u64_be(q);           q += 8;
+            m.price = endian::read_u32_be(q);              q += 4;
+            m.time_in_force = *q;
+            break;
+        case Type::CancelOrder:
+            m.token = read_token(q);
+            break;
+        case Type::Accepted:
+            m.timestamp = endian::read_u64_be(q);          q += 8;
+            m.token = read_token(q);                       q += TOKEN_SIZE;
+            m.book = endian::read_u32_be(q);               q += 4;
+            m.side = parse_side(*q++);
+            m.order_id = endian::read_u64_be(q);           q += 8;
+            m.quantity = endian::read_u64_be(q);           q += 8;
+            m.price = endian::read_u32_be(q);
+            break;
+        case Type::Executed:
+            m.timestamp = endian::read_u64_be(q);          q += 8;
+            m.token = read_token(q);                       q += TOKEN_SIZE;
+            m.book = endian::read_u32_be(q);               q += 4;
+            m.quantity = endian::read_u64_be(q);           q += 8;
+            m.price = endian::read_u32_be(q);              q += 4;
+            m.match_id = endian::read_u64_be(q);
+            break;
+        case Type::Canceled:
+            m.timestamp = endian::read_u64_be(q);          q += 8;
+            m.token = read_token(q);                       q += TOKEN_SIZE;
+            m.book = endian::read_u32_be(q);               q += 4;
+            m.side = parse_side(*q++);
+            m.quantity = endian::read_u64_be(q);           q += 8;
+            m.reason = static_cast<uint8_t>(*q);
+            break;
+        case Type::Rejected:
+            m.timestamp = endian::read_u64_be(q);          q += 8;
+            m.token = read_token(q);                       q += TOKEN_SIZE;
+            m.reason = endian::read_u32_be(q);
+            break;
+        case Type::Unknown:
+            break;
+        }
+        return LENGTH_SIZE + size;
+    }
+}
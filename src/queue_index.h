@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "types/usings.h"
+#include "node_arena.h"
+
+/**
+ * @brief Prefix sums of quantity and order count over one level's FIFO
+ *
+ * @details Fenwick (binary indexed) tree over queue slots: every order of
+ * the level holds a slot, slots increase from the front of the queue to
+ * the back, and a removed order simply leaves its slot at zero. Quantity
+ * and order count ahead of a slot are then O(log n) prefix sums.
+ *
+ * The index is built lazily, the first time a level is queried, and kept
+ * up to date afterwards; levels nobody asks about pay one branch per
+ * update. Appends take the next free slot; anything the slot order cannot
+ * express (an insertion mid-queue, running out of slots) just drops the
+ * index so the next query rebuilds it compactly in O(n).
+ */
+class QueueIndex
+{
+public:
+    QueueIndex() = default;
+
+    /**
+     * @param account Where the tree's arrays are charged (see Orderbook::memory)
+     */
+    explicit QueueIndex(MemoryAccount* account)
+        : qty_(ArenaAllocator<Quantity>(account)), count_(ArenaAllocator<uint32_t>(account)) {}
+
+    bool built() const { return !qty_.empty(); }
+
+    void invalidate()
+    {
+        qty_.clear();
+        qty_.shrink_to_fit();
+        count_.clear();
+        count_.shrink_to_fit();
+        next_ = 0;
+    }
+
+    /**
+     * @brief Numbers the queue front to back and builds the sums, O(n)
+     * @param first Front of the queue (elements expose slot and quantity)
+     * @param last End of the queue
+     */
+    template <typename It>
+    void build(It first, It last)
+    {
+        size_t n = 0;
+        for (It it = first; it != last; ++it) ++n;
+        size_t size = 16;
+        while (size < 2 * n + 16) size <<= 1;          // room to append before a rebuild
+        qty_.assign(size + 1, 0);
+        count_.assign(size + 1, 0);
+        next_ = 0;
+        for (It it = first; it != last; ++it) {
+            it->slot = next_++;
+            qty_[it->slot + 1] = it->quantity;
+            count_[it->slot + 1] = 1;
+        }
+        for (size_t i = 1; i <= size; ++i) {            // linear-time Fenwick construction
+            const size_t j = i + (i & (~i + 1));
+            if (j <= size) {
+                qty_[j] += qty_[i];
+                count_[j] += count_[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Gives an order joining the back of the queue the next slot
+     * @param slot Receives the slot
+     * @param quantity The order's quantity
+     */
+    void append(uint32_t& slot, Quantity quantity)
+    {
+        if (!built()) return;
+        if (next_ + 1 >= qty_.size()) {
+            invalidate();
+            return;
+        }
+        slot = next_++;
+        update(slot, quantity, 1);
+    }
+
+    /**
+     * @brief Takes quantity (and, if it leaves, the order) out of a slot
+     */
+    void remove(uint32_t slot, Quantity quantity, bool leaves)
+    {
+        if (!built()) return;
+        update(slot, ~quantity + 1, leaves ? ~0u : 0u);   // modular negation
+    }
+
+    /**
+     * @brief Quantity and orders in the slots before slot, O(log n)
+     */
+    void ahead(uint32_t slot, Quantity& quantity, uint32_t& orders) const
+    {
+        quantity = 0;
+        orders = 0;
+        for (size_t i = slot; i > 0; i -= i & (~i + 1)) {
+            quantity += qty_[i];
+            orders += count_[i];
+        }
+    }
+
+private:
+    std::vector<Quantity, ArenaAllocator<Quantity>> qty_;      ///< 1-based Fenwick tree of quantities
+    std::vector<uint32_t, ArenaAllocator<uint32_t>> count_;    ///< 1-based Fenwick tree of order counts
+    uint32_t next_ = 0;              ///< Next free slot
+
+    void update(uint32_t slot, Quantity quantity, uint32_t orders)
+    {
+        for (size_t i = slot + 1; i < qty_.size(); i += i & (~i + 1)) {
+            qty_[i] += quantity;
+            count_[i] += orders;
+        }
+    }
+};
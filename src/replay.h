@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fill_simulator.h"
+#include "itch_parser.h"
+#include "latency_model.h"
+#include "orderbook.h"
+#include "types/event.h"
+
+/**
+ * @brief Counters returned by a single-day replay
+ */
+struct ReplayStats
+{
+    size_t   msgs = 0;             ///< Events applied for the target book
+    size_t   batches = 0;          ///< Nanosecond batches handed to the strategy
+    uint64_t last_ns = 0;          ///< Timestamp of the last batch
+    bool     seen_open = false;    ///< Continuous trading was observed
+    bool     reached_eod = false;  ///< Market close state was observed
+};
+
+namespace detail
+{
+    /// Default replay_loop advance hook: nothing to do between batches
+    struct NoAdvance {
+        void operator()(uint64_t) const {}
+    };
+
+    /**
+     * @brief Shared replay loop: filtering, ns batching and EOD detection
+     * @param source Packet source with good() and next_packet() (a
+     *        file-backed ItchParser or a live UdpFeed)
+     * @param on_batch Callable(ns, batch, closing) run between the observer's
+     *        before_batch/after_batch hooks; closing is true for the batch
+     *        that carries the market close state
+     * @param on_advance Callable(ns) run before the first event of each
+     *        batch is applied, while the book still holds only earlier events
+     */
+    template <typename Source, typename Observer, typename OnBatch, typename OnAdvance = NoAdvance>
+    ReplayStats replay_loop(Source& source,
+                            OrderbookId target_book,
+                            Orderbook& book,
+                            Observer& obs,
+                            OnBatch on_batch,
+                            OnAdvance on_advance = OnAdvance())
+    {
+        ReplayStats stats;
+
+        // ns-batching state
+        uint64_t cur_ns = 0;
+        bool have_batch = false;
+        std::vector<Event> ns_batch;
+        ns_batch.reserve(64);
+
+        auto flush_batch = [&](uint64_t ns, bool closing){
+            if (!have_batch) return;
+
+            // the whole nanosecond goes into the book at once
+            book.apply_batch(ns_batch);
+
+            ++stats.batches;
+            obs.before_batch(ns, ns_batch);
+
+            // run strategy after the book has all events for this ns
+            on_batch(ns, ns_batch, closing);
+
+            obs.after_batch(ns, book);
+
+            ns_batch.clear();
+            have_batch = false;
+        };
+
+        while (source.good()) {
+            auto events = source.next_packet();
+            if (events.empty()) continue;
+
+            for (const auto& ev : events) {
+                if (ev.orderbook_id != target_book) continue;
+
+                if (ev.type == MessageType::OrderbookState) {
+                    obs.on_state(ev);
+
+                    // detect continuous trading open
+                    if (!stats.seen_open && ev.orderbook_state == "P_SUREKLI_ISLEM") {
+                        stats.seen_open = true;
+                        obs.on_day_start();
+                    }
+                }
+
+                // ns boundary handling (full timestamp: same offset in another second is a new batch)
+                if (!have_batch) { cur_ns = ev.timestamp; have_batch = true; on_advance(cur_ns); }
+                else if (ev.timestamp != cur_ns) {
+                    flush_batch(cur_ns, false);
+                    cur_ns = ev.timestamp;
+                    have_batch = true;
+                    on_advance(cur_ns);
+                }
+
+                // collect into this ns batch; applied in tape order when it closes
+                ns_batch.push_back(ev);
+                ++stats.msgs;
+
+                // Check for EOD after adding to batch
+                if (ev.type == MessageType::OrderbookState &&
+                    ev.orderbook_state == "P_MARJ_YAYIN_KAPANIS") {
+                    obs.on_day_end();
+                    flush_batch(cur_ns, true);
+                    stats.reached_eod = true;
+                    stats.last_ns = cur_ns;
+                    return stats;
+                }
+            }
+        }
+
+        // flush final batch
+        flush_batch(cur_ns, false);
+        stats.last_ns = cur_ns;
+        return stats;
+    }
+}
+
+/**
+ * @brief Replays one capture through the book and strategy in ns batches
+ * @param source Parser positioned at the start of the capture, or a live UdpFeed
+ * @param target_book Only events for this order book are applied
+ * @param book Order book to build
+ * @param strat Strategy driven after each nanosecond batch (on_batch)
+ * @param obs Observer policy receiving diagnostic hooks
+ * @return Replay counters
+ *
+ * @details Events are collected per nanosecond and applied to the book in
+ * tape order with Orderbook::apply_batch() when the batch closes; the
+ * strategy sees each batch once the book holds all of its events. Stops
+ * after the batch containing the market close state.
+ *
+ * All output goes through the Observer policy. Its hooks are resolved at
+ * compile time, so NullObserver/QuietObserver instantiations carry no
+ * per-event or per-batch diagnostic checks.
+ */
+template <typename StrategyT, typename Observer, typename Source>
+ReplayStats replay_day(Source& source,
+                       OrderbookId target_book,
+                       Orderbook& book,
+                       StrategyT& strat,
+                       Observer& obs)
+{
+    return detail::replay_loop(source, target_book, book, obs,
+        [&](uint64_t ns, const std::vector<Event>& batch, bool) {
+            strat.on_batch(ns, book, batch);
+        });
+}
+
+/**
+ * @brief Replays one capture driving the strategy from top-of-book changes
+ * @param source Parser positioned at the start of the capture, or a live UdpFeed
+ * @param target_book Only events for this order book are applied
+ * @param book Order book to build (its top sink is used during the replay)
+ * @param strat Strategy exposing on_top_change() and end_of_day()
+ * @param obs Observer policy receiving diagnostic hooks
+ * @param sim Optional queue-position fill simulator bound to book (its
+ *        queue sink is used during the replay); nullptr = instant fills
+ * @param latency Optional queue delaying the strategy's orders; nullptr =
+ *        orders act in the decision batch
+ * @return Replay counters
+ *
+ * @details Same batching as replay_day(), but the strategy is only called
+ * for batches that left the best bid/ask somewhere else (or flipped the
+ * trading state), with the batch's net TopOfBookChanged (apply_batch
+ * publishes at most one; a top that moves and comes back within the
+ * nanosecond publishes none). The close batch calls
+ * end_of_day(). Produces the same trades as replay_day() with on_batch.
+ *
+ * With a simulator, every batch first advances the virtual queues by the
+ * batch's queue changes and hands the resulting fills to strat.on_fill()
+ * before the strategy sees the new top; fills of orders placed by that
+ * evaluation (marketable ones) are delivered right after it.
+ *
+ * With a latency queue, orders whose arrival time is at or before the next
+ * batch are handed to strat.on_arrival() before that batch is applied, so
+ * they meet the book exactly as it stood at arrival. Orders still in flight
+ * at the close are dropped.
+ */
+template <typename StrategyT, typename Observer, typename Source>
+ReplayStats replay_day_top_driven(Source& source,
+                                  OrderbookId target_book,
+                                  Orderbook& book,
+                                  StrategyT& strat,
+                                  Observer& obs,
+                                  QueueFillSimulator* sim = nullptr,
+                                  LatencyQueue* latency = nullptr)
+{
+    std::vector<TopOfBookChanged> changes;
+    changes.reserve(16);
+    book.set_top_sink(&changes);
+    bool was_open = book.trading_open();
+
+    std::vector<QueueChange> queue;
+    if (sim) {
+        queue.reserve(16);
+        book.set_queue_sink(&queue);
+    }
+    auto deliver_fills = [&]() {
+        for (const VirtualFill& f : sim->fills()) strat.on_fill(f);
+        sim->clear_fills();
+    };
+
+    const ReplayStats stats = detail::replay_loop(source, target_book, book, obs,
+        [&](uint64_t ns, const std::vector<Event>&, bool closing) {
+            if (sim) {
+                sim->apply(queue);
+                queue.clear();
+                deliver_fills();
+            }
+            if (closing) {
+                strat.end_of_day(book);
+            } else if (!changes.empty() || book.trading_open() != was_open) {
+                // net change of the batch: first old -> last new
+                TopOfBookChanged net;
+                if (changes.empty()) {
+                    net.cause   = MessageType::OrderbookState;
+                    net.old_bid = net.new_bid = book.best_bid_price();
+                    net.old_ask = net.new_ask = book.best_ask_price();
+                } else {
+                    net = changes.back();
+                    net.old_bid = changes.front().old_bid;
+                    net.old_ask = changes.front().old_ask;
+                }
+                net.timestamp = ns;
+                strat.on_top_change(ns, book, net);
+                if (sim) deliver_fills();
+            }
+            was_open = book.trading_open();
+            changes.clear();
+            if (closing && latency) latency->clear();
+        },
+        [&](uint64_t ns) {
+            if (!latency) return;
+            latency->release(ns, [&](const DelayedOrder& order) { strat.on_arrival(order, book); });
+            if (sim) deliver_fills();
+        });
+
+    book.set_top_sink(nullptr);
+    if (sim) book.set_queue_sink(nullptr);
+    return stats;
+}
@@ -0,0 +1,90 @@
+#include "replay_observers.h"
+#include <iostream>
+
+void print_event(const Event& ev) {
+    std::cout << "[MSG] ns=" << ev.nanosec << " type=";
+    switch (ev.type) {
+        case MessageType::OrderbookState:
+            std::cout << "STATE book=" << ev.orderbook_id
+                      << " state=" << ev.orderbook_state; break;
+        case MessageType::AddOrder:
+            std::cout << "ADD id=" << ev.order_id
+                      << " side=" << (ev.side == Side::Buy ? "B" : "S")
+                      << " qty=" << ev.quantity
+                      << " px=" << ev.price; break;
+        case MessageType::ExecuteOrder:
+            std::cout << "EXEC id=" << ev.order_id
+                      << " side=" << (ev.side == Side::Buy ? "B" : "S")
+                      << " qty=" << ev.quantity; break; // exec has no price in spec
+        case MessageType::DeleteOrder:
+            std::cout << "DEL id=" << ev.order_id
+                      << " side=" << (ev.side == Side::Buy ? "B" : "S"); break;
+        case MessageType::ExecuteWithPrice:
+            std::cout << "EXEC id=" << ev.order_id
+                      << " side=" << (ev.side == Side::Buy ? "B" : "S")
+                      << " qty=" << ev.quantity
+                      << " px=" << ev.price
+                      << (ev.at_cross ? " cross" : ""); break;
+        case MessageType::ReplaceOrder:
+            std::cout << "REPLACE id=" << ev.order_id
+                      << " side=" << (ev.side == Side::Buy ? "B" : "S")
+                      << " qty=" << ev.quantity
+                      << " px=" << ev.price; break;
+        case MessageType::Trade:
+            std::cout << "TRADE match=" << ev.match_id
+                      << " qty=" << ev.quantity
+                      << " px=" << ev.price; break;
+        case MessageType::EquilibriumPrice:
+            std::cout << "EQUILIBRIUM px=" << ev.price
+                      << " bid_qty=" << ev.quantity
+                      << " ask_qty=" << ev.ask_quantity; break;
+        default: std::cout << "OTHER"; break;
+    }
+    std::cout << "\n";
+}
+
+void print_topN(const Orderbook& ob, size_t N, uint64_t ns, int64_t book_id) {
+    std::vector<std::pair<Price, Quantity>> bids, asks;
+    ob.snapshot_n(N, bids, asks);
+
+    std::cout << "---- SNAPSHOT"
+              << " ns=" << ns
+              << " book=" << (book_id >= 0 ? book_id : -1)
+              << " open=" << (ob.trading_open() ? "Y" : "N")
+              << " ----\n";
+
+    std::cout << "BIDS (price, qty):\n";
+    for (size_t i = 0; i < bids.size(); ++i)
+        std::cout << "  [" << i << "] " << bids[i].first << ", " << bids[i].second << "\n";
+    if (bids.empty()) std::cout << "  (none)\n";
+
+    std::cout << "ASKS (price, qty):\n";
+    for (size_t i = 0; i < asks.size(); ++i)
+        std::cout << "  [" << i << "] " << asks[i].first << ", " << asks[i].second << "\n";
+    if (asks.empty()) std::cout << "  (none)\n";
+
+    if (ob.has_top()) {
+        std::cout << "BEST: bid " << ob.best_bid_price() << " x " << ob.best_bid_quantity()
+                  << " | ask " << ob.best_ask_price() << " x " << ob.best_ask_quantity()
+                  << "\n";
+    }
+    std::cout << "------------------------------\n";
+}
+
+void QuietObserver::on_day_start() {
+    std::cout << "[DAY START] Continuous trading begins.\n";
+}
+
+void QuietObserver::on_day_end() {
+    std::cout << "[DAY END] Market closed.\n";
+}
+
+void VerboseObserver::on_state(const Event& ev) {
+    std::cerr << "[STATE] ns=" << ev.nanosec
+              << " state=" << ev.orderbook_state << "\n";
+}
+
+void VerboseObserver::before_batch(uint64_t ns, const std::vector<Event>& batch) {
+    std::cout << "\n=== BATCH ns=" << ns << " (" << batch.size() << " events) ===\n";
+    for (const auto& ev : batch) print_event(ev);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "orderbook.h"
+#include "shm_book.h"
+#include "types/event.h"
+
+/**
+ * @brief Diagnostic printers shared by the replay observers
+ *
+ * @details Kept out of line so that observers which never call them
+ * (NullObserver, QuietObserver) do not pull any formatting code into the
+ * replay loop.
+ */
+void print_event(const Event& ev);
+void print_topN(const Orderbook& ob, size_t N, uint64_t ns = 0, int64_t book_id = -1);
+
+/**
+ * @brief Observer policy that prints nothing at all
+ *
+ * @details Every hook is an empty inline function, so a replay instantiated
+ * with this policy contains no diagnostic code in the batch loop.
+ * Used by batch/backtest drivers that only consume the final statistics.
+ */
+struct NullObserver
+{
+    void on_day_start() {}
+    void on_day_end() {}
+    void on_state(const Event&) {}
+    void before_batch(uint64_t, const std::vector<Event>&) {}
+    void after_batch(uint64_t, const Orderbook&) {}
+    void on_finish(uint64_t, const Orderbook&) {}
+};
+
+/**
+ * @brief Observer policy for --quiet runs
+ *
+ * @details Only reports the continuous trading open and the market close;
+ * all per-batch hooks are empty inline functions.
+ */
+struct QuietObserver : NullObserver
+{
+    void on_day_start();
+    void on_day_end();
+};
+
+/**
+ * @brief Observer policy for full diagnostic runs
+ *
+ * @details Prints every state message, every event of every batch and a
+ * top-N snapshot after each batch. Dominates runtime; meant for debugging.
+ */
+struct VerboseObserver : QuietObserver
+{
+    OrderbookId book_id;    ///< Book id shown in snapshot headers
+    size_t      depth;      ///< Levels per side printed after each batch
+
+    explicit VerboseObserver(OrderbookId book, size_t levels = 3)
+    : book_id(book), depth(levels) {}
+
+    void on_state(const Event& ev);
+    void before_batch(uint64_t ns, const std::vector<Event>& batch);
+    void after_batch(uint64_t ns, const Orderbook& ob) { print_topN(ob, depth, ns, book_id); }
+    void on_finish(uint64_t ns, const Orderbook& ob) { print_topN(ob, 5, ns, book_id); }
+};
+
+/**
+ * @brief Observer policy printing a top-N snapshot every Nth batch
+ *
+ * @details Cheap enough to leave on for long replays: the only per-batch
+ * cost is a counter increment and compare.
+ */
+struct SampledSnapshotObserver : QuietObserver
+{
+    OrderbookId book_id;    ///< Book id shown in snapshot headers
+    size_t      every;      ///< Sampling period in batches (0 disables sampling)
+    size_t      depth;      ///< Levels per side printed per sample
+    size_t      seen = 0;   ///< Batches observed so far
+
+    SampledSnapshotObserver(OrderbookId book, size_t period, size_t levels = 3)
+    : book_id(book), every(period), depth(levels) {}
+
+    void after_batch(uint64_t ns, const Orderbook& ob) {
+        if (every != 0 && ++seen == every) {
+            seen = 0;
+            print_topN(ob, depth, ns, book_id);
+        }
+    }
+};
+
+/**
+ * @brief Observer policy publishing the book to shared memory after each batch
+ *
+ * @details Sibling processes (risk, monitoring, UI) read the published
+ * BBO/depth through ShmBookReader without touching the replay process.
+ * Output is otherwise the same as QuietObserver.
+ */
+struct ShmPublishObserver : QuietObserver
+{
+    ShmBookPublisher* publisher;    ///< Region to write into (not owned)
+    OrderbookId       book_id;      ///< Book id the slot is published under
+
+    ShmPublishObserver(ShmBookPublisher& pub, OrderbookId book)
+    : publisher(&pub), book_id(book) {}
+
+    void after_batch(uint64_t ns, const Orderbook& ob) { publisher->publish(book_id, ob, ns); }
+};
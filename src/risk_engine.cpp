@@ -0,0 +1,164 @@
+#include "risk_engine.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    constexpr int64_t BPS = 10000;   ///< Basis points per unit
+
+    /// Largest absolute position reachable if every working order fills
+    int64_t worst_exposure(Position position, Quantity open_buy, Quantity open_sell) {
+        const int64_t longest  = position + static_cast<int64_t>(open_buy);
+        const int64_t shortest = position - static_cast<int64_t>(open_sell);
+        return std::max<int64_t>(std::max<int64_t>(longest, -shortest), 0);
+    }
+}
+
+const char* to_string(RiskCheck check)
+{
+    switch (check) {
+    case RiskCheck::Ok:                 return "ok";
+    case RiskCheck::UnknownInstrument:  return "unknown_instrument";
+    case RiskCheck::PriceBand:          return "price_band";
+    case RiskCheck::PositionLimit:      return "position_limit";
+    case RiskCheck::InstrumentNotional: return "instrument_notional";
+    case RiskCheck::PortfolioNotional:  return "portfolio_notional";
+    case RiskCheck::OrderRate:          return "order_rate";
+    case RiskCheck::Count_:             break;
+    }
+    return "?";
+}
+
+/**
+ * @details Implementation notes:
+ * - Re-registering keeps the position and working orders, so limits can
+ *   be tightened intraday
+ * - The rate bucket starts full
+ */
+uint32_t RiskEngine::add_instrument(OrderbookId book, const InstrumentLimits& limits)
+{
+    if (limits.max_position < limits.min_position) {
+        std::cerr << "[ERROR] RiskEngine: book " << book << " has max_position < min_position\n";
+    }
+    auto it = slots_.find(book);
+    if (it == slots_.end()) {
+        it = slots_.emplace(book, static_cast<uint32_t>(instruments_.size())).first;
+        instruments_.push_back(Instrument());
+        instruments_.back().book = book;
+    }
+    Instrument& in = instruments_[it->second];
+    in.limits = limits;
+    if (limits.rate_window_ns == 0) in.limits.rate_window_ns = 1;
+    in.tokens = static_cast<uint64_t>(in.limits.max_orders) * in.limits.rate_window_ns;
+    return it->second;
+}
+
+uint32_t RiskEngine::slot(OrderbookId book) const
+{
+    const auto it = slots_.find(book);
+    return it == slots_.end() ? NO_SLOT : it->second;
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1)
+ * - Cheapest checks first; the rate token is only taken by accepted orders
+ */
+RiskCheck RiskEngine::submit(uint32_t slot, Side side, Price price, Quantity quantity, Timestamp now)
+{
+    ++checks_;
+    RiskCheck result = RiskCheck::UnknownInstrument;
+    if (slot < instruments_.size()) {
+        Instrument& in = instruments_[slot];
+        result = check(in, side, price, quantity, now);
+        if (result == RiskCheck::Ok) {
+            (side == Side::Buy ? in.open_buy : in.open_sell) += quantity;
+            if (in.price == 0) in.price = price;
+            if (in.limits.max_orders != 0) in.tokens -= in.limits.rate_window_ns;
+            refresh(in);
+        }
+    }
+    ++outcomes_[static_cast<size_t>(result)];
+    return result;
+}
+
+RiskCheck RiskEngine::check(Instrument& in, Side side, Price price, Quantity quantity, Timestamp now)
+{
+    const InstrumentLimits& lim = in.limits;
+    const int64_t qty = static_cast<int64_t>(quantity);
+
+    if (lim.price_band_bps != 0 && in.price != 0) {
+        const int64_t distance = static_cast<int64_t>(price) - static_cast<int64_t>(in.price);
+        if ((distance < 0 ? -distance : distance) * BPS > static_cast<int64_t>(lim.price_band_bps) * in.price) {
+            return RiskCheck::PriceBand;
+        }
+    }
+
+    const bool bounded = lim.max_position != 0 || lim.min_position != 0;
+    Quantity open_buy = in.open_buy, open_sell = in.open_sell;
+    if (side == Side::Buy) {
+        if (bounded && in.position + static_cast<int64_t>(open_buy) + qty > lim.max_position) return RiskCheck::PositionLimit;
+        open_buy += quantity;
+    } else {
+        if (bounded && in.position - static_cast<int64_t>(open_sell) - qty < lim.min_position) return RiskCheck::PositionLimit;
+        open_sell += quantity;
+    }
+
+    const int64_t px = in.price != 0 ? in.price : price;
+    const int64_t notional = worst_exposure(in.position, open_buy, open_sell) * px;
+    if (lim.max_notional != 0 && notional > lim.max_notional) return RiskCheck::InstrumentNotional;
+    if (portfolio_.max_gross_notional != 0 &&
+        gross_notional_ - in.notional + notional > portfolio_.max_gross_notional) {
+        return RiskCheck::PortfolioNotional;
+    }
+
+    if (lim.max_orders != 0) {
+        // one token per ns of event time per allowed order, capped at a full window
+        const uint64_t capacity = static_cast<uint64_t>(lim.max_orders) * lim.rate_window_ns;
+        const Timestamp elapsed = now > in.refilled ? std::min<Timestamp>(now - in.refilled, lim.rate_window_ns) : 0;
+        in.tokens = std::min(capacity, in.tokens + elapsed * lim.max_orders);
+        in.refilled = std::max(in.refilled, now);
+        if (in.tokens < lim.rate_window_ns) return RiskCheck::OrderRate;
+    }
+    return RiskCheck::Ok;
+}
+
+void RiskEngine::on_fill(uint32_t slot, Side side, Price price, Quantity quantity)
+{
+    if (slot >= instruments_.size()) return;
+    Instrument& in = instruments_[slot];
+    if (side == Side::Buy) {
+        in.open_buy -= std::min(in.open_buy, quantity);
+        in.position += static_cast<int64_t>(quantity);
+    } else {
+        in.open_sell -= std::min(in.open_sell, quantity);
+        in.position -= static_cast<int64_t>(quantity);
+    }
+    if (in.price == 0) in.price = price;
+    refresh(in);
+}
+
+void RiskEngine::on_cancel(uint32_t slot, Side side, Quantity quantity)
+{
+    if (slot >= instruments_.size()) return;
+    Instrument& in = instruments_[slot];
+    Quantity& open = (side == Side::Buy) ? in.open_buy : in.open_sell;
+    open -= std::min(open, quantity);
+    refresh(in);
+}
+
+void RiskEngine::mark(uint32_t slot, Price reference)
+{
+    if (slot >= instruments_.size() || reference == 0) return;
+    Instrument& in = instruments_[slot];
+    if (in.price == reference) return;
+    in.price = reference;
+    refresh(in);
+}
+
+void RiskEngine::refresh(Instrument& in)
+{
+    const int64_t notional = worst_exposure(in.position, in.open_buy, in.open_sell) * static_cast<int64_t>(in.price);
+    gross_notional_ += notional - in.notional;
+    in.notional = notional;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "types/usings.h"
+#include "types/side.h"
+
+/**
+ * @brief Pre-trade limits of one instrument (0 disables a limit)
+ *
+ * @details The position bounds act as a pair: both 0 disables the position
+ * check, otherwise both are enforced (max 1000 / min 0 is long-only).
+ */
+struct InstrumentLimits
+{
+    Position  max_position = 0;           ///< Longest position incl. working buys
+    Position  min_position = 0;           ///< Shortest position incl. working sells (negative = short)
+    int64_t   max_notional = 0;           ///< Largest worst-case |position| x price
+    uint32_t  price_band_bps = 0;         ///< Fat-finger band around the reference price
+    uint32_t  max_orders = 0;             ///< Orders per rate window
+    Timestamp rate_window_ns = 1000000000ull;
+};
+
+/**
+ * @brief Limits across every instrument of a RiskEngine (0 disables a limit)
+ */
+struct PortfolioLimits
+{
+    int64_t max_gross_notional = 0;       ///< Sum of the instruments' worst-case notionals
+};
+
+/**
+ * @brief Outcome of a pre-trade check
+ */
+enum class RiskCheck : uint8_t
+{
+    Ok = 0,
+    UnknownInstrument,
+    PriceBand,
+    PositionLimit,
+    InstrumentNotional,
+    PortfolioNotional,
+    OrderRate,
+    Count_                                ///< Number of outcomes (array size)
+};
+
+const char* to_string(RiskCheck check);
+
+/**
+ * @brief Signed positions and pre-trade limits shared by strategies on many books
+ *
+ * @details Instruments are registered once and addressed by a dense slot
+ * afterwards, so the hot path is an array index and a handful of integer
+ * comparisons per order:
+ * - price band: |price - reference| against price_band_bps of the reference
+ * - position: position plus every working order on the same side
+ * - notional: worst-case exposure (position plus working orders in the
+ *   riskier direction) times the reference price
+ * - portfolio: running sum of the instruments' notionals, adjusted by the
+ *   difference whenever one instrument changes
+ * - order rate: token bucket refilled by elapsed event time
+ *
+ * submit() reserves an accepted order as working; on_fill() moves it into
+ * the position and on_cancel() releases it. Not thread-safe: one replay
+ * thread drives every strategy sharing an engine.
+ */
+class RiskEngine
+{
+public:
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    explicit RiskEngine(const PortfolioLimits& limits = PortfolioLimits()) : portfolio_(limits) {}
+
+    /**
+     * @brief Registers an instrument (or replaces the limits of a registered one)
+     * @return Slot used by every other call
+     */
+    uint32_t add_instrument(OrderbookId book, const InstrumentLimits& limits);
+
+    /**
+     * @brief Slot of a registered book, NO_SLOT if unknown
+     */
+    uint32_t slot(OrderbookId book) const;
+
+    /**
+     * @brief Checks an order and, if accepted, reserves it as working
+     * @param slot Instrument slot
+     * @param side Buy or Sell
+     * @param price Limit price
+     * @param quantity Order quantity
+     * @param now Event time of the decision (drives the rate limit)
+     * @return RiskCheck::Ok or the first limit the order breaks
+     */
+    RiskCheck submit(uint32_t slot, Side side, Price price, Quantity quantity, Timestamp now);
+
+    /**
+     * @brief Books a fill of a working order into the position
+     */
+    void on_fill(uint32_t slot, Side side, Price price, Quantity quantity);
+
+    /**
+     * @brief Releases working quantity that will not fill (missed, cancelled, dropped)
+     */
+    void on_cancel(uint32_t slot, Side side, Quantity quantity);
+
+    /**
+     * @brief Sets the reference price for the band and notional checks
+     */
+    void mark(uint32_t slot, Price reference);
+
+    Position position(uint32_t slot) const { return instruments_[slot].position; }
+    Quantity working_buy(uint32_t slot) const { return instruments_[slot].open_buy; }
+    Quantity working_sell(uint32_t slot) const { return instruments_[slot].open_sell; }
+    int64_t  notional(uint32_t slot) const { return instruments_[slot].notional; }
+    int64_t  gross_notional() const { return gross_notional_; }
+
+    /**
+     * @brief Orders checked and how many each outcome got
+     */
+    size_t checks() const { return checks_; }
+    size_t count(RiskCheck outcome) const { return outcomes_[static_cast<size_t>(outcome)]; }
+
+private:
+    struct Instrument
+    {
+        InstrumentLimits limits;
+        OrderbookId book = 0;
+        Position  position = 0;
+        Quantity  open_buy = 0;
+        Quantity  open_sell = 0;
+        Price     price = 0;          ///< Reference price (last mark, else last order price)
+        int64_t   notional = 0;       ///< Current worst-case notional
+        uint64_t  tokens = 0;         ///< Rate bucket, one order = rate_window_ns tokens
+        Timestamp refilled = 0;       ///< Event time of the last refill
+    };
+
+    PortfolioLimits portfolio_;
+    std::vector<Instrument> instruments_;
+    std::unordered_map<OrderbookId, uint32_t> slots_;   ///< Registration only, never on the hot path
+    int64_t gross_notional_ = 0;
+    size_t checks_ = 0;
+    size_t outcomes_[static_cast<size_t>(RiskCheck::Count_)] = {};
+
+    RiskCheck check(Instrument& in, Side side, Price price, Quantity quantity, Timestamp now);
+
+    /// Recomputes an instrument's notional and moves the portfolio sum by the difference
+    void refresh(Instrument& in);
+};
@@ -0,0 +1,228 @@
+#include "shm_book.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @details Implementation notes:
+ * - shm_open(O_CREAT|O_TRUNC) + ftruncate zero-fills the region, so every
+ *   slot starts with seq == 0 and owner == 0 (free)
+ * - Header is written last; readers check magic before trusting slot_count
+ * - depth is capped at MAX_DEPTH; snapshot buffers are reserved once so
+ *   publish() does not allocate
+ */
+ShmBookPublisher::ShmBookPublisher(const std::string& name, uint32_t slots, uint32_t depth)
+    : name_(name)
+    , slot_count_(slots)
+    , depth_(depth < shm_book::MAX_DEPTH ? depth : static_cast<uint32_t>(shm_book::MAX_DEPTH))
+{
+    bids_.reserve(depth_);
+    asks_.reserve(depth_);
+
+    int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "[ERROR] shm_open(" << name_ << ") failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    size_ = shm_book::region_size(slots);
+    if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+        std::cerr << "[ERROR] ftruncate(" << name_ << ") failed: " << std::strerror(errno) << std::endl;
+        close(fd);
+        return;
+    }
+
+    void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        std::cerr << "[ERROR] mmap(" << name_ << ") failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+    base_ = p;
+
+    for (uint32_t i = 0; i < slot_count_; ++i) {
+        shm_book::Slot* s = &slot(i);
+        new (&s->seq) std::atomic<uint32_t>(0);
+        new (&s->owner) std::atomic<OrderbookId>(0);
+    }
+
+    shm_book::Header& h = header();
+    h.version    = shm_book::VERSION;
+    h.slot_count = slot_count_;
+    h.depth      = depth_;
+    std::atomic_thread_fence(std::memory_order_release);
+    h.magic      = shm_book::MAGIC;
+}
+
+ShmBookPublisher::~ShmBookPublisher()
+{
+    if (base_) munmap(base_, size_);
+}
+
+shm_book::Slot& ShmBookPublisher::slot(uint32_t i) const
+{
+    return reinterpret_cast<shm_book::Slot*>(static_cast<char*>(base_) + sizeof(shm_book::Header))[i];
+}
+
+/**
+ * @details Implementation notes:
+ * - Slot assignment is first-come; the writer remembers it in slot_of_ and
+ *   stores the book id in the slot's owner field for readers to find
+ * - Seqlock write: seq -> odd, release fence, plain stores, seq -> even
+ *   with release ordering. Only one writer per region is supported.
+ */
+bool ShmBookPublisher::publish(OrderbookId book, const Orderbook& ob, uint64_t ns)
+{
+    if (!base_) return false;
+
+    uint32_t index;
+    auto it = slot_of_.find(book);
+    if (it != slot_of_.end()) {
+        index = it->second;
+    } else {
+        if (slot_of_.size() >= slot_count_) {
+            std::cerr << "[WARN] shm region " << name_ << " full, book " << book << " not published" << std::endl;
+            return false;
+        }
+        index = static_cast<uint32_t>(slot_of_.size());
+        slot_of_.emplace(book, index);
+    }
+
+    ob.snapshot_n(depth_, bids_, asks_);
+
+    shm_book::Slot& s = slot(index);
+    const uint32_t seq = s.seq.load(std::memory_order_relaxed);
+    s.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    shm_book::Snapshot& d = s.data;
+    d.book_id      = book;
+    d.trading_open = ob.trading_open() ? 1 : 0;
+    d.nanosec      = ns;
+    d.updates     += 1;
+    d.best_bid     = ob.best_bid_price();
+    d.best_ask     = ob.best_ask_price();
+    d.best_bid_qty = bids_.empty() ? 0 : bids_[0].second;
+    d.best_ask_qty = asks_.empty() ? 0 : asks_[0].second;
+    d.bid_levels   = static_cast<uint32_t>(bids_.size());
+    d.ask_levels   = static_cast<uint32_t>(asks_.size());
+    for (size_t i = 0; i < bids_.size(); ++i) d.bids[i] = shm_book::Level{bids_[i].first, bids_[i].second};
+    for (size_t i = 0; i < asks_.size(); ++i) d.asks[i] = shm_book::Level{asks_[i].first, asks_[i].second};
+
+    s.seq.store(seq + 2, std::memory_order_release);
+
+    if (s.owner.load(std::memory_order_relaxed) != book) {
+        s.owner.store(book, std::memory_order_release);
+    }
+    return true;
+}
+
+void ShmBookPublisher::unlink()
+{
+    shm_unlink(name_.c_str());
+}
+
+/**
+ * @details Implementation notes:
+ * - Maps the whole region read-only; a reader can never disturb the writer
+ * - Rejects regions whose magic/version do not match this build
+ */
+ShmBookReader::ShmBookReader(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "[ERROR] shm_open(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(shm_book::Header)) {
+        std::cerr << "[ERROR] shm region " << name << " too small" << std::endl;
+        close(fd);
+        return;
+    }
+
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        std::cerr << "[ERROR] mmap(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    const shm_book::Header* h = static_cast<const shm_book::Header*>(p);
+    if (h->magic != shm_book::MAGIC || h->version != shm_book::VERSION ||
+        shm_book::region_size(h->slot_count) > static_cast<size_t>(st.st_size)) {
+        std::cerr << "[ERROR] shm region " << name << " has unexpected layout" << std::endl;
+        munmap(p, static_cast<size_t>(st.st_size));
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    base_ = p;
+    size_ = static_cast<size_t>(st.st_size);
+    slot_count_ = h->slot_count;
+}
+
+ShmBookReader::~ShmBookReader()
+{
+    if (base_) munmap(const_cast<void*>(base_), size_);
+}
+
+const shm_book::Slot& ShmBookReader::slot(uint32_t i) const
+{
+    return reinterpret_cast<const shm_book::Slot*>(static_cast<const char*>(base_) + sizeof(shm_book::Header))[i];
+}
+
+/**
+ * @details Implementation notes:
+ * - Slots are claimed in order, so the scan stops at the first free one
+ * - Hits are cached; the scan only runs until a book has been seen once
+ */
+bool ShmBookReader::find_slot(OrderbookId book, uint32_t& index)
+{
+    auto it = slot_of_.find(book);
+    if (it != slot_of_.end()) { index = it->second; return true; }
+
+    for (uint32_t i = 0; i < slot_count_; ++i) {
+        const OrderbookId owner = slot(i).owner.load(std::memory_order_acquire);
+        if (owner == 0) return false;
+        if (owner == book) {
+            slot_of_.emplace(book, i);
+            index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @details Implementation notes:
+ * - Seqlock read: seq (acquire) must be even, copy, acquire fence, seq must
+ *   be unchanged; otherwise the copy may be torn and is retried
+ */
+bool ShmBookReader::read(OrderbookId book, shm_book::Snapshot& out)
+{
+    if (!base_) return false;
+
+    uint32_t index;
+    if (!find_slot(book, index)) return false;
+
+    const shm_book::Slot& s = slot(index);
+    for (;;) {
+        const uint32_t before = s.seq.load(std::memory_order_acquire);
+        if (before & 1u) { ++retries_; continue; }
+
+        std::memcpy(&out, &s.data, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (s.seq.load(std::memory_order_relaxed) == before) return true;
+        ++retries_;
+    }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include "orderbook.h"
+#include "types/usings.h"
+
+/**
+ * @brief Shared-memory top-of-book publication (single writer, many readers)
+ *
+ * @details The region is a header followed by fixed-size slots, one per
+ * instrument. Each slot is guarded by a seqlock: the writer bumps the
+ * sequence to odd, copies the data, bumps it to even; readers copy the data
+ * and retry if the sequence was odd or moved. Readers never write to the
+ * region, so any number of them cost the writer nothing, and after the
+ * initial mmap neither side makes a syscall.
+ */
+namespace shm_book
+{
+    constexpr uint32_t MAGIC     = 0x4F424B31;   ///< "OBK1"
+    constexpr uint32_t VERSION   = 1;
+    constexpr size_t   MAX_DEPTH = 10;           ///< Levels per side stored in a slot
+
+    /**
+     * @brief One aggregated level as stored in shared memory
+     */
+    struct Level
+    {
+        Price    price;
+        Quantity quantity;
+    };
+
+    /**
+     * @brief Published state of one instrument (copied out by readers)
+     */
+    struct Snapshot
+    {
+        OrderbookId book_id;        ///< Instrument of this slot
+        uint32_t    bid_levels;     ///< Valid entries in bids
+        uint32_t    ask_levels;     ///< Valid entries in asks
+        uint32_t    trading_open;   ///< 1 while continuous trading is open
+        uint64_t    nanosec;        ///< Feed timestamp of the last update
+        uint64_t    updates;        ///< Number of publications to this slot
+        Price       best_bid;       ///< Best bid price (0 if none)
+        Price       best_ask;       ///< Best ask price (0 if none)
+        Quantity    best_bid_qty;   ///< Quantity at best bid
+        Quantity    best_ask_qty;   ///< Quantity at best ask
+        Level       bids[MAX_DEPTH];
+        Level       asks[MAX_DEPTH];
+    };
+
+    /**
+     * @brief Seqlock-protected slot, cache-line aligned to avoid false sharing
+     */
+    struct alignas(64) Slot
+    {
+        std::atomic<uint32_t>    seq;       ///< Odd while the writer is inside
+        std::atomic<OrderbookId> owner;     ///< Book id claimed by the writer (0 = free)
+        Snapshot                 data;
+    };
+
+    /**
+     * @brief Region header
+     */
+    struct alignas(64) Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t depth;
+    };
+
+    /**
+     * @brief Bytes needed for a region with the given number of slots
+     */
+    inline size_t region_size(uint32_t slots) { return sizeof(Header) + slots * sizeof(Slot); }
+}
+
+/**
+ * @brief Writer side: creates the region and publishes books into it
+ */
+class ShmBookPublisher
+{
+public:
+    /**
+     * @brief Creates (or recreates) a POSIX shared-memory region
+     * @param name Region name as passed to shm_open (e.g. "/orderbook_top")
+     * @param slots Maximum number of instruments
+     * @param depth Levels per side to publish (capped at shm_book::MAX_DEPTH)
+     *
+     * @details On failure an error is logged and ok() returns false.
+     */
+    ShmBookPublisher(const std::string& name, uint32_t slots, uint32_t depth = 5);
+    ~ShmBookPublisher();
+
+    ShmBookPublisher(const ShmBookPublisher&) = delete;
+    ShmBookPublisher& operator=(const ShmBookPublisher&) = delete;
+
+    bool ok() const { return base_ != nullptr; }
+
+    /**
+     * @brief Publishes the current state of one book
+     * @param book Instrument id (claims a slot on first use)
+     * @param ob Order book to publish
+     * @param ns Feed timestamp of the update
+     * @return false if the region is full or not mapped
+     */
+    bool publish(OrderbookId book, const Orderbook& ob, uint64_t ns);
+
+    /**
+     * @brief Removes the region name; mapped readers keep working
+     */
+    void unlink();
+
+private:
+    std::string name_;                                 ///< Region name
+    void*       base_{nullptr};                        ///< Mapped region
+    size_t      size_{0};                              ///< Mapped bytes
+    uint32_t    slot_count_{0};                        ///< Slots in the region
+    uint32_t    depth_{0};                             ///< Levels per side published
+    std::unordered_map<OrderbookId, uint32_t> slot_of_;  ///< Book -> slot index
+    DisplayLevel bids_, asks_;                         ///< Reused snapshot buffers
+
+    shm_book::Header& header() const { return *static_cast<shm_book::Header*>(base_); }
+    shm_book::Slot& slot(uint32_t i) const;
+};
+
+/**
+ * @brief Reader side: maps the region read-only and copies out snapshots
+ */
+class ShmBookReader
+{
+public:
+    /**
+     * @brief Maps an existing region read-only
+     * @param name Region name used by the publisher
+     *
+     * @details On failure an error is logged and ok() returns false.
+     */
+    explicit ShmBookReader(const std::string& name);
+    ~ShmBookReader();
+
+    ShmBookReader(const ShmBookReader&) = delete;
+    ShmBookReader& operator=(const ShmBookReader&) = delete;
+
+    bool ok() const { return base_ != nullptr; }
+
+    /**
+     * @brief Copies a consistent snapshot of one book
+     * @param book Instrument id
+     * @param out Destination snapshot
+     * @return false if the book has not been published
+     *
+     * @details Retries while the writer is mid-update; never blocks the writer.
+     */
+    bool read(OrderbookId book, shm_book::Snapshot& out);
+
+    uint64_t retries() const { return retries_; }   ///< Torn reads retried so far
+
+private:
+    const void* base_{nullptr};                        ///< Mapped region
+    size_t      size_{0};                              ///< Mapped bytes
+    uint32_t    slot_count_{0};                        ///< Slots in the region
+    uint64_t    retries_{0};                           ///< Seqlock retries
+    std::unordered_map<OrderbookId, uint32_t> slot_of_;  ///< Cached book -> slot index
+
+    const shm_book::Slot& slot(uint32_t i) const;
+    bool find_slot(OrderbookId book, uint32_t& index);
+};
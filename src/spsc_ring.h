@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Bounded single-producer / single-consumer ring of preallocated slots
+ *
+ * @details Slots are allocated once; producer and consumer then exchange
+ * them through two monotonically increasing indices without locks or
+ * allocation. Each side keeps a cached copy of the other side's index and
+ * only reloads it when the ring looks full (or empty), so the shared cache
+ * lines are touched once per burst rather than once per element. The
+ * indices sit on separate cache lines to avoid false sharing.
+ *
+ * claim()/publish() and front()/pop() let either side work on a slot in
+ * place (e.g. encode a message straight into it); try_push()/try_pop()
+ * copy whole elements.
+ */
+template <typename T>
+class SpscRing
+{
+public:
+    /**
+     * @param capacity Minimum number of slots (rounded up to a power of two)
+     */
+    explicit SpscRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return slots_.size(); }
+
+    // ----- producer -----
+
+    /**
+     * @brief Next free slot, nullptr if the ring is full
+     */
+    T* claim()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == slots_.size()) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == slots_.size()) return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    /**
+     * @brief Hands the slot returned by claim() to the consumer
+     */
+    void publish() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool try_push(const T& value)
+    {
+        T* slot = claim();
+        if (!slot) return false;
+        *slot = value;
+        publish();
+        return true;
+    }
+
+    // ----- consumer -----
+
+    /**
+     * @brief Oldest published slot, nullptr if the ring is empty
+     */
+    T* front()
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    /**
+     * @brief Returns the slot returned by front() to the producer
+     */
+    void pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool try_pop(T& out)
+    {
+        T* slot = front();
+        if (!slot) return false;
+        out = *slot;
+        pop();
+        return true;
+    }
+
+    /**
+     * @brief Elements in flight (exact only when both sides are idle)
+     */
+    size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    char pad0_[CACHE_LINE];
+    std::atomic<size_t> head_{0};       ///< Next slot to consume (written by the consumer)
+    size_t tail_cache_ = 0;             ///< Consumer's copy of tail_
+    char pad1_[CACHE_LINE];
+    std::atomic<size_t> tail_{0};       ///< Next slot to fill (written by the producer)
+    size_t head_cache_ = 0;             ///< Producer's copy of head_
+    char pad2_[CACHE_LINE];
+};
@@ -1,14 +1,18 @@
 #include "strategy.h"
+#include "fill_simulator.h"
+#include "latency_model.h"
+#include "order_gateway.h"
+#include "risk_engine.h"
 #include <algorithm>
 #include <iostream>
+#include <thread>
 
 namespace {
     // Configuration constants
     constexpr bool DEBUG_LOGS = false;                                    ///< Enable debug logging
-    constexpr Price PRICE_TICK = 10;                                      ///< 1 tick in kuruş
-    constexpr Price TIGHT_SPREAD = PRICE_TICK;                            ///< Normal tight market spread
-    constexpr Price GAP_SPREAD = 2 * PRICE_TICK;                          ///< Required 1-tick gap spread
+    constexpr Price DEFAULT_PRICE_TICK = 10;                              ///< 1 tick in kuruş (fast path)
     constexpr const char* MARKET_CLOSE_STATE = "P_MARJ_YAYIN_KAPANIS";    ///< Market close state string
+    constexpr uint64_t GATEWAY_DRAIN_NS = 1000000000ull;                  ///< Wait for open orders at the close
 }
 
 /**
@@ -17,7 +21,7 @@ namespace {
  * @param ns Nanosecond timestamp
  * @param message Debug message to log
  */
-static void log_debug(const char* function, Nanoseconds ns, const std::string& message) {
+static void log_debug(const char* function, Timestamp ns, const std::string& message) {
     if (!DEBUG_LOGS) return;
     std::cout << "[DBG] " << function << " ns=" << ns << " " << message << "\n";
 }
@@ -30,15 +34,18 @@ static void log_debug(const char* function, Nanoseconds ns, const std::string& m
  */
 Strategy::Strategy(OrderbookId target_book,
 					Quantity order_quantity,
-					Quantity max_position,
-					Quantity min_position) :
+					Position max_position,
+					Position min_position,
+					const TickTable& ticks) :
 					target_book_(target_book),
 					order_quantity_(order_quantity),
 					max_position_(max_position),
 					min_position_(min_position),
+					ticks_(ticks),
 					position_(0),
 					realized_pnl_(0),
-					day_closed_(false) {
+					day_closed_(false),
+					trade_log_(&std::cout) {
     if (target_book == 0) {
         std::cerr << "[ERROR] Strategy: Invalid target_book (0)\n";
     }
@@ -58,7 +65,7 @@ Strategy::Strategy(OrderbookId target_book,
  * - End-of-day settlement using last executed price
  * - Early exits for invalid market conditions
  */
-void Strategy::on_batch(Nanoseconds ns,
+void Strategy::on_batch(Timestamp ns,
                         const Orderbook& ob,
                         const std::vector<Event>& batch)
 {
@@ -82,6 +89,42 @@ void Strategy::on_batch(Nanoseconds ns,
         }
     }
 
+    evaluate(ns, ob, ob.best_bid_price(), ob.best_ask_price());
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) - no book queries, prices come from the record
+ * - Only the new side of the record is used; the reference top is the
+ *   strategy's own previous snapshot, exactly as in on_batch
+ */
+void Strategy::on_top_change(Timestamp ns,
+                             const Orderbook& ob,
+                             const TopOfBookChanged& change)
+{
+    if (day_closed_) { 
+        log_debug("on_top_change", ns, "skip: day_closed"); 
+        return; 
+    }
+    evaluate(ns, ob, change.new_bid, change.new_ask);
+}
+
+/**
+ * @details Implementation notes:
+ * - Shared by the polling (on_batch) and event-driven (on_top_change) paths
+ * - Updates the previous snapshot whenever trading is open with a top
+ * - Records the batch time for virtual orders placed by try_buy/try_sell
+ * - Marks the risk engine's reference price with the evaluated mid
+ * - Applies gateway reports first, so limits see the latest fills
+ */
+void Strategy::evaluate(Timestamp ns,
+                        const Orderbook& ob,
+                        Price curr_best_bid,
+                        Price curr_best_ask)
+{
+    now_ = ns;
+    if (gateway_) poll_gateway();
+
     // require trading open and a top-of-book
     if (!ob.trading_open()) { 
         log_debug("on_batch", ns, "skip: trading not open"); 
@@ -91,11 +134,7 @@ void Strategy::on_batch(Nanoseconds ns,
         log_debug("on_batch", ns, "skip: no top-of-book");  
         return; 
     }
-
-    // Read current top once (we'll update prev_* to these at the end)
-    const Price curr_best_bid = ob.best_bid_price();
-    const Price curr_best_ask = ob.best_ask_price();
-    const long  curr_spread   = static_cast<long>(curr_best_ask) - static_cast<long>(curr_best_bid);
+    if (risk_) risk_->mark(risk_slot_, (curr_best_bid + curr_best_ask) / 2);
 
     bool proceed = true;
     bool trade_executed = false;
@@ -146,28 +185,21 @@ void Strategy::on_batch(Nanoseconds ns,
         proceed = false;
     }
 
-    // require: prev was TIGHT, now is GAP (gap just formed this ns)
+    // require: prev was TIGHT, now one top level vanished by exactly 1 tick.
+    // Trade at the vanished price.
     if (proceed) {
-        const long prev_spread = static_cast<long>(prev_ask_) - static_cast<long>(prev_bid_);
-        if (!(prev_spread == TIGHT_SPREAD && curr_spread == GAP_SPREAD)) {
-            log_debug("on_batch", ns, "skip: prev not tight or cur not gap");
-            proceed = false;
-        }
-    }
-
-    // direction: which top moved by exactly 1 tick? Trade at vanished price
-    if (proceed) {
-        // Ask moved UP by 1 tick, bid unchanged -> vanished ASK -> BUY @ prev_ask_
-        if (curr_best_bid == prev_bid_ && (curr_best_ask - prev_ask_) == PRICE_TICK) {
+        switch (detect(curr_best_bid, curr_best_ask)) {
+        case GapSignal::BuyVanishedAsk:
             log_debug("on_batch", ns, "vanished ASK@" + std::to_string(prev_ask_) + " -> BUY");
             trade_executed = try_buy(prev_ask_);
-        }
-        // Bid moved DOWN by 1 tick, ask unchanged -> vanished BID -> SELL @ prev_bid_
-        else if (curr_best_ask == prev_ask_ && (prev_bid_ - curr_best_bid) == PRICE_TICK) {
+            break;
+        case GapSignal::SellVanishedBid:
             log_debug("on_batch", ns, "vanished BID@" + std::to_string(prev_bid_) + " -> SELL");
             trade_executed = try_sell(prev_bid_);
-        } else {
-            log_debug("on_batch", ns, "skip: ambiguous move (both/none/>1 tick)");
+            break;
+        default:
+            log_debug("on_batch", ns, "skip: prev not tight or no 1-tick gap");
+            break;
         }
     }
 
@@ -180,6 +212,23 @@ void Strategy::on_batch(Nanoseconds ns,
     }
 }
 
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) for uniform tables, O(bands) for banded tables
+ * - Uniform dispatch is decided per call on a cached table, so the branch
+ *   is perfectly predicted
+ */
+GapSignal Strategy::detect(Price curr_bid, Price curr_ask) const
+{
+    if (ticks_.uniform()) {
+        if (ticks_.uniform_tick() == DEFAULT_PRICE_TICK) {
+            return detect_gap(ConstantTick<DEFAULT_PRICE_TICK>(), prev_bid_, prev_ask_, curr_bid, curr_ask);
+        }
+        return detect_gap(UniformTick{ ticks_.uniform_tick() }, prev_bid_, prev_ask_, curr_bid, curr_ask);
+    }
+    return detect_gap(BandTick{ &ticks_ }, prev_bid_, prev_ask_, curr_bid, curr_ask);
+}
+
 /**
  * @details Implementation notes:
  * - Time complexity: O(1) - simple arithmetic operations
@@ -188,7 +237,8 @@ void Strategy::on_batch(Nanoseconds ns,
  */
 bool Strategy::try_buy(Price price) 
 {
-	Quantity max_buy = (position_ < max_position_) ? (max_position_ - position_) : 0;
+	const Position committed = position_ + static_cast<Position>(pending_buy_);
+	Quantity max_buy = (committed < max_position_) ? static_cast<Quantity>(max_position_ - committed) : 0;
 	if (max_buy == 0) { 
 		log_debug("try_buy", 0, "blocked: max_position reached"); 
 		return false; 
@@ -196,11 +246,8 @@ bool Strategy::try_buy(Price price)
 
 	Quantity fill_quantity = std::min(order_quantity_, max_buy);
 
-	realized_pnl_ -= static_cast<int64_t>(fill_quantity) * static_cast<int64_t>(price);
-	position_ += fill_quantity;
-
-	std::cout << "[TRADE] BUY  " << fill_quantity << " @ " << price
-              << " pos=" << position_ << " pnl=" << realized_pnl_ << "\n";
+	if (!risk_allows(Side::Buy, price, fill_quantity)) return false;
+	submit(Side::Buy, price, fill_quantity);
     return true;
 }
 
@@ -212,7 +259,8 @@ bool Strategy::try_buy(Price price)
  */
 bool Strategy::try_sell(Price price)
 {
-	Quantity max_sell = (position_ > min_position_) ? (position_ - min_position_) : 0;
+	const Position committed = position_ - static_cast<Position>(pending_sell_);
+	Quantity max_sell = (committed > min_position_) ? static_cast<Quantity>(committed - min_position_) : 0;
 	if (max_sell == 0) { 
 		log_debug("try_sell", 0, "blocked: min_position reached"); 
 		return false; 
@@ -220,14 +268,169 @@ bool Strategy::try_sell(Price price)
 
 	Quantity fill_quantity = std::min(order_quantity_, max_sell);
 
-	realized_pnl_ += static_cast<int64_t>(fill_quantity) * static_cast<int64_t>(price);
-	position_ -= fill_quantity;
-    
-    std::cout << "[TRADE] SELL " << fill_quantity << " @ " << price
-              << " pos=" << position_ << " pnl=" << realized_pnl_ << "\n";
+	if (!risk_allows(Side::Sell, price, fill_quantity)) return false;
+	submit(Side::Sell, price, fill_quantity);
     return true;
 }
 
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) - one engine slot lookup
+ * - An accepted order is working in the engine until book_fill() or release()
+ */
+bool Strategy::risk_allows(Side side, Price price, Quantity quantity)
+{
+	if (!risk_) return true;
+	const RiskCheck verdict = risk_->submit(risk_slot_, side, price, quantity, now_);
+	if (verdict == RiskCheck::Ok) return true;
+	++risk_rejects_;
+	log_debug("risk", now_, std::string("rejected: ") + to_string(verdict));
+	return false;
+}
+
+/**
+ * @details Implementation notes:
+ * - Without gateway, latency or simulator this is the original instant fill
+ * - Sent, delayed and resting quantities are reserved in pending_buy_/pending_sell_
+ *   until they fill, are missed, canceled or the day closes
+ * - An order the gateway cannot queue (ring full, session down) is released at once
+ */
+void Strategy::submit(Side side, Price price, Quantity quantity)
+{
+	if (gateway_ || latency_ || sim_) {
+		(side == Side::Buy ? pending_buy_ : pending_sell_) += quantity;
+	}
+	if (gateway_) {
+		const uint64_t token = gateway_->enter(owner_, target_book_, side, price, quantity);
+		if (token != 0) {
+			tokens_.push_back(token);
+		} else {
+			log_debug("submit", now_, "gateway refused the order");
+			release(side, quantity);
+		}
+	} else if (latency_) {
+		latency_->send(owner_, side, price, quantity, now_);
+	} else if (sim_) {
+		working_.push_back(sim_->place(owner_, side, price, quantity, now_));
+	} else {
+		book_fill(side, quantity, price);
+	}
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) without a simulator, one place() with it
+ * - Orders arriving after the close are ignored (their reservation was
+ *   released by settle_eod)
+ * - A missed order is released; a filled one only leaves pending_*, the
+ *   engine's working quantity is moved into the position by book_fill()
+ */
+void Strategy::on_arrival(const DelayedOrder& order, const Orderbook& ob)
+{
+	if (order.owner != owner_ || day_closed_) return;
+	if (sim_) {
+		working_.push_back(sim_->place(owner_, order.side, order.price, order.quantity, order.arrival));
+		return;
+	}
+
+	const bool open = (order.side == Side::Buy)
+		? (ob.best_bid_price() == 0 || ob.best_bid_price() < order.price)
+		: (ob.best_ask_price() == 0 || ob.best_ask_price() > order.price);
+	if (!open) {
+		++missed_;
+		log_debug("on_arrival", order.arrival, "missed: gap closed before arrival");
+		release(order.side, order.quantity);
+		return;
+	}
+	Quantity& pending = (order.side == Side::Buy) ? pending_buy_ : pending_sell_;
+	pending -= std::min(pending, order.quantity);
+	book_fill(order.side, order.quantity, order.price);
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1)
+ * - A virtual order may fill in several parts; each part counts as a fill
+ */
+void Strategy::on_fill(const VirtualFill& fill)
+{
+	if (fill.owner != owner_) return;
+	Quantity& pending = (fill.side == Side::Buy) ? pending_buy_ : pending_sell_;
+	pending -= std::min(pending, fill.quantity);
+	book_fill(fill.side, fill.quantity, fill.price);
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(reports)
+ */
+void Strategy::poll_gateway()
+{
+	gateway_->poll([this](const ExecutionReport& report) { on_report(report); });
+}
+
+/**
+ * @details Implementation notes:
+ * - Accepted reports change nothing: the order is already reserved
+ * - Reports read after the close are ignored (settle_eod released them)
+ */
+void Strategy::on_report(const ExecutionReport& report)
+{
+	if (report.owner != owner_ || day_closed_) return;
+	switch (report.type) {
+	case ouch::Type::Executed: {
+		Quantity& pending = (report.side == Side::Buy) ? pending_buy_ : pending_sell_;
+		pending -= std::min(pending, report.quantity);
+		book_fill(report.side, report.quantity, report.price);
+		break;
+	}
+	case ouch::Type::Canceled:
+	case ouch::Type::Rejected:
+		release(report.side, report.quantity);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @details Implementation notes:
+ * - Shared by instant fills (try_buy/try_sell) and simulated fills (on_fill)
+ */
+void Strategy::book_fill(Side side, Quantity quantity, Price price)
+{
+	const int64_t notional = static_cast<int64_t>(quantity) * static_cast<int64_t>(price);
+	++fills_;
+	if (side == Side::Buy) {
+		realized_pnl_ -= notional;
+		position_ += static_cast<Position>(quantity);
+		bought_ += quantity;
+	} else {
+		realized_pnl_ += notional;
+		position_ -= static_cast<Position>(quantity);
+		sold_ += quantity;
+	}
+	if (risk_) risk_->on_fill(risk_slot_, side, price, quantity);
+
+	if (trade_log_) {
+		*trade_log_ << (side == Side::Buy ? "[TRADE] BUY  " : "[TRADE] SELL ") << quantity << " @ " << price
+		            << " pos=" << position_ << " pnl=" << realized_pnl_ << "\n";
+	}
+}
+
+/**
+ * @details Implementation notes:
+ * - Quantity that will not fill any more: frees the strategy's reservation
+ *   and the engine's working quantity
+ */
+void Strategy::release(Side side, Quantity quantity)
+{
+	if (quantity == 0) return;
+	Quantity& pending = (side == Side::Buy) ? pending_buy_ : pending_sell_;
+	pending -= std::min(pending, quantity);
+	if (risk_) risk_->on_cancel(risk_slot_, side, quantity);
+}
+
 /**
  * @details Implementation notes:
  * - Time complexity: O(1) - simple arithmetic operations
@@ -237,16 +440,43 @@ bool Strategy::try_sell(Price price)
  */
 void Strategy::settle_eod(const Orderbook& ob) 
 {
+	// working virtual orders do not survive the close (in-flight ones are
+	// dropped by the driver)
+	if (sim_) {
+		for (uint32_t id : working_) sim_->cancel(id);
+	}
+	working_.clear();
+
+	// live orders: cancel what is still open and wait for the answers, so
+	// fills that raced the close are booked
+	if (gateway_) {
+		poll_gateway();
+		for (uint64_t token : tokens_) gateway_->cancel(token);
+		tokens_.clear();
+		const uint64_t deadline = OrderGateway::now_ns() + GATEWAY_DRAIN_NS;
+		for (poll_gateway(); gateway_->open_orders() != 0 && gateway_->ok(); poll_gateway()) {
+			if (OrderGateway::now_ns() > deadline) {
+				std::cerr << "[WARN] Strategy: " << gateway_->open_orders() << " gateway orders unanswered at the close\n";
+				break;
+			}
+			std::this_thread::yield();
+		}
+	}
+	release(Side::Buy, pending_buy_);
+	release(Side::Sell, pending_sell_);
+
 	Price last_price = ob.last_exec_price();
 	if (last_price != 0 && position_ != 0) 
 	{
 		realized_pnl_ += static_cast<int64_t>(position_) * static_cast<int64_t>(last_price);
 	}
 
-    std::cout << "[EOD] Close. last_exec_price=" << last_price
-              << " final_pos=" << position_
-              << " final_pnl=" << realized_pnl_
-              << "\n";
+    if (trade_log_) {
+        *trade_log_ << "[EOD] Close. last_exec_price=" << last_price
+                    << " final_pos=" << position_
+                    << " final_pnl=" << realized_pnl_
+                    << "\n";
+    }
 
     day_closed_ = true;
 }
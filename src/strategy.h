@@ -2,8 +2,18 @@
 
 #include "types/event.h"
 #include "orderbook.h"
+#include "tick_size.h"
 #include <vector>
 #include <cstdint>
+#include <ostream>
+
+class QueueFillSimulator;
+class LatencyQueue;
+class RiskEngine;
+class OrderGateway;
+struct VirtualFill;
+struct ExecutionReport;
+struct DelayedOrder;
 
 /**
  * @brief Trading strategy that detects and exploits 1-tick gaps in the order book
@@ -27,16 +37,20 @@ public:
 	 * @brief Constructs a trading strategy with specified parameters
 	 * @param target_book Order book ID to monitor for trading opportunities
 	 * @param order_quantity Size of orders to place when gaps are detected
-	 * @param max_position Maximum long position allowed (positive value)
-	 * @param min_position Minimum short position allowed (negative value)
+	 * @param max_position Maximum long position allowed
+	 * @param min_position Minimum position allowed (negative = short, 0 = long only)
+	 * @param ticks Tick size table of the target book (default: uniform 10)
 	 * 
 	 * @details Initializes the strategy with position limits and order sizing.
 	 * The strategy will not place orders that would exceed these position limits.
+	 * A tight spread is one tick of the band the best bid sits in; a gap is a
+	 * top level that vanished by exactly one tick of its own band.
 	 */
 	Strategy(	OrderbookId target_book,
 				Quantity order_quantity,
-				Quantity max_position,
-				Quantity min_position);
+				Position max_position,
+				Position min_position,
+				const TickTable& ticks = TickTable());
 
 	/**
 	 * @brief Processes a batch of events and executes trading logic
@@ -48,10 +62,25 @@ public:
 	 * 1-tick gaps. If a valid gap is found and position limits allow,
 	 * places appropriate buy/sell orders to capture the spread.
 	 */
-	void on_batch(	Nanoseconds ns,
+	void on_batch(	Timestamp ns,
 					const Orderbook& ob,
 					const std::vector<Event>& batch);
 
+	/**
+	 * @brief Event-driven entry point: reacts to a best bid/ask change
+	 * @param ns Nanosecond timestamp of the batch
+	 * @param ob Current order book state (only trading/top flags are read)
+	 * @param change Net top-of-book change of the batch
+	 *
+	 * @details Equivalent to on_batch for batches that moved the top of
+	 * book or flipped the trading state; the driver skips every other batch,
+	 * so deep-book churn never reaches the strategy. Market close is not
+	 * detected here: the driver calls end_of_day() instead.
+	 */
+	void on_top_change(	Timestamp ns,
+						const Orderbook& ob,
+						const TopOfBookChanged& change);
+
 	/**
 	 * @brief Gets the current position size
 	 * @return Current position (positive = long, negative = short, 0 = flat)
@@ -59,7 +88,7 @@ public:
 	 * @details Returns the net position across all completed trades.
 	 * Positive values indicate long positions, negative values indicate short positions.
 	 */
-	Quantity position() const { return position_; }
+	Position position() const { return position_; }
 
 	/**
 	 * @brief Handles end-of-day processing and position settlement
@@ -79,22 +108,193 @@ public:
 	 */
 	int64_t realized_pnl() const { return realized_pnl_; }
 
+	/**
+	 * @brief Number of simulated fills (buys and sells) so far
+	 */
+	size_t fills() const { return fills_; }
+
+	/**
+	 * @brief Total quantity bought / sold so far
+	 */
+	Quantity bought() const { return bought_; }
+	Quantity sold() const { return sold_; }
+
+	/**
+	 * @brief Redirects the [TRADE]/[EOD] log lines
+	 * @param out Destination stream, nullptr to silence them (default std::cout)
+	 *
+	 * @details Parallel backtests silence every worker's strategy so that
+	 * days do not interleave their output.
+	 */
+	void set_trade_log(std::ostream* out) { trade_log_ = out; }
+
+	/**
+	 * @brief Routes orders through a queue-position fill simulator
+	 * @param sim Simulator bound to the replayed book, nullptr for instant fills (default)
+	 * @param owner Id tagging this strategy's virtual orders
+	 *
+	 * @details With a simulator, a gap signal places a virtual limit order
+	 * at the vanished price instead of filling at once; position and P&L
+	 * change only when on_fill() reports that the queue ahead was consumed.
+	 * Working orders count against the position limits and are cancelled at
+	 * end of day.
+	 */
+	void set_fill_simulator(QueueFillSimulator* sim, uint32_t owner = 0) { sim_ = sim; owner_ = owner; }
+
+	/**
+	 * @brief Delays orders by a simulated wire/exchange latency
+	 * @param latency Queue of orders in flight, nullptr for no delay (default)
+	 * @param owner Id tagging this strategy's orders (same as the simulator's)
+	 *
+	 * @details A gap signal sends the order into the queue; the driver hands
+	 * it back through on_arrival() once its arrival time is reached, and it
+	 * is judged against the book as it is then. In-flight orders count
+	 * against the position limits; orders still in flight at the close are
+	 * dropped.
+	 */
+	void set_latency(LatencyQueue* latency, uint32_t owner = 0) { latency_ = latency; owner_ = owner; }
+
+	/**
+	 * @brief Processes one of this strategy's orders reaching the exchange
+	 * @param order Order released by the latency queue; other owners' are ignored
+	 * @param ob Order book at the arrival time
+	 *
+	 * @details With a fill simulator the order joins its queue now (or
+	 * fills at once if marketable). Without one it fills at its price if the
+	 * gap is still open (a buy above the best bid, a sell below the best
+	 * ask); otherwise somebody else took the level first and it is missed.
+	 */
+	void on_arrival(const DelayedOrder& order, const Orderbook& ob);
+
+	/**
+	 * @brief Books a (partial) fill of one of this strategy's virtual orders
+	 * @param fill Fill reported by the simulator; other owners' fills are ignored
+	 */
+	void on_fill(const VirtualFill& fill);
+
+	/**
+	 * @brief Quantity of virtual orders still working (buy / sell)
+	 */
+	Quantity pending_buy() const { return pending_buy_; }
+	Quantity pending_sell() const { return pending_sell_; }
+
+	/**
+	 * @brief Orders that arrived after the gap had closed (latency, no simulator)
+	 */
+	size_t missed() const { return missed_; }
+
+	/**
+	 * @brief Runs every order through a shared pre-trade risk engine
+	 * @param risk Engine shared by strategies on any number of books, nullptr = none (default)
+	 * @param slot Slot of this strategy's book in the engine
+	 *
+	 * @details The engine sees each sized order before it is sent or
+	 * filled, every fill, and every order that will not fill (missed,
+	 * cancelled or dropped at the close). The strategy marks the engine's
+	 * reference price with the mid of each top it evaluates.
+	 */
+	void set_risk(RiskEngine* risk, uint32_t slot) { risk_ = risk; risk_slot_ = slot; }
+
+	/**
+	 * @brief Orders the risk engine refused
+	 */
+	size_t risk_rejects() const { return risk_rejects_; }
+
+	/**
+	 * @brief Sends orders to an exchange through an order-entry gateway
+	 * @param gateway Live order-entry session, nullptr = simulated fills (default)
+	 * @param owner Id tagging this strategy's orders in the gateway's reports
+	 *
+	 * @details Takes precedence over the latency queue and the fill
+	 * simulator. Each sized order is encoded and queued for the gateway's
+	 * sender thread; the strategy polls the gateway's reports whenever it
+	 * evaluates a top, booking executions as fills and releasing canceled
+	 * or rejected quantity. At end of day open orders are canceled and the
+	 * remaining reports are drained (bounded wait) before settlement. The
+	 * gateway's reports are consumed here, so it serves this strategy only.
+	 */
+	void set_gateway(OrderGateway* gateway, uint32_t owner = 0) { gateway_ = gateway; owner_ = owner; }
+
 private: 
 	// Configuration parameters
 	OrderbookId target_book_;      // target order book id
 	Quantity 	order_quantity_;   // size of orders to place
-	Quantity 	max_position_;     // maximum long position allowed
-	Quantity 	min_position_;     // minimum short position allowed
+	Position 	max_position_;     // maximum long position allowed
+	Position 	min_position_;     // minimum position allowed (negative = short)
+	TickTable 	ticks_;            // tick size table of the target book
 
 	// Current state
-	Quantity 	position_ = 0;     // current net position (long = positive, short = negative)
+	Position 	position_ = 0;     // current net position (long = positive, short = negative)
 	Price prev_bid_  = 0;          // previous best bid price for gap detection
     Price prev_ask_  = 0;          // previous best ask price for gap detection
 	int64_t 	realized_pnl_ = 0; // cumulative realized profit/loss in kuruş
+	size_t 		fills_ = 0;        // simulated fills so far
+	Quantity 	bought_ = 0;       // total quantity bought
+	Quantity 	sold_ = 0;         // total quantity sold
 
 	// Trading state flags
 	bool day_closed_ = false;      // flag indicating end-of-day has been processed
 	bool have_prev_  = false;      // flag indicating we have previous prices for gap detection
+	std::ostream* trade_log_;      // [TRADE]/[EOD] destination (nullptr = silent)
+
+	// Queue-position fills and order latency (optional)
+	QueueFillSimulator* sim_ = nullptr;  // nullptr = instant fills at the signal price
+	LatencyQueue* latency_ = nullptr;    // nullptr = orders act in the decision batch
+	uint32_t 	owner_ = 0;               // owner id of this strategy's orders
+	Timestamp 	now_ = 0;                 // time of the batch being evaluated
+	Quantity 	pending_buy_ = 0;         // in-flight + working buy quantity
+	Quantity 	pending_sell_ = 0;        // in-flight + working sell quantity
+	size_t 		missed_ = 0;              // orders that arrived after the gap closed
+	std::vector<uint32_t> working_;       // virtual order ids, cancelled at end of day
+
+	// Pre-trade risk (optional)
+	RiskEngine* risk_ = nullptr;         // shared engine, nullptr = strategy limits only
+	uint32_t 	risk_slot_ = 0;           // this book's slot in the engine
+	size_t 		risk_rejects_ = 0;        // orders refused by the engine
+
+	// Live order entry (optional)
+	OrderGateway* gateway_ = nullptr;    // nullptr = simulated fills
+	std::vector<uint64_t> tokens_;        // gateway tokens sent, canceled at end of day if open
+
+	/**
+	 * @brief Routes a sized order: gateway, latency queue, fill simulator or instant fill
+	 */
+	void submit(Side side, Price price, Quantity quantity);
+
+	/**
+	 * @brief Applies a fill to position, P&L and the trade log
+	 */
+	void book_fill(Side side, Quantity quantity, Price price);
+
+	/**
+	 * @brief Asks the risk engine (if any) to accept a sized order
+	 */
+	bool risk_allows(Side side, Price price, Quantity quantity);
+
+	/**
+	 * @brief Drops a reservation that will not fill (missed order, close)
+	 */
+	void release(Side side, Quantity quantity);
+
+	/**
+	 * @brief Applies the gateway's reports read so far
+	 */
+	void poll_gateway();
+
+	/**
+	 * @brief Books an execution or releases canceled/rejected quantity
+	 * @param report Gateway report; other owners' reports are ignored
+	 */
+	void on_report(const ExecutionReport& report);
+
+	/**
+	 * @brief Runs gap detection against the current top of book
+	 * @param ns Nanosecond timestamp of the batch
+	 * @param ob Current order book state
+	 * @param curr_best_bid Best bid after the batch
+	 * @param curr_best_ask Best ask after the batch
+	 */
+	void evaluate(Timestamp ns, const Orderbook& ob, Price curr_best_bid, Price curr_best_ask);
 
 	/**
 	 * @brief Attempts to place a buy order at the specified price
@@ -106,13 +306,25 @@ private:
 	 */
 	bool try_buy(Price price);
 
+	/**
+	 * @brief Compares the previous and current top with the cheapest tick policy
+	 * @param curr_bid Current best bid
+	 * @param curr_ask Current best ask
+	 * @return Gap signal for this transition
+	 *
+	 * @details The default 10-unit uniform table uses the compile-time
+	 * ConstantTick path; other uniform tables and banded tables fall back
+	 * to runtime tick lookups.
+	 */
+	GapSignal detect(Price curr_bid, Price curr_ask) const;
+
 	/**
 	 * @brief Attempts to place a sell order at the specified price
 	 * @param price Price to place the sell order at
 	 * @return true if order was placed successfully, false otherwise
 	 * 
 	 * @details Checks position limits before placing the order.
-	 * Only places order if it wouldn't exceed min_position_.
+	 * Only places order if it wouldn't go below min_position_ (short if negative).
 	 */
 	bool try_sell(Price price);
 
@@ -0,0 +1,195 @@
+#include "strategy_sweep.h"
+#include <iomanip>
+#include <iostream>
+
+namespace {
+    constexpr const char* MARKET_CLOSE_STATE = "P_MARJ_YAYIN_KAPANIS";    ///< Market close state string
+}
+
+StrategySweep::StrategySweep(OrderbookId target_book) : target_book_(target_book) {
+    if (target_book == 0) {
+        std::cerr << "[ERROR] StrategySweep: Invalid target_book (0)\n";
+    }
+}
+
+/**
+ * @details Implementation notes:
+ * - Same validation as the Strategy constructor, plus gap > tight
+ * - Rejected sets are not added (returns size() unchanged as index)
+ */
+size_t StrategySweep::add(const SweepParams& p)
+{
+    if (p.order_quantity == 0 || p.max_position <= p.min_position || p.gap_spread <= p.tight_spread) {
+        std::cerr << "[ERROR] StrategySweep: Invalid parameter set qty=" << p.order_quantity
+                  << " max=" << p.max_position << " min=" << p.min_position
+                  << " tight=" << p.tight_spread << " gap=" << p.gap_spread << "\n";
+        return size();
+    }
+
+    order_quantity_.push_back(static_cast<int64_t>(p.order_quantity));
+    max_position_.push_back(p.max_position);
+    min_position_.push_back(p.min_position);
+    tight_spread_.push_back(static_cast<int64_t>(p.tight_spread));
+    gap_spread_.push_back(static_cast<int64_t>(p.gap_spread));
+
+    position_.push_back(0);
+    realized_pnl_.push_back(0);
+    trades_.push_back(0);
+    return size() - 1;
+}
+
+void StrategySweep::add_grid(const std::vector<Quantity>& quantities,
+                             const std::vector<Position>& max_positions,
+                             const std::vector<Position>& min_positions,
+                             const std::vector<Price>& ticks,
+                             const std::vector<Price>& gap_ticks)
+{
+    for (Quantity q : quantities)
+        for (Position mx : max_positions)
+            for (Position mn : min_positions)
+                for (Price tick : ticks)
+                    for (Price g : gap_ticks) {
+                        SweepParams p;
+                        p.order_quantity = q;
+                        p.max_position   = mx;
+                        p.min_position   = mn;
+                        p.tight_spread   = tick;
+                        p.gap_spread     = g * tick;
+                        add(p);
+                    }
+}
+
+SweepParams StrategySweep::params(size_t i) const
+{
+    SweepParams p;
+    p.order_quantity = static_cast<Quantity>(order_quantity_[i]);
+    p.max_position   = max_position_[i];
+    p.min_position   = min_position_[i];
+    p.tight_spread   = static_cast<Price>(tight_spread_[i]);
+    p.gap_spread     = static_cast<Price>(gap_spread_[i]);
+    return p;
+}
+
+/**
+ * @details Implementation notes:
+ * - Shared control flow identical to Strategy::on_batch
+ * - Per-instance work only when the top of book moved since the last batch
+ *   (an unchanged top can never turn a tight spread into a gap)
+ */
+void StrategySweep::on_batch(Timestamp ns,
+                             const Orderbook& ob,
+                             const std::vector<Event>& batch)
+{
+    (void)ns;
+    if (day_closed_ || batch.empty()) return;
+
+    // Hard stop on market close
+    for (const auto& event : batch) {
+        if (event.type == MessageType::OrderbookState &&
+            event.orderbook_state == MARKET_CLOSE_STATE) {
+            settle_eod(ob);
+            return;
+        }
+    }
+
+    if (!ob.trading_open() || !ob.has_top()) return;
+
+    const Price curr_bid = ob.best_bid_price();
+    const Price curr_ask = ob.best_ask_price();
+
+    if (have_prev_ && (curr_bid != prev_bid_ || curr_ask != prev_ask_)) {
+        update_all(curr_bid, curr_ask);
+    }
+
+    prev_bid_  = curr_bid;
+    prev_ask_  = curr_ask;
+    have_prev_ = true;
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(k) where k = number of parameter sets
+ * - Branch-free body over plain int64 arrays so GCC/Clang vectorize it
+ * - Buy takes precedence over sell, as in Strategy::on_batch
+ */
+void StrategySweep::update_all(Price curr_bid, Price curr_ask)
+{
+    const int64_t prev_bid    = prev_bid_;
+    const int64_t prev_ask    = prev_ask_;
+    const int64_t prev_spread = prev_ask - prev_bid;
+    const int64_t curr_spread = static_cast<int64_t>(curr_ask) - static_cast<int64_t>(curr_bid);
+    const int64_t ask_up      = static_cast<int64_t>(curr_ask) - prev_ask;   // vanished ask distance
+    const int64_t bid_down    = prev_bid - static_cast<int64_t>(curr_bid);   // vanished bid distance
+    const int64_t bid_same    = curr_bid == prev_bid_;
+    const int64_t ask_same    = curr_ask == prev_ask_;
+
+    const size_t n = size();
+    const int64_t* qty   = order_quantity_.data();
+    const int64_t* maxp  = max_position_.data();
+    const int64_t* minp  = min_position_.data();
+    const int64_t* tight = tight_spread_.data();
+    const int64_t* gap   = gap_spread_.data();
+    int64_t* pos    = position_.data();
+    int64_t* pnl    = realized_pnl_.data();
+    int64_t* trades = trades_.data();
+
+    for (size_t i = 0; i < n; ++i) {
+        const int64_t tick = gap[i] - tight[i];
+        const int64_t armed = (prev_spread == tight[i]) & (curr_spread == gap[i]);
+        const int64_t buy  = armed & bid_same & (ask_up == tick);
+        const int64_t sell = armed & (buy ^ 1) & ask_same & (bid_down == tick);
+
+        const int64_t room_buy  = maxp[i] - pos[i];
+        const int64_t room_sell = pos[i] - minp[i];
+        const int64_t fill_buy  = buy  * (room_buy  > 0) * (qty[i] < room_buy  ? qty[i] : room_buy);
+        const int64_t fill_sell = sell * (room_sell > 0) * (qty[i] < room_sell ? qty[i] : room_sell);
+
+        pos[i]    += fill_buy - fill_sell;
+        pnl[i]    += fill_sell * prev_bid - fill_buy * prev_ask;
+        trades[i] += (fill_buy > 0) + (fill_sell > 0);
+    }
+}
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(k)
+ * - Marks every open position at the last executed price
+ */
+void StrategySweep::settle_eod(const Orderbook& ob)
+{
+    const int64_t last_price = ob.last_exec_price();
+    if (last_price != 0) {
+        for (size_t i = 0; i < size(); ++i) {
+            realized_pnl_[i] += position_[i] * last_price;
+        }
+    }
+    day_closed_ = true;
+}
+
+void StrategySweep::end_of_day(const Orderbook& ob) {
+    settle_eod(ob);
+}
+
+void StrategySweep::write_results(std::ostream& out) const
+{
+    out << std::setw(6) << "id"
+        << std::setw(8) << "qty"
+        << std::setw(8) << "max"
+        << std::setw(8) << "min"
+        << std::setw(7) << "tight"
+        << std::setw(7) << "gap"
+        << std::setw(8) << "trades"
+        << std::setw(8) << "pos"
+        << std::setw(14) << "pnl" << "\n";
+    for (size_t i = 0; i < size(); ++i) {
+        out << std::setw(6) << i
+            << std::setw(8) << order_quantity_[i]
+            << std::setw(8) << max_position_[i]
+            << std::setw(8) << min_position_[i]
+            << std::setw(7) << tight_spread_[i]
+            << std::setw(7) << gap_spread_[i]
+            << std::setw(8) << trades_[i]
+            << std::setw(8) << position_[i]
+            << std::setw(14) << realized_pnl_[i] << "\n";
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "types/event.h"
+#include "orderbook.h"
+#include <ostream>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief One parameter set evaluated by StrategySweep
+ *
+ * @details Mirrors the Strategy constructor arguments plus the spread
+ * thresholds that Strategy keeps as file-scope constants. The vanished
+ * level must sit exactly (gap_spread - tight_spread) away from the old top.
+ */
+struct SweepParams
+{
+	Quantity order_quantity = 100;   ///< Size of each simulated fill
+	Position max_position   = 1000;  ///< Maximum long position allowed
+	Position min_position   = 0;     ///< Minimum position allowed (negative = short)
+	Price    tight_spread   = 10;    ///< Spread that arms the strategy
+	Price    gap_spread     = 20;    ///< Spread that triggers a trade
+};
+
+/**
+ * @brief Runs many gap-strategy parameter sets over a single book replay
+ *
+ * @details Drop-in replacement for Strategy in replay_day(): the batch
+ * bookkeeping (close detection, trading/top checks, previous top) is shared
+ * by every instance since all of them watch the same book. Per-instance
+ * parameters and state are kept as structure-of-arrays and updated with a
+ * branch-free loop the compiler can vectorize, and only on batches where the
+ * best bid or ask actually moved.
+ */
+class StrategySweep
+{
+public:
+	/**
+	 * @brief Constructs an empty sweep for one order book
+	 * @param target_book Order book ID every instance trades
+	 */
+	explicit StrategySweep(OrderbookId target_book);
+
+	/**
+	 * @brief Adds one parameter set
+	 * @param params Parameters of the new instance
+	 * @return Index of the instance in the result table
+	 *
+	 * @details Must be called before the replay starts. Invalid sets
+	 * (zero quantity, max <= min, gap <= tight) are rejected with an error log.
+	 */
+	size_t add(const SweepParams& params);
+
+	/**
+	 * @brief Adds the cartesian product of the given parameter values
+	 * @param quantities Order quantities to try
+	 * @param max_positions Maximum positions to try
+	 * @param min_positions Minimum positions to try
+	 * @param ticks Tick sizes; tight spread = 1 tick
+	 * @param gap_ticks Gap spread expressed in ticks of the tight spread
+	 */
+	void add_grid(const std::vector<Quantity>& quantities,
+	              const std::vector<Position>& max_positions,
+	              const std::vector<Position>& min_positions,
+	              const std::vector<Price>& ticks,
+	              const std::vector<Price>& gap_ticks);
+
+	/**
+	 * @brief Processes a batch of events for every instance
+	 * @param ns Nanosecond timestamp of the batch
+	 * @param ob Current order book state
+	 * @param batch Vector of events in this time batch
+	 *
+	 * @details Same contract as Strategy::on_batch.
+	 */
+	void on_batch(	Timestamp ns,
+					const Orderbook& ob,
+					const std::vector<Event>& batch);
+
+	/**
+	 * @brief Settles every instance at the last executed price
+	 * @param ob Final order book state for settlement
+	 */
+	void end_of_day(const Orderbook& ob);
+
+	// Per-instance results
+	size_t  size() const { return order_quantity_.size(); }
+	SweepParams params(size_t i) const;
+	int64_t position(size_t i) const { return position_[i]; }
+	int64_t realized_pnl(size_t i) const { return realized_pnl_[i]; }
+	int64_t trades(size_t i) const { return trades_[i]; }
+
+	/**
+	 * @brief Writes one row per parameter set (params, trades, position, P&L)
+	 * @param out Destination stream
+	 */
+	void write_results(std::ostream& out) const;
+
+private:
+	OrderbookId target_book_;    // target order book id
+
+	// Parameters (SoA)
+	std::vector<int64_t> order_quantity_;
+	std::vector<int64_t> max_position_;
+	std::vector<int64_t> min_position_;
+	std::vector<int64_t> tight_spread_;
+	std::vector<int64_t> gap_spread_;
+
+	// Per-instance state (SoA)
+	std::vector<int64_t> position_;
+	std::vector<int64_t> realized_pnl_;
+	std::vector<int64_t> trades_;
+
+	// Shared state
+	Price prev_bid_ = 0;          // previous best bid price for gap detection
+	Price prev_ask_ = 0;          // previous best ask price for gap detection
+	bool  day_closed_ = false;    // flag indicating end-of-day has been processed
+	bool  have_prev_  = false;    // flag indicating we have previous prices
+
+	/**
+	 * @brief Applies one top-of-book transition to every instance
+	 * @param curr_bid Best bid after the batch
+	 * @param curr_ask Best ask after the batch
+	 */
+	void update_all(Price curr_bid, Price curr_ask);
+
+	/**
+	 * @brief Settles all positions at the last executed price
+	 * @param ob Final order book state for settlement
+	 */
+	void settle_eod(const Orderbook& ob);
+};
@@ -0,0 +1,40 @@
+#include "tick_size.h"
+#include <algorithm>
+
+/**
+ * @details Implementation notes:
+ * - BIST equity price steps (TL): <20: 0.01, <50: 0.02, <100: 0.05,
+ *   <250: 0.10, <500: 0.25, <1000: 0.50, <2500: 1.00, >=2500: 2.50
+ * - Band limits and ticks are scaled by units_per_lira (ticks expressed
+ *   in 1/1000 TL below, hence the division)
+ */
+TickTable TickTable::bist_equity(Price units_per_lira)
+{
+    struct Row { Price from_lira; Price tick_milli; };
+    static const Row ROWS[] = {
+        {    0,   10 }, {   20,   20 }, {   50,   50 }, {  100,  100 },
+        {  250,  250 }, {  500,  500 }, { 1000, 1000 }, { 2500, 2500 },
+    };
+
+    TickTable table(ROWS[0].tick_milli * units_per_lira / 1000);
+    for (const Row& r : ROWS) {
+        table.set_band(r.from_lira * units_per_lira, r.tick_milli * units_per_lira / 1000);
+    }
+    return table;
+}
+
+/**
+ * @details Implementation notes:
+ * - Keeps bands sorted by lower bound; same lower bound replaces the tick
+ * - Tables are built once at startup, so O(n) insertion is fine
+ */
+void TickTable::set_band(Price from, Price tick)
+{
+    auto it = std::lower_bound(bands_.begin(), bands_.end(), from,
+                               [](const TickBand& b, Price p) { return b.from < p; });
+    if (it != bands_.end() && it->from == from) {
+        it->tick = tick;
+    } else {
+        bands_.insert(it, TickBand{from, tick});
+    }
+}
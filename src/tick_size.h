@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "types/usings.h"
+
+/**
+ * @brief Tick size that applies from a given price upwards
+ */
+struct TickBand
+{
+    Price from;      ///< First price (inclusive) of the band
+    Price tick;      ///< Price increment inside the band
+};
+
+/**
+ * @brief Price-band tick size table for one instrument
+ *
+ * @details Bands are kept sorted by their lower bound; a table has at most a
+ * handful of bands, so lookups are a short linear scan from the top band.
+ * Prices are in feed units (kuruş * 10 for BIST equities, i.e. 1000 per TL).
+ */
+class TickTable
+{
+public:
+    /**
+     * @brief Constructs a single-band table
+     * @param tick Tick size for every price
+     */
+    explicit TickTable(Price tick = 10) { bands_.push_back(TickBand{0, tick}); }
+
+    /**
+     * @brief BIST equity market price-band tick rules
+     * @param units_per_lira Feed price units per 1 TL (1000 for 3 decimals)
+     * @return Table with the 8 BIST equity bands (0.01 TL up to 2.50 TL)
+     */
+    static TickTable bist_equity(Price units_per_lira = 1000);
+
+    /**
+     * @brief Adds or replaces the band starting at a price
+     * @param from First price of the band
+     * @param tick Tick size inside the band
+     */
+    void set_band(Price from, Price tick);
+
+    /**
+     * @brief Tick size of the band containing a price
+     * @param price Price to look up
+     * @return Step from price to the next higher valid price
+     */
+    Price tick_at(Price price) const {
+        for (size_t i = bands_.size(); i-- > 1; ) {
+            if (price >= bands_[i].from) return bands_[i].tick;
+        }
+        return bands_[0].tick;
+    }
+
+    /**
+     * @brief Step from a price down to the next lower valid price
+     * @param price Price to look up
+     * @return Tick of the band containing price - 1
+     */
+    Price tick_below(Price price) const { return tick_at(price == 0 ? 0 : price - 1); }
+
+    bool  uniform() const { return bands_.size() == 1; }     ///< Single band?
+    Price uniform_tick() const { return bands_[0].tick; }    ///< Tick of the lowest band
+    const std::vector<TickBand>& bands() const { return bands_; }
+
+private:
+    std::vector<TickBand> bands_;    ///< Bands sorted by lower bound
+};
+
+/**
+ * @brief Tick tables keyed by order book id, with a fallback table
+ *
+ * @details One registry can be shared by strategies on many books; books
+ * without an explicit table use the default one.
+ */
+class TickTableRegistry
+{
+public:
+    explicit TickTableRegistry(const TickTable& fallback = TickTable()) : fallback_(fallback) {}
+
+    void set(OrderbookId book, const TickTable& table) { tables_[book] = table; }
+    TickTable& table(OrderbookId book) { return tables_.emplace(book, fallback_).first->second; }
+
+    const TickTable& for_book(OrderbookId book) const {
+        auto it = tables_.find(book);
+        return it == tables_.end() ? fallback_ : it->second;
+    }
+
+private:
+    TickTable fallback_;                                  ///< Used for unknown books
+    std::unordered_map<OrderbookId, TickTable> tables_;   ///< Per-book tables
+};
+
+// ---------------------------------------------------------------------------
+// Tick policies for gap detection. ConstantTick folds the tick into the
+// comparisons at compile time; UniformTick/BandTick read it at runtime.
+// ---------------------------------------------------------------------------
+
+template <Price Tick>
+struct ConstantTick
+{
+    static constexpr Price up(Price)   { return Tick; }
+    static constexpr Price down(Price) { return Tick; }
+};
+
+struct UniformTick
+{
+    Price tick;
+    Price up(Price) const   { return tick; }
+    Price down(Price) const { return tick; }
+};
+
+struct BandTick
+{
+    const TickTable* table;
+    Price up(Price p) const   { return table->tick_at(p); }
+    Price down(Price p) const { return table->tick_below(p); }
+};
+
+/**
+ * @brief Outcome of comparing two top-of-book snapshots
+ */
+enum class GapSignal : uint8_t
+{
+    None,               ///< No tight -> 1-tick gap transition
+    BuyVanishedAsk,     ///< Bid unchanged, ask moved up one step
+    SellVanishedBid     ///< Ask unchanged, bid moved down one step
+};
+
+/**
+ * @brief Detects a tight spread turning into a one-level gap
+ * @param t Tick policy
+ * @param prev_bid Best bid of the previous snapshot
+ * @param prev_ask Best ask of the previous snapshot
+ * @param curr_bid Current best bid
+ * @param curr_ask Current best ask
+ * @return Which side vanished, or GapSignal::None
+ *
+ * @details Previous snapshot must be tight (ask one step above bid) and
+ * exactly one side must have moved away by exactly one step.
+ */
+template <typename TickPolicy>
+inline GapSignal detect_gap(const TickPolicy& t,
+                            Price prev_bid, Price prev_ask,
+                            Price curr_bid, Price curr_ask)
+{
+    if (prev_ask - prev_bid != t.up(prev_bid)) return GapSignal::None;
+    if (curr_bid == prev_bid && curr_ask - prev_ask == t.up(prev_ask)) return GapSignal::BuyVanishedAsk;
+    if (curr_ask == prev_ask && prev_bid - curr_bid == t.down(prev_bid)) return GapSignal::SellVanishedBid;
+    return GapSignal::None;
+}
@@ -0,0 +1,63 @@
+#include "top_levels.h"
+
+/**
+ * @details Implementation notes:
+ * - Time complexity: O(1) for levels behind a full window, O(K) otherwise
+ * - Insertions push the worst level out of a full window
+ */
+bool TopLevels::update(Price price, Quantity aggregate, uint32_t num_orders)
+{
+    if (size_ == CAPACITY && better(worst().price, price)) return false;
+
+    size_t i = 0;
+    while (i < size_ && better(levels_[i].price, price)) ++i;
+
+    if (i < size_ && levels_[i].price == price) {
+        if (num_orders == 0) {
+            const bool was_full = full();
+            for (size_t j = i + 1; j < size_; ++j) levels_[j - 1] = levels_[j];
+            --size_;
+            rebuild_from(i);
+            return was_full;
+        }
+        levels_[i].aggregate = aggregate;
+        levels_[i].num_orders = num_orders;
+        rebuild_from(i);
+        return false;
+    }
+
+    if (num_orders == 0) return false;
+    const size_t last = full() ? CAPACITY - 1 : size_++;
+    for (size_t j = last; j > i; --j) levels_[j] = levels_[j - 1];
+    levels_[i].price = price;
+    levels_[i].aggregate = aggregate;
+    levels_[i].num_orders = num_orders;
+    rebuild_from(i);
+    return false;
+}
+
+void TopLevels::push_worst(const LevelStats& level)
+{
+    if (full()) return;
+    levels_[size_++] = level;
+    rebuild_from(size_ - 1);
+}
+
+size_t TopLevels::count_to(Price limit) const
+{
+    size_t lo = 0, hi = size_;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (better(limit, levels_[mid].price)) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+void TopLevels::rebuild_from(size_t i)
+{
+    for (size_t j = i; j < size_; ++j) {
+        cum_qty_[j + 1] = cum_qty_[j] + levels_[j].aggregate;
+        cum_orders_[j + 1] = cum_orders_[j] + levels_[j].num_orders;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "types/usings.h"
+
+/**
+ * @brief Aggregate state of one price level
+ */
+struct LevelStats
+{
+    Price    price = 0;         ///< Level price
+    Quantity aggregate = 0;     ///< Total quantity at the level
+    uint32_t num_orders = 0;    ///< Number of orders at the level
+};
+
+/**
+ * @brief The best K levels of one book side with running prefix sums
+ *
+ * @details Flat array of the K best levels, best first, next to prefix sums
+ * of quantity and order count, so depth over the top k levels is one array
+ * read and a visit over them touches K contiguous entries. The owner
+ * reports every level change through update(); a change outside the window
+ * is rejected with a single comparison. When a level inside a full window
+ * disappears, the owner refills the last slot with push_worst() from its
+ * own price tree.
+ *
+ * Only levels with orders are kept (same rule as Orderbook::find_level).
+ */
+class TopLevels
+{
+public:
+    static constexpr size_t CAPACITY = 16;   ///< K: levels kept per side
+
+    /**
+     * @param descending true for bids (best = highest), false for asks
+     */
+    explicit TopLevels(bool descending) : descending_(descending) {}
+
+    /**
+     * @brief Applies the new state of one level
+     * @param price Level price
+     * @param aggregate New total quantity
+     * @param num_orders New order count (0 = level removed)
+     * @return true if a full window lost a level and needs push_worst()
+     */
+    bool update(Price price, Quantity aggregate, uint32_t num_orders);
+
+    /**
+     * @brief Appends the next level behind the current worst one (refill)
+     */
+    void push_worst(const LevelStats& level);
+
+    size_t size() const { return size_; }
+    bool   full() const { return size_ == CAPACITY; }
+    const LevelStats& operator[](size_t i) const { return levels_[i]; }
+    const LevelStats& worst() const { return levels_[size_ - 1]; }
+
+    /// Quantity over the best min(k, size) levels, O(1)
+    Quantity depth(size_t k) const { return cum_qty_[k < size_ ? k : size_]; }
+
+    /// Orders over the best min(k, size) levels, O(1)
+    uint64_t orders(size_t k) const { return cum_orders_[k < size_ ? k : size_]; }
+
+    /**
+     * @brief Number of cached levels priced at least as well as limit, O(log K)
+     */
+    size_t count_to(Price limit) const;
+
+    /// true if price a ranks ahead of price b on this side
+    bool better(Price a, Price b) const { return descending_ ? a > b : a < b; }
+
+    void clear() { size_ = 0; }
+
+private:
+    bool       descending_;
+    size_t     size_ = 0;
+    LevelStats levels_[CAPACITY];
+    Quantity   cum_qty_[CAPACITY + 1] = {};      ///< cum_qty_[i] = quantity of levels [0, i)
+    uint64_t   cum_orders_[CAPACITY + 1] = {};   ///< cum_orders_[i] = orders of levels [0, i)
+
+    /// Recomputes the prefix sums from slot i to the end
+    void rebuild_from(size_t i);
+};
@@ -10,9 +10,23 @@
  * @details This struct holds all possible fields from ITCH protocol messages.
  * Not all fields are used for every message type:
  * - AddOrder: uses order_id, side, quantity, price, ranking_time, ranking_seq_num
- * - ExecuteOrder: uses order_id, side, quantity
+ * - ExecuteOrder: uses order_id, side, quantity, match_id
+ * - ExecuteWithPrice: as ExecuteOrder, price = trade price, printable, at_cross
+ * - ReplaceOrder: uses order_id, side, quantity, price, ranking_seq_num (new values)
  * - DeleteOrder: uses order_id, side
+ * - Trade: uses match_id, side, quantity, price, printable, at_cross (no book change)
+ * - EquilibriumPrice: price = equilibrium, quantity/ask_quantity = matched
+ *   bid/ask volume, best_bid/best_ask
  * - OrderbookState: uses orderbook_state
+ * - OrderbookDirectory: uses symbol, price_decimals, round_lot
+ * - TickSize: uses tick_size, price (from) and price_to
+ * - CombinationLeg: orderbook_id = combination, leg_orderbook_id, side, leg_ratio
+ * - SystemEvent: uses event_code
+ * - Seconds: only timestamp (the new second); carries no order book
+ *
+ * nanosec is the raw 32-bit offset within the second; timestamp adds the
+ * seconds of the last 'T' message, so it increases across seconds and
+ * is the field to batch, order and measure latency on.
  */
 struct Event {
     Event() = default;  
@@ -22,6 +36,7 @@ struct Event {
 
     // Time fields
     Nanoseconds   nanosec = 0;
+    Timestamp     timestamp = 0;
     RankingTime   ranking_time = 0;
 
     // Order book and order identifiers
@@ -34,8 +49,28 @@ struct Event {
     Price         price = 0;
     RankingSeqNum ranking_seq_num = 0;
 
-    // Orderbook state message
+    // Executions and trades
+    uint64_t      match_id = 0;
+    bool          printable = false;
+    bool          at_cross = false;        ///< Occurred at an auction cross
+
+    // Equilibrium price update (auction)
+    Quantity      ask_quantity = 0;        ///< Matched ask volume (quantity = bid volume)
+    Price         best_bid = 0;
+    Price         best_ask = 0;
+
+    // Reference data
+    uint64_t      tick_size = 0;           ///< TickSize: tick for [price, price_to]
+    Price         price_to = 0;
+    OrderbookId   leg_orderbook_id = 0;
+    uint32_t      leg_ratio = 0;
+    uint32_t      round_lot = 0;
+    uint16_t      price_decimals = 0;
+    char          event_code = 0;          ///< SystemEvent code
+
+    // Orderbook state message / directory symbol
     OrderbookState orderbook_state;
+    std::string   symbol;
 };
 
 
@@ -0,0 +1,18 @@
+#pragma once
+#include "usings.h"
+#include "side.h"
+
+/**
+ * @brief Per-level L2 update emitted by the order book
+ *
+ * @details Carries the new state of one price level after an applied event.
+ * aggregate == 0 and num_orders == 0 means the level was removed.
+ * Replaying the deltas in order reproduces the book's aggregated depth.
+ */
+struct LevelDelta {
+    Timestamp     timestamp = 0;            ///< Full timestamp of the causing event
+    Price         price = 0;                ///< Level price
+    Quantity      aggregate = 0;            ///< New total quantity at the level
+    uint32_t      num_orders = 0;           ///< New number of orders at the level
+    Side          side = Side::Unknown;     ///< Book side of the level
+};
@@ -9,9 +9,24 @@
  * used in the ITCH protocol specification.
  */
 enum class MessageType : uint8_t {
-    OrderbookState = 'O',
-    AddOrder       = 'A',
-    ExecuteOrder   = 'E',
-    DeleteOrder    = 'D',
-    Other          = 0
+    // Time and reference data
+    Seconds            = 'T',
+    OrderbookDirectory = 'R',
+    CombinationLeg     = 'M',
+    TickSize           = 'L',
+    SystemEvent        = 'S',
+    OrderbookState     = 'O',
+
+    // Order book updates
+    AddOrder           = 'A',
+    ExecuteOrder       = 'E',
+    ExecuteWithPrice   = 'C',
+    ReplaceOrder       = 'U',
+    DeleteOrder        = 'D',
+
+    // Trades and auctions
+    Trade              = 'P',
+    EquilibriumPrice   = 'Z',
+
+    Other              = 0
 };
@@ -0,0 +1,22 @@
+#pragma once
+#include "usings.h"
+#include "side.h"
+#include "message_type.h"
+
+/**
+ * @brief Quantity that left one priority slot of a price level
+ *
+ * @details Emitted by the order book for executions, deletions and
+ * replaces, with the priority the order had before the event, so a queue
+ * simulator can tell whether the quantity stood ahead of or behind its own
+ * resting orders. Adds are not reported: a new order always queues behind.
+ */
+struct QueueChange {
+    Timestamp     timestamp = 0;                ///< Full timestamp of the causing event
+    Price         price = 0;                    ///< Level the quantity left
+    Quantity      quantity = 0;                 ///< Quantity removed from the level
+    RankingTime   ranking_time = 0;             ///< Priority of the order it belonged to
+    RankingSeqNum ranking_seq_num = 0;          ///< Tie-break of the priority
+    MessageType   cause = MessageType::Other;   ///< Execute* = traded, Delete/Replace = withdrawn
+    Side          side = Side::Unknown;         ///< Book side of the level
+};
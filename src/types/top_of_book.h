@@ -0,0 +1,22 @@
+#pragma once
+#include "usings.h"
+#include "side.h"
+#include "message_type.h"
+
+/**
+ * @brief Best bid/ask transition emitted by the order book
+ *
+ * @details Produced only when an applied event changes the best bid or best
+ * ask price (quantity-only changes at the top are not reported). A price of
+ * 0 means the side is empty.
+ */
+struct TopOfBookChanged {
+    Timestamp     timestamp = 0;                ///< Full timestamp of the causing event
+    Price         old_bid = 0;                  ///< Best bid before the event
+    Price         new_bid = 0;                  ///< Best bid after the event
+    Price         old_ask = 0;                  ///< Best ask before the event
+    Price         new_ask = 0;                  ///< Best ask after the event
+    OrderId       order_id = 0;                 ///< Order touched by the causing event
+    MessageType   cause = MessageType::Other;   ///< Type of the causing event
+    Side          side = Side::Unknown;         ///< Book side touched by the causing event
+};
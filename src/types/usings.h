@@ -15,6 +15,7 @@
 // Time types
 using Nanoseconds = std::uint32_t;
 using RankingTime = std::uint64_t;
+using Timestamp = std::uint64_t;     // ns since midnight: seconds ('T') * 1e9 + Nanoseconds
 
 // Order book types  
 using OrderbookId = std::uint32_t;
@@ -25,6 +26,7 @@ using OrderId = std::uint64_t;
 using Quantity = std::uint64_t;
 using Price = std::uint32_t;
 using RankingSeqNum = std::uint32_t;
+using Position = std::int64_t;     // signed net position: long > 0, short < 0
 
 // Display types
 using DisplayLevel = std::vector<std::pair<Price, Quantity>>;
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "itch_parser.h"
+#include "moldudp64.h"
+#include "mold_retransmit.h"
+#include "mold_sequencer.h"
+#include "feed_arbiter.h"
+#include "udp_receiver.h"
+#include "types/event.h"
+
+/**
+ * @brief Live packet source: UDP datagrams decoded by ItchParser
+ *
+ * @details Exposes the same good()/next_packet() interface as a file-backed
+ * ItchParser, so the replay loop runs unchanged on a live feed. Datagrams
+ * pass through a MoldSequencer, so events are only ever delivered in
+ * sequence; in-order datagrams are decoded straight from the receive
+ * buffer. The feed ends at the MoldUDP64 end-of-session or stop().
+ *
+ * With two receivers the feed arbitrates redundant A/B lines: whichever
+ * copy of a packet arrives first is used (see FeedArbiter). A blocking
+ * wait then polls both sockets at once.
+ *
+ * Gaps are recovered through a MoldRequestClient when one is set;
+ * requests are repeated every gap_timeout_ns while the gap stays open.
+ * Without a client the gap is skipped after gap_timeout_ns (the book is
+ * then wrong and a warning is logged).
+ */
+class UdpFeed
+{
+public:
+    /**
+     * @param rx Bound receiver
+     * @param parser Parser used for decoding (its stream is not touched)
+     * @param spin Poll without blocking (pair with busy_poll_us)
+     */
+    UdpFeed(UdpReceiver& rx, ItchParser& parser, bool spin = false)
+    : parser_(parser), spin_(spin), lines_(1) { rx_[0] = &rx; rx_[1] = nullptr; }
+
+    /**
+     * @param line_a Receiver of line A
+     * @param line_b Receiver of line B (same session, same sequence numbers)
+     * @param parser Parser used for decoding (its stream is not touched)
+     * @param spin Poll without blocking (pair with busy_poll_us)
+     */
+    UdpFeed(UdpReceiver& line_a, UdpReceiver& line_b, ItchParser& parser, bool spin = false)
+    : parser_(parser), spin_(spin), lines_(2) { rx_[0] = &line_a; rx_[1] = &line_b; }
+
+    bool good() const { return !done_; }
+    void stop() { done_ = true; }
+
+    /**
+     * @brief Uses a request server to fill gaps
+     * @param client Request client (not owned), nullptr to skip gaps instead
+     */
+    void set_recovery(MoldRequestClient* client) { recovery_ = client; }
+
+    /**
+     * @brief Time a gap may stay open before re-requesting / skipping it
+     */
+    void set_gap_timeout_ns(uint64_t ns) { gap_timeout_ns_ = ns; }
+
+    /**
+     * @brief Decodes the next datagram
+     * @return Events released in sequence (possibly several packets' worth
+     *         when a gap closes); empty on heartbeat, duplicate or timeout
+     */
+    std::vector<Event> next_packet();
+
+    const mold::PacketHeader& last_header() const { return header_; }   ///< Header of the last datagram
+    uint64_t last_rx_ns() const { return rx_ns_; }   ///< Kernel receive stamp of the last datagram
+    uint64_t packets() const { return packets_; }    ///< Datagrams taken from the sockets
+    int last_line() const { return last_line_; }     ///< Line of the last datagram
+    const MoldSequencer& sequencer() const { return arb_.sequencer(); }
+    const ArbiterStats& arbitration() const { return arb_.stats(); }
+
+private:
+    UdpReceiver* rx_[2];                  ///< Line receivers (not owned)
+    ItchParser&  parser_;
+    bool         spin_;
+    int          lines_;                  ///< 1 or 2
+    bool         done_ = false;
+    size_t       pending_[2] = {0, 0};    ///< Datagrams in each line's receive batch
+    size_t       next_[2] = {0, 0};       ///< Next datagram of each batch to decode
+    int          turn_ = 0;               ///< Line checked first on the next call
+    int          last_line_ = 0;          ///< Line of the last datagram
+    mold::PacketHeader header_{};         ///< Last decoded header
+    uint64_t     rx_ns_ = 0;              ///< Last receive timestamp
+    uint64_t     packets_ = 0;            ///< Datagram counter
+
+    FeedArbiter        arb_;              ///< In-order release across lines
+    MoldRequestClient* recovery_ = nullptr;   ///< Retransmission client (not owned)
+    uint64_t gap_timeout_ns_ = 1000000;   ///< 1 ms
+    uint64_t gap_since_ns_ = 0;           ///< When the open gap was last (re)requested
+    std::vector<char> response_;          ///< Retransmitted packet buffer
+
+    bool take(int& line, size_t& index);
+    void release_ready(std::vector<Event>& events);
+    void handle_gap(std::vector<Event>& events);
+};
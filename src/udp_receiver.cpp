@@ -0,0 +1,179 @@
+#include "udp_receiver.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+    constexpr size_t CONTROL_SIZE = CMSG_SPACE(sizeof(timespec));
+
+    void warn_opt(const char* what) {
+        std::cerr << "[WARN] UDP " << what << " failed: " << std::strerror(errno) << std::endl;
+    }
+}
+
+/**
+ * @details Implementation notes:
+ * - SO_REUSEADDR lets several receivers (A/B lines, tools) share a group port
+ * - SO_RCVBUF is a request; the kernel caps it at net.core.rmem_max, so the
+ *   effective size is checked and reported if smaller
+ * - SO_BUSY_POLL needs CAP_NET_ADMIN on some kernels; failure is a warning
+ * - Buffers, iovecs and control blocks are wired once here
+ */
+UdpReceiver::UdpReceiver(const UdpReceiverConfig& config)
+    : batch_(config.batch == 0 ? 1 : config.batch)
+    , max_datagram_(config.max_datagram)
+    , timestamps_(config.kernel_timestamps)
+    , timeout_ms_(config.timeout_ms)
+{
+    buffers_.resize(batch_ * max_datagram_);
+    iovs_.resize(batch_);
+    msgs_.resize(batch_);
+    controls_.resize(batch_ * CONTROL_SIZE);
+    stamps_.assign(batch_, 0);
+
+    for (size_t i = 0; i < batch_; ++i) {
+        iovs_[i].iov_base = &buffers_[i * max_datagram_];
+        iovs_[i].iov_len  = max_datagram_;
+        std::memset(&msgs_[i], 0, sizeof(mmsghdr));
+        msgs_[i].msg_hdr.msg_iov    = &iovs_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cerr << "[ERROR] UDP socket failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    const int one = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0) warn_opt("SO_REUSEADDR");
+
+    if (config.rcvbuf_bytes > 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &config.rcvbuf_bytes, sizeof(int)) != 0) {
+            warn_opt("SO_RCVBUF");
+        }
+    }
+    if (config.busy_poll_us > 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &config.busy_poll_us, sizeof(int)) != 0) {
+            warn_opt("SO_BUSY_POLL");
+        }
+    }
+    if (timestamps_) {
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) != 0) {
+            warn_opt("SO_TIMESTAMPNS");
+            timestamps_ = false;
+        }
+    }
+    if (config.timeout_ms > 0) {
+        timeval tv;
+        tv.tv_sec  = config.timeout_ms / 1000;
+        tv.tv_usec = (config.timeout_ms % 1000) * 1000;
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) != 0) warn_opt("SO_RCVTIMEO");
+    }
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(config.port);
+    if (inet_pton(AF_INET, config.bind_addr.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "[ERROR] UDP bad bind address: " << config.bind_addr << std::endl;
+        close(fd);
+        return;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "[ERROR] UDP bind " << config.bind_addr << ":" << config.port
+                  << " failed: " << std::strerror(errno) << std::endl;
+        close(fd);
+        return;
+    }
+
+    if (!config.group.empty()) {
+        ip_mreq mreq;
+        if (inet_pton(AF_INET, config.group.c_str(), &mreq.imr_multiaddr) != 1 ||
+            inet_pton(AF_INET, config.iface_addr.c_str(), &mreq.imr_interface) != 1) {
+            std::cerr << "[ERROR] UDP bad multicast group/interface: " << config.group << std::endl;
+            close(fd);
+            return;
+        }
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            std::cerr << "[ERROR] UDP join " << config.group << " failed: " << std::strerror(errno) << std::endl;
+            close(fd);
+            return;
+        }
+    }
+
+    fd_ = fd;
+
+    if (config.rcvbuf_bytes > 0 && rcvbuf_bytes() < config.rcvbuf_bytes) {
+        std::cerr << "[WARN] UDP SO_RCVBUF capped at " << rcvbuf_bytes()
+                  << " bytes (requested " << config.rcvbuf_bytes << ", see net.core.rmem_max)" << std::endl;
+    }
+}
+
+UdpReceiver::~UdpReceiver()
+{
+    if (fd_ >= 0) close(fd_);
+}
+
+/**
+ * @details Implementation notes:
+ * - MSG_WAITFORONE blocks for the first datagram only, then drains whatever
+ *   else is queued up to batch_; MSG_DONTWAIT never blocks
+ * - msg_controllen must be reset before every call (the kernel overwrites it)
+ */
+size_t UdpReceiver::receive(bool block)
+{
+    if (fd_ < 0) return 0;
+
+    for (size_t i = 0; i < batch_; ++i) {
+        msgs_[i].msg_hdr.msg_control    = timestamps_ ? &controls_[i * CONTROL_SIZE] : nullptr;
+        msgs_[i].msg_hdr.msg_controllen = timestamps_ ? CONTROL_SIZE : 0;
+        msgs_[i].msg_hdr.msg_flags      = 0;
+    }
+
+    const int flags = block ? MSG_WAITFORONE : MSG_DONTWAIT;
+    const int n = recvmmsg(fd_, &msgs_[0], static_cast<unsigned>(batch_), flags, nullptr);
+    if (n <= 0) {
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            std::cerr << "[ERROR] UDP recvmmsg failed: " << std::strerror(errno) << std::endl;
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        if (msgs_[i].msg_hdr.msg_flags & MSG_TRUNC) ++truncated_;
+
+        stamps_[i] = 0;
+        if (!timestamps_) continue;
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msgs_[i].msg_hdr); c; c = CMSG_NXTHDR(&msgs_[i].msg_hdr, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                stamps_[i] = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+            }
+        }
+    }
+    return static_cast<size_t>(n);
+}
+
+uint16_t UdpReceiver::local_port() const
+{
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (fd_ < 0 || getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+int UdpReceiver::rcvbuf_bytes() const
+{
+    int v = 0;
+    socklen_t len = sizeof(v);
+    if (fd_ < 0 || getsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &v, &len) != 0) return 0;
+    return v / 2;   // Linux reports double the requested size (bookkeeping overhead)
+}
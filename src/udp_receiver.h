@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Socket options for a UDP market data receiver
+ */
+struct UdpReceiverConfig
+{
+    std::string bind_addr = "0.0.0.0";    ///< Local address to bind
+    uint16_t    port = 0;                 ///< Local port (0 = ephemeral, see local_port())
+    std::string group;                    ///< Multicast group to join (empty = unicast)
+    std::string iface_addr = "0.0.0.0";   ///< Interface address for the multicast join
+    int         rcvbuf_bytes = 8 << 20;   ///< SO_RCVBUF request (0 keeps the default)
+    int         busy_poll_us = 0;         ///< SO_BUSY_POLL budget (0 disables)
+    bool        kernel_timestamps = true; ///< Request SO_TIMESTAMPNS receive stamps
+    int         timeout_ms = 100;         ///< Blocking receive timeout (0 = wait forever)
+    size_t      batch = 32;               ///< Datagrams per recvmmsg call
+    size_t      max_datagram = 2048;      ///< Bytes reserved per datagram
+};
+
+/**
+ * @brief Batched UDP datagram receiver (recvmmsg)
+ *
+ * @details One recvmmsg call fills up to config.batch preallocated buffers;
+ * datagram i of the last batch is available through data(i)/length(i)
+ * until the next receive(). No allocation happens after construction.
+ */
+class UdpReceiver
+{
+public:
+    /**
+     * @brief Opens, tunes and binds the socket, joining the group if set
+     *
+     * @details Failures to apply optional tuning (buffer size, busy poll,
+     * timestamps) are logged as warnings; failures to open or bind leave
+     * ok() false.
+     */
+    explicit UdpReceiver(const UdpReceiverConfig& config);
+    ~UdpReceiver();
+
+    UdpReceiver(const UdpReceiver&) = delete;
+    UdpReceiver& operator=(const UdpReceiver&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+
+    /**
+     * @brief Receives the next batch of datagrams
+     * @param block Wait (up to the configured timeout) for the first datagram;
+     *        otherwise return at once. Busy-poll setups pass false and spin.
+     * @return Number of datagrams received (0 on timeout / nothing pending)
+     */
+    size_t receive(bool block = true);
+
+    const char* data(size_t i) const   { return &buffers_[i * max_datagram_]; }
+    size_t      length(size_t i) const { return msgs_[i].msg_len; }
+
+    /**
+     * @brief Kernel receive timestamp of datagram i (CLOCK_REALTIME ns)
+     * @return 0 if timestamps are disabled or missing
+     */
+    uint64_t timestamp_ns(size_t i) const { return stamps_[i]; }
+
+    int      fd() const { return fd_; }   ///< Socket descriptor (for poll/epoll)
+    int      timeout_ms() const { return timeout_ms_; }   ///< Blocking receive timeout
+    uint16_t local_port() const;          ///< Bound port (useful with port 0)
+    int      rcvbuf_bytes() const;        ///< Effective SO_RCVBUF
+    uint64_t truncated() const { return truncated_; }   ///< Datagrams cut at max_datagram
+
+private:
+    int    fd_ = -1;                       ///< Socket descriptor
+    size_t batch_;                         ///< Buffers per recvmmsg call
+    size_t max_datagram_;                  ///< Bytes per buffer
+    bool   timestamps_;                    ///< SO_TIMESTAMPNS enabled
+    int    timeout_ms_;                    ///< SO_RCVTIMEO in milliseconds
+    uint64_t truncated_ = 0;               ///< MSG_TRUNC count
+
+    std::vector<char>     buffers_;        ///< batch * max_datagram bytes
+    std::vector<iovec>    iovs_;           ///< One iovec per buffer
+    std::vector<mmsghdr>  msgs_;           ///< recvmmsg descriptors
+    std::vector<char>     controls_;       ///< Ancillary data per datagram
+    std::vector<uint64_t> stamps_;         ///< Decoded kernel timestamps
+};
@@ -0,0 +1,56 @@
+#include "udp_sender.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+UdpSender::UdpSender(const std::string& addr, uint16_t port, const std::string& iface_addr)
+{
+    std::memset(&dest_, 0, sizeof(dest_));
+    dest_.sin_family = AF_INET;
+    dest_.sin_port   = htons(port);
+    if (inet_pton(AF_INET, addr.c_str(), &dest_.sin_addr) != 1) {
+        std::cerr << "[ERROR] UDP bad destination address: " << addr << std::endl;
+        return;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cerr << "[ERROR] UDP socket failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    if (IN_MULTICAST(ntohl(dest_.sin_addr.s_addr))) {
+        const unsigned char ttl = 1, loop = 1;
+        in_addr iface;
+        inet_pton(AF_INET, iface_addr.c_str(), &iface);
+        if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0 ||
+            setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0 ||
+            setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) != 0) {
+            std::cerr << "[WARN] UDP multicast options failed: " << std::strerror(errno) << std::endl;
+        }
+    }
+
+    fd_ = fd;
+}
+
+UdpSender::~UdpSender()
+{
+    if (fd_ >= 0) close(fd_);
+}
+
+bool UdpSender::send(const char* data, size_t len)
+{
+    if (fd_ < 0) return false;
+    const ssize_t n = sendto(fd_, data, len, 0, reinterpret_cast<const sockaddr*>(&dest_), sizeof(dest_));
+    if (n != static_cast<ssize_t>(len)) {
+        std::cerr << "[ERROR] UDP sendto failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ++sent_;
+    return true;
+}
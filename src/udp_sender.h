@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include <netinet/in.h>
+
+/**
+ * @brief Minimal UDP datagram sender (unicast or multicast)
+ *
+ * @details Used by the capture replayer and the loopback tests to put
+ * MoldUDP64 packets on the wire. Multicast sends use TTL 1 and keep
+ * IP_MULTICAST_LOOP on so receivers on the same host see the packets.
+ */
+class UdpSender
+{
+public:
+    /**
+     * @param addr Destination address (unicast or multicast group)
+     * @param port Destination port
+     * @param iface_addr Outgoing interface for multicast ("0.0.0.0" = default route)
+     */
+    UdpSender(const std::string& addr, uint16_t port, const std::string& iface_addr = "0.0.0.0");
+    ~UdpSender();
+
+    UdpSender(const UdpSender&) = delete;
+    UdpSender& operator=(const UdpSender&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+
+    /**
+     * @brief Sends one datagram
+     * @return false if the kernel did not accept the whole datagram
+     */
+    bool send(const char* data, size_t len);
+
+    uint64_t sent() const { return sent_; }   ///< Datagrams sent so far
+
+private:
+    int         fd_ = -1;     ///< Socket descriptor
+    sockaddr_in dest_;        ///< Destination address
+    uint64_t    sent_ = 0;    ///< Datagram counter
+};
@@ -43,5 +43,40 @@ namespace endian
 			   (static_cast<uint64_t>(static_cast<uint8_t>(p[6])) << 8) |
 			   static_cast<uint64_t>(static_cast<uint8_t>(p[7]));
 	}
+
+	/**
+     * Writes a 16-bit value to memory in big-endian order
+     * @param p Pointer to the destination (must have room for 2 bytes)
+     * @param v Value in host byte order
+     */
+	inline void write_u16_be(char* p, uint16_t v) noexcept
+	{
+		p[0] = static_cast<char>(v >> 8);
+		p[1] = static_cast<char>(v);
+	}
+
+	/**
+     * Writes a 32-bit value to memory in big-endian order
+     * @param p Pointer to the destination (must have room for 4 bytes)
+     * @param v Value in host byte order
+     */
+	inline void write_u32_be(char* p, uint32_t v) noexcept
+	{
+		p[0] = static_cast<char>(v >> 24);
+		p[1] = static_cast<char>(v >> 16);
+		p[2] = static_cast<char>(v >> 8);
+		p[3] = static_cast<char>(v);
+	}
+
+	/**
+     * Writes a 64-bit value to memory in big-endian order
+     * @param p Pointer to the destination (must have room for 8 bytes)
+     * @param v Value in host byte order
+     */
+	inline void write_u64_be(char* p, uint64_t v) noexcept
+	{
+		write_u32_be(p, static_cast<uint32_t>(v >> 32));
+		write_u32_be(p + 4, static_cast<uint32_t>(v));
+	}
 }
 
@@ -0,0 +1,147 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PACER_HAVE_TSC 1
+#endif
+
+/**
+ * @brief Cheap monotonic nanosecond clock
+ *
+ * @details Reads the TSC (rdtsc, a few ns) scaled by a factor calibrated
+ * once against steady_clock; assumes an invariant TSC, as on any recent
+ * x86. Other targets fall back to steady_clock.
+ */
+class TscClock
+{
+public:
+    /**
+     * @param calibrate_ms Calibration window (longer = more accurate scale)
+     */
+    explicit TscClock(int calibrate_ms = 10)
+    {
+#ifdef PACER_HAVE_TSC
+        const uint64_t t0 = steady_ns();
+        const uint64_t c0 = __rdtsc();
+        const uint64_t until = t0 + static_cast<uint64_t>(calibrate_ms) * 1000000ull;
+        uint64_t t1 = t0;
+        while (t1 < until) t1 = steady_ns();
+        const uint64_t c1 = __rdtsc();
+        if (c1 > c0) {
+            ns_per_tick_ = static_cast<double>(t1 - t0) / static_cast<double>(c1 - c0);
+            base_tick_ = c1;
+            base_ns_ = t1;
+        }
+#else
+        (void)calibrate_ms;
+#endif
+    }
+
+    uint64_t now_ns() const
+    {
+#ifdef PACER_HAVE_TSC
+        if (ns_per_tick_ > 0.0) {
+            return base_ns_ + static_cast<uint64_t>(static_cast<double>(__rdtsc() - base_tick_) * ns_per_tick_);
+        }
+#endif
+        return steady_ns();
+    }
+
+    bool uses_tsc() const { return ns_per_tick_ > 0.0; }
+    double ns_per_tick() const { return ns_per_tick_; }
+
+private:
+    double   ns_per_tick_ = 0.0;   ///< 0 = TSC unusable, steady_clock is used
+    uint64_t base_tick_ = 0;       ///< TSC at calibration end
+    uint64_t base_ns_ = 0;         ///< steady_clock at calibration end
+
+    static uint64_t steady_ns()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+/**
+ * @brief Releases packets on the schedule given by their capture timestamps
+ *
+ * @details The first packet anchors capture time to wall time; packet t is
+ * then due (t - t_first) / speed after the first. Long waits sleep until
+ * SPIN_NS before the deadline and busy-wait the rest, so packets leave
+ * within a few hundred ns of their slot without burning a core between
+ * sparse packets. A packet that is already overdue goes out at once and
+ * its lateness is recorded; the schedule is never shifted, so the replay
+ * catches up instead of drifting.
+ */
+class Pacer
+{
+public:
+    /**
+     * @param speed 1 = original pace, N = N times faster, 0 = no pacing
+     */
+    explicit Pacer(double speed) : speed_(speed) {}
+
+    /**
+     * @brief Waits until a packet stamped capture_ns is due
+     * @return How late the packet is released (0 if on time)
+     *
+     * @details Timestamps going backwards are treated as "now" (they
+     * cannot be scheduled in the past of an already sent packet).
+     */
+    uint64_t wait(uint64_t capture_ns)
+    {
+        if (speed_ <= 0.0) return 0;
+
+        if (!started_) {
+            started_ = true;
+            first_capture_ns_ = last_capture_ns_ = capture_ns;
+            start_ns_ = clock_.now_ns();
+            return 0;
+        }
+        if (capture_ns < last_capture_ns_) capture_ns = last_capture_ns_;
+        last_capture_ns_ = capture_ns;
+
+        const uint64_t due = start_ns_ +
+            static_cast<uint64_t>(static_cast<double>(capture_ns - first_capture_ns_) / speed_);
+
+        uint64_t now = clock_.now_ns();
+        if (now > due) {
+            const uint64_t late = now - due;
+            if (late > max_late_ns_) max_late_ns_ = late;
+            total_late_ns_ += late;
+            return late;
+        }
+        if (due - now > SPIN_NS) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(due - now - SPIN_NS));
+        }
+        while ((now = clock_.now_ns()) < due) {
+#ifdef PACER_HAVE_TSC
+            _mm_pause();
+#endif
+        }
+        return 0;
+    }
+
+    /** @brief Capture time covered so far (last - first timestamp) */
+    uint64_t span_ns() const { return last_capture_ns_ - first_capture_ns_; }
+    /** @brief Wall time since the first packet */
+    uint64_t elapsed_ns() const { return started_ ? clock_.now_ns() - start_ns_ : 0; }
+    uint64_t max_late_ns() const { return max_late_ns_; }
+    uint64_t total_late_ns() const { return total_late_ns_; }
+    const TscClock& clock() const { return clock_; }
+
+private:
+    static constexpr uint64_t SPIN_NS = 200000;   ///< Busy-wait the last 200 us
+
+    double   speed_;
+    TscClock clock_;
+    bool     started_ = false;
+    uint64_t first_capture_ns_ = 0;
+    uint64_t last_capture_ns_ = 0;
+    uint64_t start_ns_ = 0;          ///< Wall time of the first packet
+    uint64_t max_late_ns_ = 0;
+    uint64_t total_late_ns_ = 0;
+};
@@ -16,17 +16,28 @@ inline Side ParseSide(char c) noexcept
 
 /**
  * Parses a character to determine the message type
- * @param c Character to parse ('O' for OrderbookState, 'A' for AddOrder, 
- *          'E' for ExecuteOrder, 'D' for DeleteOrder)
- * @return MessageType enum value
+ * @param c Character to parse (any MessageType code, e.g. 'A' for AddOrder)
+ * @return MessageType enum value, Other for codes outside the spec
+ *
+ * The parser itself dispatches through a 256-entry decoder table; this is
+ * for tools that only need to classify a type byte.
  */
 inline MessageType ParseMessageType(char c) noexcept
 {
     switch (c) {
+        case 'T': return MessageType::Seconds;
+        case 'R': return MessageType::OrderbookDirectory;
+        case 'M': return MessageType::CombinationLeg;
+        case 'L': return MessageType::TickSize;
+        case 'S': return MessageType::SystemEvent;
         case 'O': return MessageType::OrderbookState;
         case 'A': return MessageType::AddOrder;
         case 'E': return MessageType::ExecuteOrder;
+        case 'C': return MessageType::ExecuteWithPrice;
+        case 'U': return MessageType::ReplaceOrder;
         case 'D': return MessageType::DeleteOrder;
+        case 'P': return MessageType::Trade;
+        case 'Z': return MessageType::EquilibriumPrice;
         default:  return MessageType::Other;
     }
 }
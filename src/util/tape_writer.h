@@ -0,0 +1,232 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../itch_layout.h"
+#include "../moldudp64.h"
+#include "../types/event.h"
+#include "endian.h"
+
+/**
+ * @brief Encodes ITCH messages into MoldUDP64 packets (capture file format)
+ *
+ * @details Produces the same byte layout ItchParser reads (both are
+ * generated from itch_layout.h), so tests and tools can build captures
+ * and datagrams without a recorded file. Messages
+ * are appended to the open packet; flush() closes it. A packet is closed
+ * automatically when the next message would exceed max_bytes.
+ */
+class TapeWriter
+{
+public:
+    /**
+     * @param session Session name (space padded / truncated to 10 bytes)
+     * @param first_seq Sequence number of the first message
+     * @param max_bytes Largest packet to produce (header included)
+     */
+    explicit TapeWriter(const std::string& session = "SESSION001",
+                        uint64_t first_seq = 1,
+                        size_t max_bytes = mold::MAX_PACKET)
+    : next_seq_(first_seq), max_bytes_(max_bytes)
+    {
+        std::memset(session_, ' ', mold::SESSION_SIZE);
+        std::memcpy(session_, session.data(), session.size() < mold::SESSION_SIZE ? session.size() : mold::SESSION_SIZE);
+    }
+
+    /**
+     * @brief Appends any message described in itch_layout.h
+     * @param event Source of the message's fields (others are ignored)
+     */
+    template <typename Message>
+    void put(const Event& event) {
+        Message::encode(begin(static_cast<char>(Message::type), Message::size), event);
+    }
+
+    void seconds(uint32_t s) {
+        Event e;
+        e.timestamp = static_cast<Timestamp>(s) * 1000000000ull;
+        put<itch::Seconds>(e);
+    }
+
+    void state(Nanoseconds ns, OrderbookId book, const std::string& state_name) {
+        Event e = make(ns, book);
+        e.orderbook_state = state_name;
+        put<itch::OrderbookState>(e);
+    }
+
+    void add(Nanoseconds ns, OrderId id, OrderbookId book, Side side, RankingSeqNum rsn,
+             Quantity qty, Price price, RankingTime rt) {
+        Event e = make(ns, book, id, side);
+        e.ranking_seq_num = rsn;
+        e.quantity = qty;
+        e.price = price;
+        e.ranking_time = rt;
+        put<itch::AddOrder>(e);
+    }
+
+    void execute(Nanoseconds ns, OrderId id, OrderbookId book, Side side, Quantity qty, uint64_t match_id = 0) {
+        Event e = make(ns, book, id, side);
+        e.quantity = qty;
+        e.match_id = match_id;
+        put<itch::ExecuteOrder>(e);
+    }
+
+    void execute_price(Nanoseconds ns, OrderId id, OrderbookId book, Side side, Quantity qty,
+                       uint64_t match_id, Price price, bool at_cross, bool printable = true) {
+        Event e = make(ns, book, id, side);
+        e.quantity = qty;
+        e.match_id = match_id;
+        e.price = price;
+        e.at_cross = at_cross;
+        e.printable = printable;
+        put<itch::ExecuteWithPrice>(e);
+    }
+
+    void replace(Nanoseconds ns, OrderId id, OrderbookId book, Side side, RankingSeqNum rsn,
+                 Quantity qty, Price price) {
+        Event e = make(ns, book, id, side);
+        e.ranking_seq_num = rsn;
+        e.quantity = qty;
+        e.price = price;
+        put<itch::ReplaceOrder>(e);
+    }
+
+    void trade(Nanoseconds ns, uint64_t match_id, OrderbookId book, Side side, Quantity qty,
+               Price price, bool at_cross, bool printable = true) {
+        Event e = make(ns, book, 0, side);
+        e.match_id = match_id;
+        e.quantity = qty;
+        e.price = price;
+        e.at_cross = at_cross;
+        e.printable = printable;
+        put<itch::Trade>(e);
+    }
+
+    void equilibrium(Nanoseconds ns, OrderbookId book, Quantity bid_qty, Quantity ask_qty,
+                     Price price, Price best_bid, Price best_ask) {
+        Event e = make(ns, book);
+        e.quantity = bid_qty;
+        e.ask_quantity = ask_qty;
+        e.price = price;
+        e.best_bid = best_bid;
+        e.best_ask = best_ask;
+        put<itch::EquilibriumPrice>(e);
+    }
+
+    void directory(Nanoseconds ns, OrderbookId book, const std::string& symbol,
+                   uint16_t price_decimals, uint32_t round_lot) {
+        Event e = make(ns, book);
+        e.symbol = symbol;
+        e.price_decimals = price_decimals;
+        e.round_lot = round_lot;
+        put<itch::OrderbookDirectory>(e);
+    }
+
+    void tick_size(Nanoseconds ns, OrderbookId book, uint64_t tick, Price from, Price to) {
+        Event e = make(ns, book);
+        e.tick_size = tick;
+        e.price = from;
+        e.price_to = to;
+        put<itch::TickSize>(e);
+    }
+
+    void system_event(Nanoseconds ns, char code) {
+        Event e = make(ns, 0);
+        e.event_code = code;
+        put<itch::SystemEvent>(e);
+    }
+
+    void remove(Nanoseconds ns, OrderId id, OrderbookId book, Side side) {
+        put<itch::DeleteOrder>(make(ns, book, id, side));
+    }
+
+    /**
+     * @brief Appends an arbitrary message (type byte + body)
+     */
+    void raw(char type, const char* body, size_t len) {
+        char* m = begin(type, len);
+        if (len) std::memcpy(m, body, len);
+    }
+
+    /**
+     * @brief Closes the open packet (no-op if it holds no messages)
+     */
+    void flush() {
+        if (count_ == 0) return;
+        mold::PacketHeader h;
+        std::memcpy(h.session, session_, mold::SESSION_SIZE);
+        h.seq = next_seq_;
+        h.count = count_;
+        mold::write_header(&open_[0], h);
+        packets_.push_back(open_);
+        next_seq_ += count_;
+        open_.clear();
+        count_ = 0;
+    }
+
+    /**
+     * @brief Closes the open packet and appends an end-of-session packet
+     */
+    void end_session() {
+        flush();
+        packets_.push_back(control_packet(mold::END_OF_SESSION));
+    }
+
+    /**
+     * @brief Builds a heartbeat/end-of-session packet at the current sequence
+     */
+    std::vector<char> control_packet(uint16_t count) const {
+        std::vector<char> p(mold::HEADER_SIZE);
+        mold::PacketHeader h;
+        std::memcpy(h.session, session_, mold::SESSION_SIZE);
+        h.seq = next_seq_;
+        h.count = count;
+        mold::write_header(&p[0], h);
+        return p;
+    }
+
+    /**
+     * @brief Writes all closed packets back to back (capture file layout)
+     */
+    void write(std::ostream& out) const {
+        for (const auto& p : packets_) out.write(p.data(), static_cast<std::streamsize>(p.size()));
+    }
+
+    const std::vector<std::vector<char>>& packets() const { return packets_; }
+    uint64_t next_seq() const { return next_seq_; }
+    const char* session() const { return session_; }
+
+private:
+    char     session_[mold::SESSION_SIZE];   ///< Space-padded session name
+    uint64_t next_seq_;                      ///< Sequence of the open packet's first message
+    size_t   max_bytes_;                     ///< Packet size limit
+    uint16_t count_ = 0;                     ///< Messages in the open packet
+    std::vector<char> open_;                 ///< Open packet (header reserved)
+    std::vector<std::vector<char>> packets_; ///< Closed packets
+
+    static Event make(Nanoseconds ns, OrderbookId book, OrderId id = 0, Side side = Side::Unknown) {
+        Event e;
+        e.nanosec = ns;
+        e.orderbook_id = book;
+        e.order_id = id;
+        e.side = side;
+        return e;
+    }
+
+    /// Reserves a message with its length prefix and type byte, returns the body
+    char* begin(char type, size_t body) {
+        const size_t need = mold::LENGTH_SIZE + 1 + body;
+        if (count_ != 0 && open_.size() + need > max_bytes_) flush();
+        if (open_.empty()) open_.resize(mold::HEADER_SIZE);
+
+        const size_t at = open_.size();
+        open_.resize(at + need);
+        endian::write_u16_be(&open_[at], static_cast<uint16_t>(1 + body));
+        open_[at + mold::LENGTH_SIZE] = type;
+        ++count_;
+        return &open_[at + mold::LENGTH_SIZE + 1];
+    }
+};
@@ -1,79 +1,234 @@
 #include "itch_parser.h"
 #include "orderbook.h"
+#include "orderbook_filter.h"
 #include "strategy.h"
+#include "strategy_sweep.h"
+#include "replay.h"
+#include "replay_observers.h"
+#include "backtest_runner.h"
+#include "risk_engine.h"
+#include "order_gateway.h"
+#include "udp_feed.h"
+#include "udp_receiver.h"
 #include "types/event.h"
 
 #include <fstream>
+#include <memory>
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <cstdlib>
 #include <iomanip>
+#include <chrono>
+#include <string>
 
-// --- pretty printers ---
-static void print_event(const Event& ev) {
-    std::cout << "[MSG] ns=" << ev.nanosec << " type=";
-    switch (ev.type) {
-        case MessageType::OrderbookState:
-            std::cout << "STATE book=" << ev.orderbook_id
-                      << " state=" << ev.orderbook_state; break;
-        case MessageType::AddOrder:
-            std::cout << "ADD id=" << ev.order_id
-                      << " side=" << (ev.side == Side::Buy ? "B" : "S")
-                      << " qty=" << ev.quantity
-                      << " px=" << ev.price; break;
-        case MessageType::ExecuteOrder:
-            std::cout << "EXEC id=" << ev.order_id
-                      << " side=" << (ev.side == Side::Buy ? "B" : "S")
-                      << " qty=" << ev.quantity; break; // exec has no price in spec
-        case MessageType::DeleteOrder:
-            std::cout << "DEL id=" << ev.order_id
-                      << " side=" << (ev.side == Side::Buy ? "B" : "S"); break;
-        default: std::cout << "OTHER"; break;
-    }
-    std::cout << "\n";
-}
+// Build with -DPRODUCTION_BUILD (make PRODUCTION=1) to compile every
+// diagnostic observer out of the binary; only the quiet path is instantiated.
+
+template <typename Source, typename Observer>
+static void run(Source& source, OrderbookId target_book,
+                Orderbook& book, Strategy& strat, Observer obs,
+                QueueFillSimulator* sim = nullptr, LatencyQueue* latency = nullptr) {
+    const ReplayStats stats = replay_day_top_driven(source, target_book, book, strat, obs, sim, latency);
+
+    // final summary
+    double pnl_tl = static_cast<double>(strat.realized_pnl()) / 1000.0;
+    std::cout << "[FINAL] batches=" << stats.batches
+              << " msgs=" << stats.msgs
+              << " pos=" << strat.position()
+              << " pnl=" << strat.realized_pnl() << " converted to TL: " <<std::fixed << std::setprecision(2) << pnl_tl << " TL)\n";
 
-static void print_topN(const Orderbook& ob, size_t N,
-                       uint64_t ns = 0, int64_t book_id = -1) {
-    std::vector<std::pair<Price, Quantity>> bids, asks;
-    ob.snapshot_n(N, bids, asks);
-
-    std::cout << "---- SNAPSHOT"
-              << " ns=" << ns
-              << " book=" << (book_id >= 0 ? book_id : -1)
-              << " open=" << (ob.trading_open() ? "Y" : "N")
-              << " ----\n";
-
-    std::cout << "BIDS (price, qty):\n";
-    for (size_t i = 0; i < bids.size(); ++i)
-        std::cout << "  [" << i << "] " << bids[i].first << ", " << bids[i].second << "\n";
-    if (bids.empty()) std::cout << "  (none)\n";
-
-    std::cout << "ASKS (price, qty):\n";
-    for (size_t i = 0; i < asks.size(); ++i)
-        std::cout << "  [" << i << "] " << asks[i].first << ", " << asks[i].second << "\n";
-    if (asks.empty()) std::cout << "  (none)\n";
-
-    if (ob.has_top()) {
-        std::cout << "BEST: bid " << ob.best_bid_price() << " x " << ob.best_bid_quantity()
-                  << " | ask " << ob.best_ask_price() << " x " << ob.best_ask_quantity()
-                  << "\n";
-    }
-    std::cout << "------------------------------\n";
+    // final snapshot
+    obs.on_finish(stats.last_ns, book);
 }
 
 int main(int argc, char* argv[]) {
     const OrderbookId TARGET_BOOK = 73616;
     const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
-    
-    // Check for quiet mode flag
+    const OrderbookFilter SUBSCRIBED{TARGET_BOOK};   // other books are skipped undecoded
+
+    // Check for quiet mode / sampling flags
     bool quiet_mode = false;
+    bool sweep_mode = false;
+    bool resync_mode = false;
+    bool queue_fills = false;
+    long latency_ns = -1;                 // --latency: mean order latency
+    unsigned long latency_jitter_ns = 0;  // --latency-jitter: Gaussian stddev
+    const char* latency_hist = nullptr;   // --latency-hist: measured histogram file
+    Position max_pos = 1000;              // --max-pos
+    Position min_pos = 0;                 // --min-pos: negative allows shorting
+    bool risk_mode = false;               // any --risk-* flag
+    InstrumentLimits risk_limits;
+    bool memory_report = false;           // --memory: per-structure book memory at the end
+    bool hugepages = false;               // --hugepages: book nodes from a huge-page arena
+    bool gateway_mode = false;            // --gateway / --exchange: live order entry
+    const char* exchange_addr = nullptr;  // --exchange: real endpoint instead of the stub
+    uint16_t exchange_port = 0;
+    std::vector<std::string> day_paths;   // --days: files or directories of captures
+    size_t workers = 0;
+    size_t sample_every = 0;
+    const char* shm_name = nullptr;
+    UdpReceiverConfig udp;
+    UdpReceiverConfig udp_b;
+    bool udp_mode = false;
+    bool udp_b_mode = false;
+    const char* recovery_addr = nullptr;
+    uint16_t recovery_port = 0;
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--quiet") == 0 || strcmp(argv[i], "-q") == 0) {
             quiet_mode = true;
-            break;
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            sweep_mode = true;
+        } else if (strcmp(argv[i], "--days") == 0) {
+            while (i + 1 < argc && argv[i + 1][0] != '-') day_paths.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--resync") == 0) {
+            resync_mode = true;
+        } else if (strcmp(argv[i], "--queue-fills") == 0) {
+            queue_fills = true;
+        } else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            latency_ns = std::strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--latency-jitter") == 0 && i + 1 < argc) {
+            latency_jitter_ns = std::strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--latency-hist") == 0 && i + 1 < argc) {
+            latency_hist = argv[++i];
+        } else if (strcmp(argv[i], "--max-pos") == 0 && i + 1 < argc) {
+            max_pos = std::strtoll(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--min-pos") == 0 && i + 1 < argc) {
+            min_pos = std::strtoll(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--risk-notional") == 0 && i + 1 < argc) {
+            risk_mode = true;
+            risk_limits.max_notional = std::strtoll(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--risk-band") == 0 && i + 1 < argc) {
+            risk_mode = true;
+            risk_limits.price_band_bps = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--risk-rate") == 0 && i + 1 < argc) {
+            risk_mode = true;   // orders per 1 ms of event time
+            risk_limits.max_orders = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            risk_limits.rate_window_ns = 1000000;
+        } else if (strcmp(argv[i], "--memory") == 0) {
+            memory_report = true;
+        } else if (strcmp(argv[i], "--hugepages") == 0) {
+            hugepages = true;
+        } else if (strcmp(argv[i], "--gateway") == 0) {
+            gateway_mode = true;
+        } else if (strcmp(argv[i], "--exchange") == 0 && i + 2 < argc) {
+            gateway_mode = true;
+            exchange_addr = argv[++i];
+            exchange_port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) {
+            sample_every = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (strcmp(argv[i], "--udp") == 0 && i + 1 < argc) {
+            udp_mode = true;
+            udp.port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--group") == 0 && i + 1 < argc) {
+            udp.group = argv[++i];
+        } else if (strcmp(argv[i], "--udp-b") == 0 && i + 1 < argc) {
+            udp_b_mode = true;
+            udp_b.port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--group-b") == 0 && i + 1 < argc) {
+            udp_b.group = argv[++i];
+        } else if (strcmp(argv[i], "--busy-poll") == 0 && i + 1 < argc) {
+            udp.busy_poll_us = static_cast<int>(std::strtol(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--recovery") == 0 && i + 2 < argc) {
+            recovery_addr = argv[++i];
+            recovery_port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
         }
     }
+#ifdef PRODUCTION_BUILD
+    quiet_mode = true;
+    (void)sample_every;
+#endif
+
+    // multi-day mode: every capture replayed by a worker pool, results aggregated
+    if (!day_paths.empty()) {
+        std::vector<std::string> days;
+        for (const auto& path : day_paths) {
+            const std::vector<std::string> found = list_captures(path);
+            days.insert(days.end(), found.begin(), found.end());
+        }
+        BacktestConfig config;
+        config.target_book = TARGET_BOOK;
+        config.resync = resync_mode;
+        config.max_pos = max_pos;
+        config.min_pos = min_pos;
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const std::vector<DayResult> results = run_backtest(days, config, workers);
+        const double wall_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        double day_ms = 0;
+        for (const DayResult& d : results) {
+            day_ms += d.wall_ms;
+            if (!d.opened) { std::cout << "[DAY] " << d.path << " UNREADABLE\n"; continue; }
+            std::cout << "[DAY] " << d.path
+                      << " batches=" << d.stats.batches << " msgs=" << d.stats.msgs
+                      << " eod=" << (d.stats.reached_eod ? "Y" : "N")
+                      << " pos=" << d.position << " pnl=" << d.pnl
+                      << " fills=" << d.fills << " bought=" << d.bought << " sold=" << d.sold
+                      << " ms=" << std::fixed << std::setprecision(1) << d.wall_ms << "\n";
+        }
+        const BacktestTotals t = summarize(results);
+        std::cout << "[BACKTEST] days=" << t.days << " failed=" << t.failed
+                  << " msgs=" << t.msgs << " pnl=" << t.pnl
+                  << " best_day=" << t.best_day_pnl << " worst_day=" << t.worst_day_pnl
+                  << " fills=" << t.fills << " bought=" << t.bought << " sold=" << t.sold
+                  << " wall_ms=" << std::fixed << std::setprecision(1) << wall_ms
+                  << " speedup=" << std::setprecision(2) << (wall_ms > 0 ? day_ms / wall_ms : 0.0) << "x\n";
+        return t.failed == 0 ? 0 : 1;
+    }
+
+    // live mode: MoldUDP64 datagrams instead of the capture file
+    if (udp_mode) {
+        UdpReceiver rx(udp);
+        if (!rx.ok()) return 1;
+        ItchParser decoder;
+        decoder.set_filter(&SUBSCRIBED);
+        const bool spin = udp.busy_poll_us > 0;
+
+        // optional redundant line B, arbitrated against line A
+        std::unique_ptr<UdpReceiver> rx_b;
+        std::unique_ptr<UdpFeed> feed_ptr;
+        if (udp_b_mode) {
+            udp_b.busy_poll_us = udp.busy_poll_us;
+            rx_b.reset(new UdpReceiver(udp_b));
+            if (!rx_b->ok()) return 1;
+            feed_ptr.reset(new UdpFeed(rx, *rx_b, decoder, spin));
+        } else {
+            feed_ptr.reset(new UdpFeed(rx, decoder, spin));
+        }
+        UdpFeed& feed = *feed_ptr;
+        std::unique_ptr<MoldRequestClient> recovery;
+        if (recovery_addr) {
+            recovery.reset(new MoldRequestClient(recovery_addr, recovery_port));
+            if (!recovery->ok()) return 1;
+            feed.set_recovery(recovery.get());
+        }
+        Orderbook live_book;
+        Strategy  live_strat(TARGET_BOOK, /*order_qty=*/100, max_pos, min_pos);
+        std::cout << "Listening on UDP port " << rx.local_port()
+                  << (udp.group.empty() ? "" : " group ") << udp.group;
+        if (rx_b) {
+            std::cout << ", line B port " << rx_b->local_port()
+                      << (udp_b.group.empty() ? "" : " group ") << udp_b.group;
+        }
+        std::cout << std::endl;
+        run(feed, TARGET_BOOK, live_book, live_strat, QuietObserver());
+
+        const SequencerStats& seq = feed.sequencer().stats();
+        std::cout << "[SEQ] delivered=" << seq.delivered << " gaps=" << seq.gaps
+                  << " duplicates=" << seq.duplicates << " lost=" << seq.lost << "\n";
+        if (rx_b) {
+            const ArbiterStats& arb = feed.arbitration();
+            std::cout << "[ARB] wins A=" << arb.wins[0] << " B=" << arb.wins[1]
+                      << " late A=" << arb.late[0] << " B=" << arb.late[1] << "\n";
+        }
+        return 0;
+    }
 
     if (!quiet_mode) {
         std::cout << "Opening file: " << FILE_PATH << std::endl;
@@ -85,105 +240,155 @@ int main(int argc, char* argv[]) {
         std::cout << "Creating parser..." << std::endl;
     }
     ItchParser parser(file);
+    parser.set_filter(&SUBSCRIBED);
+    parser.set_resync(resync_mode);   // skip corrupt framing instead of stopping
     if (!quiet_mode) {
         std::cout << "Creating orderbook..." << std::endl;
     }
-    Orderbook  book;
+    // hugepages mode: list/tree/hash nodes packed into 2 MB pages
+    std::unique_ptr<NodeArena> arena;
+    if (hugepages) arena.reset(new NodeArena(HugePages::Explicit));
+    Orderbook  book(arena.get());
     if (!quiet_mode) {
         std::cout << "Creating strategy..." << std::endl;
     }
-    Strategy   strat(TARGET_BOOK, /*order_qty=*/100, /*max_pos=*/1000, /*min_pos=*/0);
-
-    bool   seen_open = false;
-    size_t msgs_total = 0, batches_total = 0;
+    Strategy   strat(TARGET_BOOK, /*order_qty=*/100, max_pos, min_pos);
 
-    // ns-batching state
-    uint64_t cur_ns = 0;
-    bool have_batch = false;
-    std::vector<Event> ns_batch;
-    ns_batch.reserve(64);
-
-    auto flush_batch = [&](uint64_t ns){
-        if (!have_batch) return;
+    // risk mode: pre-trade checks on top of the strategy's own limits
+    RiskEngine risk;
+    if (risk_mode) {
+        risk_limits.max_position = max_pos;
+        risk_limits.min_position = min_pos;
+        strat.set_risk(&risk, risk.add_instrument(TARGET_BOOK, risk_limits));
+    }
 
-        ++batches_total;
-        if (!quiet_mode) {
-            std::cout << "\n=== BATCH ns=" << ns << " (" << ns_batch.size() << " events) ===\n";
-            for (const auto& ev : ns_batch) print_event(ev);
-        }
+    // queue-fills mode: orders rest in the book's queues instead of filling at once
+    QueueFillSimulator fill_sim(book);
+    QueueFillSimulator* sim = queue_fills ? &fill_sim : nullptr;
+    strat.set_fill_simulator(sim);
 
-        // run strategy after the book has all events for this ns
-        strat.on_batch(ns, book, ns_batch);
+    // latency mode: orders reach the book some time after the decision
+    LatencyModel latency_model;
+    if (latency_hist) {
+        std::vector<LatencyBucket> buckets;
+        if (!LatencyModel::load_histogram(latency_hist, buckets)) return 1;
+        latency_model = LatencyModel::histogram(buckets);
+    } else if (latency_ns >= 0 && latency_jitter_ns > 0) {
+        latency_model = LatencyModel::normal(static_cast<Timestamp>(latency_ns), latency_jitter_ns);
+    } else if (latency_ns >= 0) {
+        latency_model = LatencyModel::fixed(static_cast<Timestamp>(latency_ns));
+    }
+    LatencyQueue latency_queue(latency_model);
+    LatencyQueue* latency = (latency_hist || latency_ns >= 0) ? &latency_queue : nullptr;
+    strat.set_latency(latency);
 
-        // print top-n after each batch
-        if (!quiet_mode) {
-            print_topN(book, 3, ns, TARGET_BOOK);
+    // gateway mode: orders leave as OUCH messages over TCP; without
+    // --exchange a stub exchange on loopback acks and fills them
+    std::unique_ptr<StubExchange> stub;
+    std::unique_ptr<OrderGateway> gateway;
+    if (gateway_mode) {
+        if (!exchange_addr) {
+            stub.reset(new StubExchange());
+            if (!stub->ok()) return 1;
+            exchange_addr = "127.0.0.1";
+            exchange_port = stub->local_port();
         }
-
-        ns_batch.clear();
-        have_batch = false;
-    };
+        gateway.reset(new OrderGateway(exchange_addr, exchange_port));
+        if (!gateway->ok()) return 1;
+        strat.set_gateway(gateway.get());
+    }
 
     if (!quiet_mode) {
         std::cout << "Starting main loop..." << std::endl;
     }
-    while (file.good()) {
-        auto events = parser.next_packet();
-        if (events.empty()) continue;
-
-        for (const auto& ev : events) {
-            if (ev.orderbook_id != TARGET_BOOK) continue;
-
-            // log all state messages (esp. close)
-            if (ev.type == MessageType::OrderbookState) {
-                if (!quiet_mode) {
-                    std::cerr << "[STATE] ns=" << ev.nanosec
-                              << " state=" << ev.orderbook_state << "\n";
-                }
-            }
-
-            // detect continuous trading open
-            if (!seen_open && ev.type == MessageType::OrderbookState &&
-                ev.orderbook_state == "P_SUREKLI_ISLEM") {
-                seen_open = true;
-                std::cout << "[DAY START] Continuous trading begins.\n";
-            }
-
-            // ns boundary handling
-            if (!have_batch) { cur_ns = ev.nanosec; have_batch = true; }
-            else if (ev.nanosec != cur_ns) { flush_batch(cur_ns); cur_ns = ev.nanosec; have_batch = true; }
-
-            // apply to book (tape order), then collect into this ns batch
-            book.apply(ev);
-            ns_batch.push_back(ev);
-            ++msgs_total;
-
-            // Check for EOD after adding to batch
-            if (ev.type == MessageType::OrderbookState && 
-                ev.orderbook_state == "P_MARJ_YAYIN_KAPANIS") {
-                std::cout << "[DAY END] Market closed.\n";
-                flush_batch(cur_ns);
-                goto eod_reached;
-            }
-        }
+
+    // sweep mode: one pass over the tape drives every parameter set
+    if (sweep_mode) {
+        StrategySweep sweep(TARGET_BOOK);
+        sweep.add_grid(/*order_qty=*/{25, 50, 100, 200, 400},
+                       /*max_pos=*/{100, 250, 500, 1000, 2000, 4000},
+                       /*min_pos=*/{0, 50},
+                       /*tick=*/{10, 20},
+                       /*gap_ticks=*/{2, 3});
+        QuietObserver obs;
+        const ReplayStats stats = replay_day(parser, TARGET_BOOK, book, sweep, obs);
+        std::cout << "[SWEEP] configs=" << sweep.size()
+                  << " batches=" << stats.batches
+                  << " msgs=" << stats.msgs << "\n";
+        sweep.write_results(std::cout);
+        return 0;
     }
 
-eod_reached:
-    // flush final batch
-    flush_batch(cur_ns);
+    // shm mode: publish BBO/depth after every batch for sibling processes
+    if (shm_name) {
+        ShmBookPublisher publisher(shm_name, /*slots=*/16, /*depth=*/5);
+        if (!publisher.ok()) return 1;
+        run(parser, TARGET_BOOK, book, strat, ShmPublishObserver(publisher, TARGET_BOOK));
+        return 0;
+    }
 
-    // explicit EOD settle (mark open pos with last trade price)
+    // observer is picked once here; the batch loop itself has no output checks
+#ifdef PRODUCTION_BUILD
+    run(parser, TARGET_BOOK, book, strat, QuietObserver(), sim, latency);
+#else
+    if (sample_every != 0) {
+        run(parser, TARGET_BOOK, book, strat, SampledSnapshotObserver(TARGET_BOOK, sample_every), sim, latency);
+    } else if (quiet_mode) {
+        run(parser, TARGET_BOOK, book, strat, QuietObserver(), sim, latency);
+    } else {
+        run(parser, TARGET_BOOK, book, strat, VerboseObserver(TARGET_BOOK), sim, latency);
+    }
+#endif
 
-    // final summary
-    double pnl_tl = static_cast<double>(strat.realized_pnl()) / 1000.0;
-    std::cout << "[FINAL] batches=" << batches_total
-              << " msgs=" << msgs_total
-              << " pos=" << strat.position()
-              << " pnl=" << strat.realized_pnl() << " converted to TL: " <<std::fixed << std::setprecision(2) << pnl_tl << " TL)\n";
+    if (latency) {
+        const LatencyStats& ls = latency_queue.stats();
+        std::cout << "[LATENCY] sent=" << ls.sent << " arrived=" << ls.arrived
+                  << " dropped=" << ls.dropped << " missed=" << strat.missed()
+                  << " mean_ns=" << (ls.sent ? ls.total_latency / ls.sent : 0)
+                  << " max_ns=" << ls.max_latency << "\n";
+    }
+    if (risk_mode) {
+        std::cout << "[RISK] checks=" << risk.checks() << " ok=" << risk.count(RiskCheck::Ok);
+        for (size_t r = 1; r < static_cast<size_t>(RiskCheck::Count_); ++r) {
+            const RiskCheck outcome = static_cast<RiskCheck>(r);
+            if (risk.count(outcome)) std::cout << " " << to_string(outcome) << "=" << risk.count(outcome);
+        }
+        std::cout << " gross_notional=" << risk.gross_notional() << "\n";
+    }
+    if (gateway) {
+        gateway->stop();
+        const LatencySummary wire = gateway->tick_to_wire();
+        const LatencySummary ack = gateway->tick_to_ack();
+        std::cout << "[GATEWAY] sent=" << gateway->sent() << " accepted=" << gateway->accepted()
+                  << " executed=" << gateway->executed() << " cancels=" << gateway->cancels()
+                  << " canceled=" << gateway->canceled()
+                  << " rejected=" << gateway->rejected() << " ring_full=" << gateway->ring_full()
+                  << " tick_to_wire_ns p50=" << wire.p50 << " p99=" << wire.p99
+                  << " tick_to_ack_ns p50=" << ack.p50 << " p99=" << ack.p99 << " max=" << ack.max << "\n";
+    }
+    if (queue_fills) {
+        std::cout << "[QUEUE] fills=" << strat.fills() << " bought=" << strat.bought()
+                  << " sold=" << strat.sold() << " resting=" << fill_sim.resting() << "\n";
+    }
 
-    // final top-10 snapshot
-    if (!quiet_mode) {
-        print_topN(book, 5, cur_ns, TARGET_BOOK);
+    if (memory_report || arena) {
+        const BookMemory m = book.memory();
+        std::cout << "[MEMORY] orders=" << m.orders.nodes << " (" << m.orders.bytes << " B)"
+                  << " levels=" << m.levels.nodes << " (" << m.levels.bytes << " B)"
+                  << " index=" << m.index.bytes << " B queues=" << m.queues.bytes << " B"
+                  << " total=" << m.total.bytes << " B peak=" << m.total.peak_bytes << " B";
+        if (arena) {
+            std::cout << " arena=" << to_string(arena->mode())
+                      << " reserved=" << arena->stats().reserved_bytes
+                      << " peak_used=" << arena->stats().peak_used_bytes;
+        }
+        std::cout << "\n";
+    }
+
+    if (resync_mode) {
+        const ResyncStats& rs = parser.resync_stats();
+        std::cout << "[RESYNC] resyncs=" << rs.resyncs << " skipped_bytes=" << rs.skipped_bytes
+                  << " lost_msgs=" << rs.lost_messages << "\n";
     }
     return 0;
 }
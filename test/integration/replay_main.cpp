@@ -0,0 +1,84 @@
+// Sends a MoldUDP64 capture file as UDP datagrams (one packet per datagram),
+// followed by an end-of-session packet. Pair with integration_main --udp PORT.
+//
+// --speed 1 paces packets as captured (ITCH timestamps), --speed N runs N
+// times faster; without --speed packets go out back to back (or every
+// --gap-us microseconds).
+#include "itch_parser.h"
+#include "moldudp64.h"
+#include "udp_sender.h"
+#include "util/pacer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    const char* file_path = "data/itch_data_250815_HI2.dat";
+    const char* addr = "127.0.0.1";
+    uint16_t port = 30001;
+    long gap_us = 0;
+    double speed = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            file_path = argv[++i];
+        } else if (strcmp(argv[i], "--addr") == 0 && i + 1 < argc) {
+            addr = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--gap-us") == 0 && i + 1 < argc) {
+            gap_us = std::strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = std::strtod(argv[++i], nullptr);
+        }
+    }
+
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file) { std::cerr << "Error opening file: " << file_path << "\n"; return 1; }
+
+    UdpSender tx(addr, port);
+    if (!tx.ok()) return 1;
+
+    ItchParser framer(file);
+    std::vector<char> packet;
+    mold::PacketHeader last{};
+    bool have_last = false;
+    Pacer pacer(speed);
+    uint32_t seconds = 0;
+    uint64_t capture_ns = 0;
+    uint64_t late = 0;
+
+    while (framer.good()) {
+        if (!framer.next_raw_packet(packet)) continue;
+        if (ItchParser::packet_time(packet.data(), packet.size(), seconds, capture_ns)) {
+            if (pacer.wait(capture_ns) > 1000) ++late;
+        }
+        if (!tx.send(packet.data(), packet.size())) return 1;
+        mold::read_header(packet.data(), packet.size(), last);
+        have_last = true;
+        if (gap_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+    }
+
+    if (have_last) {
+        mold::PacketHeader eos = last;
+        eos.seq = last.next_seq();
+        eos.count = mold::END_OF_SESSION;
+        char buf[mold::HEADER_SIZE];
+        mold::write_header(buf, eos);
+        tx.send(buf, sizeof(buf));
+    }
+
+    std::cout << "[REPLAY] sent=" << tx.sent() << " datagrams to " << addr << ":" << port << "\n";
+    if (speed > 0.0) {
+        std::cout << "[PACE] speed=" << speed << "x span_us=" << pacer.span_ns() / 1000
+                  << " elapsed_us=" << pacer.elapsed_ns() / 1000
+                  << " late_over_1us=" << late << " max_late_ns=" << pacer.max_late_ns()
+                  << " clock=" << (pacer.clock().uses_tsc() ? "tsc" : "steady") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// test_backtest.cpp
+#include "backtest_runner.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+static bool same_result(const DayResult& a, const DayResult& b) {
+    return a.path == b.path && a.opened == b.opened &&
+           a.stats.batches == b.stats.batches && a.stats.msgs == b.stats.msgs &&
+           a.stats.reached_eod == b.stats.reached_eod && a.pnl == b.pnl &&
+           a.position == b.position && a.fills == b.fills &&
+           a.bought == b.bought && a.sold == b.sold;
+}
+
+static double time_ms(const std::vector<std::string>& days, const BacktestConfig& config,
+                      size_t workers, std::vector<DayResult>& out) {
+    const auto t0 = std::chrono::steady_clock::now();
+    out = run_backtest(days, config, workers);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main() {
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    const size_t FULL_DAYS = 6;
+    int failures = 0;
+
+    std::ifstream src(FILE_PATH, std::ios::binary);
+    if (!src) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    const std::string capture((std::istreambuf_iterator<char>(src)), std::istreambuf_iterator<char>());
+
+    // a month in miniature: full copies of the capture plus a day cut short
+    char dir_template[] = "/tmp/test_backtest_XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    if (!dir) { std::cerr << "Error: mkdtemp failed\n"; return 1; }
+    std::vector<std::string> written;
+    auto write_day = [&](const std::string& name, size_t bytes) {
+        const std::string path = std::string(dir) + "/" + name;
+        std::ofstream out(path.c_str(), std::ios::binary);
+        out.write(capture.data(), static_cast<std::streamsize>(bytes));
+        written.push_back(path);
+    };
+    write_day("itch_250800_half.dat", capture.size() / 2);
+    for (size_t d = 1; d <= FULL_DAYS; ++d) {
+        write_day("itch_2508" + std::to_string(10 + d) + ".dat", capture.size());
+    }
+
+    // ----- directory listing -----
+    const std::vector<std::string> days = list_captures(dir);
+    std::cout << "=== LIST CAPTURES ===\n";
+    std::cout << "files=" << days.size() << " first=" << days.front().substr(days.front().rfind('/') + 1) << "\n";
+    if (days.size() != FULL_DAYS + 1 || days.front() != written.front()) ++failures;
+
+    // ----- sequential vs. parallel: identical per-day results -----
+    BacktestConfig config;
+    config.target_book = 73616;
+
+    std::vector<DayResult> seq, par;
+    const double seq_ms = time_ms(days, config, 1, seq);
+    const double par_ms = time_ms(days, config, 4, par);
+
+    std::cout << "=== PER-DAY RESULTS ===\n";
+    size_t mismatches = 0;
+    for (size_t i = 0; i < days.size(); ++i) {
+        if (!same_result(seq[i], par[i])) ++mismatches;
+        std::cout << "[DAY] " << par[i].path.substr(par[i].path.rfind('/') + 1)
+                  << " msgs=" << par[i].stats.msgs << " eod=" << (par[i].stats.reached_eod ? "Y" : "N")
+                  << " pos=" << par[i].position << " pnl=" << par[i].pnl
+                  << " fills=" << par[i].fills << "\n";
+    }
+    std::cout << "sequential_vs_parallel mismatches=" << mismatches << "\n";
+    if (mismatches != 0) ++failures;
+
+    // full days match the single-day driver; the short day never reaches the close
+    for (size_t i = 1; i < par.size(); ++i) {
+        if (par[i].stats.msgs != 12226 || par[i].pnl != -85000 || par[i].position != 1000 ||
+            !par[i].stats.reached_eod) ++failures;
+    }
+    if (par[0].stats.reached_eod || par[0].stats.msgs >= 12226) ++failures;
+
+    // ----- aggregation, including an unreadable day -----
+    std::vector<std::string> with_missing = days;
+    with_missing.push_back(std::string(dir) + "/missing.dat");
+    const BacktestTotals t = summarize(run_backtest(with_missing, config, 3));
+    std::cout << "=== TOTALS ===\n";
+    std::cout << "days=" << t.days << " failed=" << t.failed << " pnl=" << t.pnl
+              << " best=" << t.best_day_pnl << " worst=" << t.worst_day_pnl
+              << " fills=" << t.fills << "\n";
+    if (t.days != FULL_DAYS + 1 || t.failed != 1 ||
+        t.pnl != static_cast<int64_t>(FULL_DAYS) * -85000 + par[0].pnl) ++failures;
+
+    // scaling depends on the machine's cores; printed, not checked
+    std::cout << "=== SCALING ===\n";
+    std::cout << "hw_threads=" << std::thread::hardware_concurrency()
+              << " sequential_ms=" << seq_ms << " parallel_ms=" << par_ms
+              << " speedup=" << (par_ms > 0 ? seq_ms / par_ms : 0.0) << "x\n";
+
+    for (const auto& path : written) std::remove(path.c_str());
+    rmdir(dir);
+
+    std::cout << (failures == 0 ? "[BACKTEST] ALL PASS" : "[BACKTEST] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
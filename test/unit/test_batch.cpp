@@ -0,0 +1,390 @@
+// test_batch.cpp
+#include "orderbook.h"
+#include "itch_parser.h"
+#include "orderbook_filter.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const OrderbookId BOOK = 123;
+
+static Event make_add(OrderId id, Side s, Price px, Quantity qty, RankingTime rt) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = rt;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    e.timestamp = rt;
+    return e;
+}
+static Event make_exec(OrderId id, Side s, Quantity qty) {
+    Event e{};
+    e.type = MessageType::ExecuteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.quantity = qty;
+    return e;
+}
+static Event make_replace(OrderId id, Side s, Price px, Quantity qty) {
+    Event e{};
+    e.type = MessageType::ReplaceOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    return e;
+}
+static Event make_del(OrderId id, Side s) {
+    Event e{};
+    e.type = MessageType::DeleteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    return e;
+}
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+// a book with every output sink attached
+struct Tapped {
+    Orderbook book;
+    std::vector<TopOfBookChanged> tops;
+    std::vector<LevelDelta> deltas;
+    std::vector<QueueChange> queue;
+    Tapped() {
+        book.set_top_sink(&tops);
+        book.set_depth_sink(&deltas);
+        book.set_queue_sink(&queue);
+    }
+};
+
+// book state, depth and queue records identical; top records are checked
+// per batch by the caller (a batch publishes at most one)
+static bool same(const Tapped& a, const Tapped& b) {
+    if (a.book.order_count() != b.book.order_count() ||
+        a.book.best_bid_price() != b.book.best_bid_price() || a.book.best_ask_price() != b.book.best_ask_price() ||
+        a.book.last_exec_price() != b.book.last_exec_price()) return false;
+    DisplayLevel ab, aa, bb, ba;
+    a.book.snapshot_n(100000, ab, aa);
+    b.book.snapshot_n(100000, bb, ba);
+    if (ab != bb || aa != ba) return false;
+    if (a.deltas.size() != b.deltas.size() || a.queue.size() != b.queue.size()) return false;
+    for (size_t i = 0; i < a.deltas.size(); ++i)
+        if (a.deltas[i].price != b.deltas[i].price || a.deltas[i].aggregate != b.deltas[i].aggregate ||
+            a.deltas[i].num_orders != b.deltas[i].num_orders || a.deltas[i].side != b.deltas[i].side) return false;
+    for (size_t i = 0; i < a.queue.size(); ++i)
+        if (a.queue[i].price != b.queue[i].price || a.queue[i].quantity != b.queue[i].quantity ||
+            a.queue[i].ranking_seq_num != b.queue[i].ranking_seq_num) return false;
+    return true;
+}
+
+// packets of executions/deletes/replaces over a deep book, with a few adds
+// (exec_only: one-share executions only); every id referenced is live at
+// that point of the tape
+static std::vector<std::vector<Event>> make_tape(size_t resting, size_t packets, size_t per_packet,
+                                                 size_t levels, unsigned seed, bool same_packet_reuse,
+                                                 bool exec_only = false) {
+    std::mt19937 rng(seed);
+    struct Live { OrderId id; Side side; Quantity qty; };
+    std::vector<Live> live;
+    std::vector<std::vector<Event>> tape;
+    OrderId next = 1;
+    RankingTime t = 1;
+    auto price = [&](Side s) -> Price {
+        return s == Side::Buy ? 1000000 - static_cast<Price>(rng() % levels) * 10
+                              : 1000010 + static_cast<Price>(rng() % levels) * 10;
+    };
+    auto add = [&](std::vector<Event>& out) {
+        const Side s = (rng() & 1) ? Side::Buy : Side::Sell;
+        const Quantity q = 100 + rng() % 1000;
+        out.push_back(make_add(next, s, price(s), q, t++));
+        live.push_back(Live{ next++, s, q });
+    };
+
+    std::vector<Event> build;
+    while (live.size() < resting) add(build);
+    tape.push_back(build);
+
+    for (size_t p = 0; p < packets; ++p) {
+        std::vector<Event> packet;
+        while (packet.size() < per_packet) {
+            const unsigned r = rng() % 20;
+            // same_packet_reuse: often touch the order the previous event added
+            const size_t k = (same_packet_reuse && r < 4 && !packet.empty()) ? live.size() - 1 : rng() % live.size();
+            Live& o = live[k];
+            if (exec_only) {
+                packet.push_back(make_exec(o.id, o.side, 1));
+                if (--o.qty == 0) { live[k] = live.back(); live.pop_back(); }
+            } else if (r < 2) {
+                add(packet);
+            } else if (r < 10) {
+                packet.push_back(make_exec(o.id, o.side, 1 + rng() % 50));
+                if (packet.back().quantity >= o.qty) { live[k] = live.back(); live.pop_back(); add(packet); }
+                else o.qty -= packet.back().quantity;
+            } else if (r < 18) {
+                packet.push_back(make_del(o.id, o.side));
+                live[k] = live.back();
+                live.pop_back();
+                add(packet);
+            } else {
+                o.qty = 100 + rng() % 1000;
+                packet.push_back(make_replace(o.id, o.side, price(o.side), o.qty));
+            }
+        }
+        tape.push_back(packet);
+    }
+    return tape;
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- scripted: deferred level cleanup and top -----
+    std::cout << "=== SCRIPTED ===\n";
+    {
+        Tapped t;
+        t.book.apply(make_add(1, Side::Buy, 100, 10, 1));
+        t.book.apply(make_add(2, Side::Buy, 99, 10, 2));
+        t.book.apply(make_add(3, Side::Sell, 101, 10, 3));
+        t.tops.clear();
+
+        // cancel/replace at the same price: 100 empties and refills
+        std::vector<Event> churn;
+        churn.push_back(make_del(1, Side::Buy));
+        churn.push_back(make_add(4, Side::Buy, 100, 20, 4));
+        BatchSummary sum = t.book.apply_batch(churn);
+        failures += check("emptied and refilled level kept",
+                          sum.levels_revived == 1 && sum.levels_erased == 0 && sum.levels_created == 0 &&
+                          !sum.top_changed() && t.tops.empty() && t.book.best_bid_quantity() == 20);
+
+        // best bid gone, new ask level: one net record
+        std::vector<Event> move;
+        move.push_back(make_del(4, Side::Buy));
+        move.push_back(make_add(5, Side::Sell, 102, 10, 5));
+        move.push_back(make_exec(3, Side::Sell, 10));
+        sum = t.book.apply_batch(move);
+        failures += check("emptied levels erased at the end",
+                          sum.levels_erased == 2 && sum.levels_created == 1 && sum.orders == -1 &&
+                          !t.book.find_level(Side::Buy, 100) && t.book.best_bid_price() == 99);
+        failures += check("one net top change",
+                          sum.old_bid == 100 && sum.new_bid == 99 && sum.old_ask == 101 && sum.new_ask == 102 &&
+                          t.tops.size() == 1 && t.tops[0].old_bid == 100 && t.tops[0].new_ask == 102 &&
+                          t.tops[0].cause == MessageType::ExecuteOrder && t.tops[0].side == Side::Sell);
+
+        // top moves and comes back inside the batch: no record
+        std::vector<Event> blip;
+        blip.push_back(make_add(6, Side::Buy, 100, 5, 6));
+        blip.push_back(make_del(6, Side::Buy));
+        sum = t.book.apply_batch(blip);
+        failures += check("top back where it was publishes nothing",
+                          !sum.top_changed() && t.tops.size() == 1 && sum.levels_created == 1 &&
+                          sum.levels_erased == 1 && t.book.has_top());
+
+        // an event behind the top does not take over the record
+        std::vector<Event> behind;
+        behind.push_back(make_del(2, Side::Buy));
+        behind.push_back(make_add(7, Side::Sell, 200, 10, 7));
+        t.book.apply(make_add(8, Side::Buy, 90, 10, 8));
+        t.tops.clear();
+        sum = t.book.apply_batch(behind);
+        failures += check("record names the event that moved the top",
+                          t.tops.size() == 1 && t.tops[0].old_bid == 99 && t.tops[0].new_bid == 90 &&
+                          t.tops[0].order_id == 2 && t.tops[0].cause == MessageType::DeleteOrder &&
+                          t.tops[0].side == Side::Buy);
+    }
+
+    // ----- randomized: batch vs. one at a time, identical outputs -----
+    std::cout << "=== RANDOM ===\n";
+    {
+        const std::vector<std::vector<Event>> tape = make_tape(300, 3000, 24, 150, 7, true);
+        Tapped single, batched;
+        bool ok = true, tops_ok = true, summary_ok = true;
+        size_t events = 0, revived = 0;
+        for (const std::vector<Event>& packet : tape) {
+            const Price bid0 = single.book.best_bid_price(), ask0 = single.book.best_ask_price();
+            const size_t orders0 = single.book.order_count();
+            const size_t tops0 = batched.tops.size(), single_tops0 = single.tops.size();
+            for (const Event& ev : packet) single.book.apply(ev);
+            const BatchSummary sum = batched.book.apply_batch(packet);
+            events += packet.size();
+            revived += sum.levels_revived;
+            ok = ok && single.book.order_count() == batched.book.order_count();
+
+            // one net record per batch, only when the top moved
+            const Price bid1 = single.book.best_bid_price(), ask1 = single.book.best_ask_price();
+            const bool moved = bid1 != bid0 || ask1 != ask0;
+            tops_ok = tops_ok && batched.tops.size() == tops0 + (moved ? 1 : 0);
+            if (moved && batched.tops.size() > tops0) {
+                const TopOfBookChanged& t = batched.tops.back();
+                tops_ok = tops_ok && t.old_bid == bid0 && t.old_ask == ask0 && t.new_bid == bid1 && t.new_ask == ask1;
+                // attributed like the last per-event record of the packet
+                const TopOfBookChanged& last = single.tops.back();
+                tops_ok = tops_ok && single.tops.size() > single_tops0 && t.order_id == last.order_id &&
+                          t.cause == last.cause && t.side == last.side && t.timestamp == last.timestamp;
+            }
+            summary_ok = summary_ok && sum.events == packet.size() && sum.top_changed() == moved &&
+                         sum.new_bid == bid1 && sum.new_ask == ask1 &&
+                         sum.orders == static_cast<int64_t>(single.book.order_count()) - static_cast<int64_t>(orders0);
+        }
+        std::cout << "events=" << events << " orders=" << batched.book.order_count()
+                  << " deltas=" << batched.deltas.size() << " tops single=" << single.tops.size()
+                  << " batched=" << batched.tops.size() << " revived=" << revived << "\n";
+        failures += check("batch matches one-at-a-time, incl. ids reused within a packet", ok && same(single, batched));
+        failures += check("one net top record per batch that moved the top", tops_ok);
+        failures += check("summary matches the book", summary_ok && revived > 0);
+
+        Orderbook edge;
+        edge.apply_batch(nullptr, 0);
+        const Event lone = make_add(1, Side::Buy, 100, 10, 1);
+        edge.apply_batch(&lone, 1);
+        const Event unknown = make_del(99, Side::Buy);
+        edge.prefetch(unknown);
+        failures += check("empty, single-event batches and unknown ids", edge.order_count() == 1);
+    }
+
+    // ----- capture: packets straight from the parser -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    {
+        const OrderbookId TARGET_BOOK = 73616;
+        const OrderbookFilter subscribed{TARGET_BOOK};
+        std::ifstream file(FILE_PATH, std::ios::binary);
+        ItchParser parser(file);
+        parser.set_filter(&subscribed);
+        Tapped single, batched;
+        size_t batches = 0, moved = 0;
+        bool tops_ok = true;
+        std::vector<Event> ns_batch;
+        auto flush = [&]() {
+            if (ns_batch.empty()) return;
+            const BatchSummary sum = batched.book.apply_batch(ns_batch);
+            tops_ok = tops_ok && sum.new_bid == single.book.best_bid_price() &&
+                      sum.new_ask == single.book.best_ask_price();
+            moved += sum.top_changed();
+            ++batches;
+            ns_batch.clear();
+        };
+        while (parser.good()) {
+            for (const Event& ev : parser.next_packet()) {
+                if (ev.orderbook_id != TARGET_BOOK) continue;
+                if (!ns_batch.empty() && ev.timestamp != ns_batch.back().timestamp) flush();
+                single.book.apply(ev);
+                ns_batch.push_back(ev);
+            }
+        }
+        flush();
+        std::cout << "ns_batches=" << batches << " top_moves=" << moved << " (single: " << single.tops.size()
+                  << " records, batched: " << batched.tops.size() << ")\n";
+        failures += check("capture ns batches match one-at-a-time", batches > 0 && tops_ok &&
+                                                                   batched.tops.size() == moved && same(single, batched));
+    }
+
+    // ----- benchmark: deep book, random orders per packet -----
+    std::cout << "=== BENCHMARK ===\n";
+    for (int mix = 0; mix < 2; ++mix) {
+        const bool exec_only = mix == 0;
+        const std::vector<std::vector<Event>> tape = make_tape(400000, 40000, 16, 20000, 11, false, exec_only);
+        size_t events = 0;
+        for (size_t p = 1; p < tape.size(); ++p) events += tape[p].size();
+
+        double single_ns = 0, batch_ns = 0;
+        size_t single_orders = 0, batch_orders = 0;
+        {
+            Orderbook ob;
+            ob.apply_batch(tape[0]);
+            const auto t0 = std::chrono::steady_clock::now();
+            for (size_t p = 1; p < tape.size(); ++p)
+                for (const Event& ev : tape[p]) ob.apply(ev);
+            single_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            single_orders = ob.order_count();
+        }
+        {
+            Orderbook ob;
+            ob.apply_batch(tape[0]);
+            const auto t0 = std::chrono::steady_clock::now();
+            for (size_t p = 1; p < tape.size(); ++p) ob.apply_batch(tape[p]);
+            batch_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            batch_orders = ob.order_count();
+        }
+        std::cout << (exec_only ? "executions: " : "mixed:      ") << "events=" << events
+                  << " ns_per_event one_at_a_time=" << single_ns / events
+                  << " batched=" << batch_ns / events
+                  << " speedup=" << (batch_ns > 0 ? single_ns / batch_ns : 0) << "x\n";
+        failures += check(exec_only ? "benchmark books agree (executions)" : "benchmark books agree (mixed)",
+                          single_orders == batch_orders && single_orders > 0);
+    }
+
+    // ----- benchmark: cancel/replace churn at the same prices -----
+    std::cout << "=== CHURN ===\n";
+    {
+        // one order per level; each batch cancels orders and re-adds at the same price
+        const size_t LEVELS = 20000, BATCHES = 50000, PAIRS = 4;
+        std::mt19937 rng(5);
+        std::vector<std::vector<Event>> tape(1);
+        std::vector<OrderId> at(LEVELS);
+        OrderId next = 1;
+        RankingTime t = 1;
+        for (size_t l = 0; l < LEVELS; ++l) {
+            at[l] = next;
+            tape[0].push_back(make_add(next++, Side::Buy, 1000000 - static_cast<Price>(l) * 10, 100, t++));
+        }
+        for (size_t b = 0; b < BATCHES; ++b) {
+            std::vector<Event> batch;
+            for (size_t k = 0; k < PAIRS; ++k) {
+                const size_t l = rng() % LEVELS;
+                batch.push_back(make_del(at[l], Side::Buy));
+                at[l] = next;
+                batch.push_back(make_add(next++, Side::Buy, 1000000 - static_cast<Price>(l) * 10, 100, t++));
+            }
+            tape.push_back(batch);
+        }
+        const size_t events = BATCHES * PAIRS * 2;
+
+        double single_ns = 0, batch_ns = 0;
+        uint64_t revived = 0;
+        size_t single_levels = 0, batch_levels = 0;
+        {
+            Orderbook ob;
+            ob.apply_batch(tape[0]);
+            const auto t0 = std::chrono::steady_clock::now();
+            for (size_t b = 1; b < tape.size(); ++b)
+                for (const Event& ev : tape[b]) ob.apply(ev);
+            single_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            single_levels = ob.memory().levels.nodes;
+        }
+        {
+            Orderbook ob;
+            ob.apply_batch(tape[0]);
+            const auto t0 = std::chrono::steady_clock::now();
+            for (size_t b = 1; b < tape.size(); ++b) revived += ob.apply_batch(tape[b]).levels_revived;
+            batch_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            batch_levels = ob.memory().levels.nodes;
+        }
+        std::cout << "events=" << events << " ns_per_event one_at_a_time=" << single_ns / events
+                  << " batched=" << batch_ns / events << " speedup=" << (batch_ns > 0 ? single_ns / batch_ns : 0)
+                  << "x levels_revived=" << revived << "\n";
+        failures += check("churn keeps every level", single_levels == LEVELS && batch_levels == LEVELS &&
+                                                     revived >= BATCHES * PAIRS / 2);
+    }
+
+    std::cout << (failures == 0 ? "[BATCH] ALL PASS" : "[BATCH] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
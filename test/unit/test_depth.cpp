@@ -0,0 +1,223 @@
+// test_depth.cpp
+#include "orderbook.h"
+#include "itch_parser.h"
+#include "orderbook_filter.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const OrderbookId BOOK = 123;
+
+static Event make_add(OrderId id, Side s, Price px, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = ns;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    e.timestamp = ns;
+    return e;
+}
+static Event make_exec(OrderId id, Side s, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::ExecuteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.quantity = qty;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_replace(OrderId id, Side s, Price px, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::ReplaceOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    e.timestamp = ns;
+    return e;
+}
+static Event make_del(OrderId id, Side s, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::DeleteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.timestamp = ns;
+    return e;
+}
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+// every query against the same numbers recomputed from the price tree
+static bool consistent(const Orderbook& ob) {
+    DisplayLevel bids, asks;
+    ob.snapshot_n(1000, bids, asks);
+    for (int s = 0; s < 2; ++s) {
+        const Side side = s == 0 ? Side::Buy : Side::Sell;
+        const DisplayLevel& ref = s == 0 ? bids : asks;
+
+        std::vector<LevelStats> seen;
+        ob.visit_levels(side, TopLevels::CAPACITY, [&](const LevelStats& l) { seen.push_back(l); });
+        if (seen.size() != std::min(ref.size(), TopLevels::CAPACITY)) return false;
+
+        Quantity cum = 0;
+        uint64_t orders = 0;
+        for (size_t k = 0; k < seen.size(); ++k) {
+            const PriceLevel* level = ob.find_level(side, ref[k].first);
+            if (seen[k].price != ref[k].first || seen[k].aggregate != ref[k].second ||
+                !level || seen[k].num_orders != level->num_orders) return false;
+            cum += ref[k].second;
+            orders += level->num_orders;
+            if (ob.depth(side, k + 1) != cum || ob.depth_orders(side, k + 1) != orders) return false;
+        }
+
+        // depth_to at, between and past every level (incl. past the window)
+        Quantity to = 0;
+        for (size_t k = 0; k < ref.size(); ++k) {
+            to += ref[k].second;
+            if (ob.depth_to(side, ref[k].first) != to) return false;
+        }
+        const Price beyond = (side == Side::Buy) ? 0 : 0xFFFFFFFFu;
+        if (ob.depth_to(side, beyond) != to) return false;
+    }
+    return true;
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- scripted: window fill, refill and imbalance -----
+    std::cout << "=== SCRIPTED ===\n";
+    {
+        Orderbook ob;
+        uint64_t ns = 1;
+        for (OrderId i = 0; i < 20; ++i) ob.apply(make_add(100 + i, Side::Buy, 1000 - static_cast<Price>(i) * 10, 100, ns++));
+        for (OrderId i = 0; i < 3; ++i)  ob.apply(make_add(200 + i, Side::Sell, 1010 + static_cast<Price>(i) * 10, 50, ns++));
+        ob.apply(make_add(300, Side::Buy, 1000, 40, ns++));
+
+        failures += check("depth over k levels", ob.depth(Side::Buy, 1) == 140 && ob.depth(Side::Buy, 3) == 340 &&
+                                                 ob.depth_orders(Side::Buy, 1) == 2);
+        failures += check("k past the side", ob.depth(Side::Sell, 10) == 150 && ob.depth_orders(Side::Sell, 10) == 3);
+        failures += check("depth_to inside and past the window",
+                          ob.depth_to(Side::Buy, 995) == 140 && ob.depth_to(Side::Buy, 850) == 1640 &&
+                          ob.depth_to(Side::Buy, 810) == 2040 && ob.depth_to(Side::Sell, 1015) == 50 &&
+                          ob.depth_to(Side::Sell, 1000) == 0);
+        const double imb = ob.imbalance(1);
+        std::cout << "imbalance(1)=" << imb << " imbalance(3)=" << ob.imbalance(3) << "\n";
+        failures += check("imbalance", imb > 0.47 && imb < 0.48 && ob.imbalance(0) == 0.0);
+
+        ob.apply(make_del(100, Side::Buy, ns++));
+        ob.apply(make_del(300, Side::Buy, ns++));     // best level gone: level 17 slides into the window
+        size_t visited = 0;
+        Price last = 0;
+        ob.visit_levels(Side::Buy, 100, [&](const LevelStats& l) { ++visited; last = l.price; });
+        failures += check("full window refilled from the tree", visited == TopLevels::CAPACITY && last == 840 &&
+                                                                ob.depth(Side::Buy, 100) == 1600);
+        ob.apply(make_replace(119, Side::Buy, 1005, 70, ns++));  // deepest level jumps to the top
+        failures += check("replace moves a level into the window", ob.depth(Side::Buy, 1) == 70 &&
+                                                                   ob.depth_to(Side::Buy, 1000) == 70 && consistent(ob));
+    }
+
+    // ----- randomized against snapshot_n -----
+    std::cout << "=== RANDOM ===\n";
+    {
+        Orderbook ob;
+        std::mt19937 rng(17);
+        struct Live { OrderId id; Side side; Quantity qty; };
+        std::vector<Live> live;
+        OrderId next = 1;
+        bool ok = true;
+        size_t events = 0;
+        auto random_price = [&](Side s) -> Price {
+            return s == Side::Buy ? 1000 - (rng() % 40) * 10 : 1010 + (rng() % 40) * 10;
+        };
+        for (uint64_t ns = 1; ns <= 20000 && ok; ++ns) {
+            const unsigned r = rng() % 10;
+            if (r < 5 || live.empty()) {
+                const Side s = (rng() & 1) ? Side::Buy : Side::Sell;
+                const Quantity q = 1 + rng() % 500;
+                ob.apply(make_add(next, s, random_price(s), q, ns));
+                live.push_back(Live{ next++, s, q });
+            } else {
+                const size_t i = rng() % live.size();
+                Live& o = live[i];
+                bool gone = false;
+                if (r < 7) {
+                    ob.apply(make_del(o.id, o.side, ns));
+                    gone = true;
+                } else if (r < 9) {
+                    const Quantity q = 1 + rng() % 300;
+                    ob.apply(make_exec(o.id, o.side, q, ns));
+                    gone = q >= o.qty;
+                    if (!gone) o.qty -= q;
+                } else {
+                    o.qty = 1 + rng() % 500;
+                    ob.apply(make_replace(o.id, o.side, random_price(o.side), o.qty, ns));
+                }
+                if (gone) { live[i] = live.back(); live.pop_back(); }
+            }
+            ++events;
+            ok = consistent(ob);
+        }
+        std::cout << "events=" << events << " orders=" << ob.order_count() << "\n";
+        failures += check("queries match the price tree after every event", ok);
+    }
+
+    // ----- capture: cached queries against snapshot_n, timing -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    const OrderbookId TARGET_BOOK = 73616;
+    const OrderbookFilter subscribed{TARGET_BOOK};
+    std::ifstream file(FILE_PATH, std::ios::binary);
+    ItchParser parser(file);
+    parser.set_filter(&subscribed);
+    Orderbook ob;
+    bool ok = true;
+    size_t events = 0;
+    double cached_ns = 0, snapshot_ns = 0, sink = 0;
+    DisplayLevel bids, asks;
+    while (parser.good()) {
+        for (const Event& ev : parser.next_packet()) {
+            if (ev.orderbook_id != TARGET_BOOK) continue;
+            ob.apply(ev);
+            ++events;
+            if (events % 16 == 0) ok = ok && consistent(ob);
+
+            const auto t0 = std::chrono::steady_clock::now();
+            sink += ob.imbalance(5) + static_cast<double>(ob.depth(Side::Buy, 5) + ob.depth(Side::Sell, 5));
+            const auto t1 = std::chrono::steady_clock::now();
+            ob.snapshot_n(5, bids, asks);
+            Quantity b = 0, a = 0;
+            for (const auto& l : bids) b += l.second;
+            for (const auto& l : asks) a += l.second;
+            sink += (b + a) > 0 ? (static_cast<double>(b) - static_cast<double>(a)) / static_cast<double>(b + a) : 0.0;
+            const auto t2 = std::chrono::steady_clock::now();
+            cached_ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            snapshot_ns += std::chrono::duration<double, std::nano>(t2 - t1).count();
+        }
+    }
+    std::cout << "events=" << events << " ns_per_query cached=" << cached_ns / events
+              << " snapshot_n=" << snapshot_ns / events << " (sink " << (sink != 0) << ")\n";
+    failures += check("capture queries match the price tree", ok && events > 0);
+
+    std::cout << (failures == 0 ? "[DEPTH] ALL PASS" : "[DEPTH] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
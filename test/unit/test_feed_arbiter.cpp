@@ -0,0 +1,148 @@
+// test_feed_arbiter.cpp
+#include "feed_arbiter.h"
+#include "itch_parser.h"
+#include "moldudp64.h"
+#include "udp_feed.h"
+#include "udp_receiver.h"
+#include "udp_sender.h"
+#include "util/tape_writer.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+using Packet = std::vector<char>;
+
+// ----- synthetic session: many small packets -----
+static TapeWriter make_tape(size_t n) {
+    TapeWriter w("ARBSESS001", 1, 300);
+    const OrderbookId BOOK = 73616;
+    Nanoseconds ns = 1000;
+    std::srand(17);
+
+    w.state(ns, BOOK, "P_SUREKLI_ISLEM");
+    for (size_t i = 1; i <= n; ++i) {
+        ns += std::rand() % 3;
+        const Side side = (i % 2) ? Side::Buy : Side::Sell;
+        w.add(ns, i, BOOK, side, static_cast<RankingSeqNum>(i), 100 + i,
+              side == Side::Buy ? 9990 : 10000, 5000 + i);
+        if (i % 4 == 0) w.execute(ns, i, BOOK, side, 10, i);
+        if (i % 7 == 0) w.flush();
+    }
+    w.state(ns + 1, BOOK, "P_MARJ_YAYIN_KAPANIS");
+    w.end_session();
+    return w;
+}
+
+// Each line loses a different set of packets; none is lost on both, and the
+// end-of-session packet always gets through.
+static bool lost_on_a(size_t i, size_t n) { return i + 1 < n && i % 7 == 2; }
+static bool lost_on_b(size_t i, size_t n) { return i + 1 < n && i % 5 == 0 && !lost_on_a(i, n); }
+
+static std::vector<Event> decode_all(const std::vector<Packet>& packets) {
+    ItchParser decoder;
+    std::vector<Event> events;
+    for (const Packet& p : packets) decoder.parse_packet(p.data(), p.size(), events);
+    return events;
+}
+
+static size_t count_diff(const std::vector<Event>& a, const std::vector<Event>& b) {
+    size_t diff = a.size() > b.size() ? a.size() - b.size() : b.size() - a.size();
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].order_id != b[i].order_id ||
+            a[i].nanosec != b[i].nanosec || a[i].quantity != b[i].quantity) ++diff;
+    }
+    return diff;
+}
+
+int main() {
+    int failures = 0;
+    TapeWriter tape = make_tape(300);
+    const std::vector<Packet>& packets = tape.packets();
+    const size_t n = packets.size();
+    const std::vector<Event> expected = decode_all(packets);
+
+    size_t only_b = 0, sent_b = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (lost_on_a(i, n)) ++only_b;
+        if (!lost_on_b(i, n)) ++sent_b;
+    }
+    std::cout << "packets=" << n << " events=" << expected.size()
+              << " lost_on_a=" << only_b << "\n";
+
+    // ----- line A leads, line B trails by three packets -----
+    std::cout << "=== OFFLINE A/B ===\n";
+    {
+        const size_t LAG = 3;
+        FeedArbiter arb(1);
+        std::vector<Packet> released;
+        for (size_t i = 0; i < n + LAG; ++i) {
+            if (i < n && !lost_on_a(i, n)) {
+                arb.offer(FeedArbiter::LINE_A, packets[i].data(), packets[i].size());
+                for (const auto& v : arb.ready()) released.push_back(Packet(v.data, v.data + v.len));
+            }
+            if (i >= LAG && !lost_on_b(i - LAG, n)) {
+                const Packet& p = packets[i - LAG];
+                arb.offer(FeedArbiter::LINE_B, p.data(), p.size());
+                for (const auto& v : arb.ready()) released.push_back(Packet(v.data, v.data + v.len));
+            }
+        }
+        const ArbiterStats& s = arb.stats();
+        const std::vector<Event> got = decode_all(released);
+        const size_t diff = count_diff(expected, got);
+        std::cout << "[ARB] wins A=" << s.wins[0] << " B=" << s.wins[1]
+                  << " late A=" << s.late[0] << " B=" << s.late[1] << "\n";
+        std::cout << "events=" << got.size() << " diff=" << diff
+                  << " lost=" << arb.sequencer().stats().lost
+                  << " ended=" << (arb.sequencer().ended() ? "yes" : "no") << "\n";
+        // wins cover every data packet once; B wins exactly what A lost
+        if (diff != 0 || !arb.sequencer().ended()) ++failures;
+        if (s.wins[1] != only_b || s.wins[0] + s.wins[1] != n - 1) ++failures;
+        if (s.late[0] != 0 || s.late[1] != sent_b - 1 - only_b) ++failures;
+    }
+
+    // ----- two loopback receivers, no request server -----
+    std::cout << "=== LOOPBACK A/B ===\n";
+    {
+        UdpReceiverConfig cfg;
+        cfg.bind_addr = "127.0.0.1";
+        cfg.rcvbuf_bytes = 0;
+        cfg.timeout_ms = 20;
+        UdpReceiver rx_a(cfg);
+        UdpReceiver rx_b(cfg);
+        UdpSender tx_a("127.0.0.1", rx_a.local_port());
+        UdpSender tx_b("127.0.0.1", rx_b.local_port());
+        if (!rx_a.ok() || !rx_b.ok() || !tx_a.ok() || !tx_b.ok()) return 1;
+
+        ItchParser decoder;
+        UdpFeed feed(rx_a, rx_b, decoder);
+        feed.set_gap_timeout_ns(2000000000ull);   // never skip: the other line must fill it
+
+        std::vector<Event> got;
+        size_t sent = 0;
+        auto last_progress = std::chrono::steady_clock::now();
+        while (feed.good() && std::chrono::steady_clock::now() - last_progress < std::chrono::seconds(2)) {
+            for (size_t k = 0; k < 8 && sent < n; ++k, ++sent) {
+                if (!lost_on_a(sent, n)) tx_a.send(packets[sent].data(), packets[sent].size());
+                if (!lost_on_b(sent, n)) tx_b.send(packets[sent].data(), packets[sent].size());
+            }
+            auto events = feed.next_packet();
+            if (!events.empty()) last_progress = std::chrono::steady_clock::now();
+            got.insert(got.end(), events.begin(), events.end());
+        }
+
+        const ArbiterStats& s = feed.arbitration();
+        const size_t diff = count_diff(expected, got);
+        std::cout << "events=" << got.size() << " diff=" << diff
+                  << " wins=" << (s.wins[0] + s.wins[1]) << " of " << (n - 1)
+                  << " lost=" << feed.sequencer().stats().lost
+                  << " end_of_session=" << (feed.good() ? "no" : "yes") << "\n";
+        if (diff != 0 || feed.good() || s.wins[0] + s.wins[1] != n - 1 || s.wins[1] < only_b) ++failures;
+    }
+
+    std::cout << "[FEED ARBITER] " << (failures == 0 ? "ALL PASS" : "FAILURES") << "\n";
+    return failures == 0 ? 0 : 1;
+}
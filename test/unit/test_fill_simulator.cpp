@@ -0,0 +1,246 @@
+// test_fill_simulator.cpp
+#include "fill_simulator.h"
+#include "itch_parser.h"
+#include "orderbook.h"
+#include "orderbook_filter.h"
+#include "replay.h"
+#include "replay_observers.h"
+#include "strategy.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static const OrderbookId BOOK = 1;
+
+// --- helpers to create events ---
+static Event make_add(OrderId id, Side s, Price px, Quantity qty, RankingTime rt, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = rt;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_exec(OrderId id, Side s, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::ExecuteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.quantity = qty;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_delete(OrderId id, Side s, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::DeleteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_replace(OrderId id, Side s, Price px, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::ReplaceOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+
+// applies one event and feeds its queue changes to the simulator
+struct Harness {
+    Orderbook book;
+    QueueFillSimulator sim{book};
+    std::vector<QueueChange> changes;
+
+    Harness() { book.set_queue_sink(&changes); }
+
+    void apply(const Event& e) {
+        book.apply(e);
+        sim.apply(changes);
+        changes.clear();
+    }
+    Quantity filled(uint32_t owner) const {
+        Quantity q = 0;
+        for (const VirtualFill& f : sim.fills()) if (f.owner == owner) q += f.quantity;
+        return q;
+    }
+};
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+// fans one replay out to many strategies sharing a simulator (a sweep)
+struct StrategyFan {
+    std::vector<std::unique_ptr<Strategy>> strategies;
+
+    void on_top_change(Timestamp ns, const Orderbook& ob, const TopOfBookChanged& change) {
+        for (auto& s : strategies) s->on_top_change(ns, ob, change);
+    }
+    void end_of_day(const Orderbook& ob) {
+        for (auto& s : strategies) s->end_of_day(ob);
+    }
+    void on_fill(const VirtualFill& f) { strategies[f.owner]->on_fill(f); }
+    void on_arrival(const DelayedOrder& o, const Orderbook& ob) { strategies[o.owner]->on_arrival(o, ob); }
+};
+
+static double run_fan(const char* path, size_t count, StrategyFan& fan,
+                      Orderbook& book, QueueFillSimulator& sim) {
+    const OrderbookId TARGET_BOOK = 73616;
+    std::ifstream file(path, std::ios::binary);
+    ItchParser parser(file);
+    const OrderbookFilter subscribed{TARGET_BOOK};
+    parser.set_filter(&subscribed);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Quantity qty = 25 * static_cast<Quantity>(1 + i % 8);
+        fan.strategies.emplace_back(new Strategy(TARGET_BOOK, qty, /*max_pos=*/qty * (1 + i % 10), /*min_pos=*/0));
+        fan.strategies.back()->set_trade_log(nullptr);
+        fan.strategies.back()->set_fill_simulator(&sim, static_cast<uint32_t>(i));
+    }
+
+    NullObserver obs;
+    const auto t0 = std::chrono::steady_clock::now();
+    replay_day_top_driven(parser, TARGET_BOOK, book, fan, obs, &sim);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- queue ahead drains, then executions behind fill the virtual order -----
+    std::cout << "=== QUEUE AHEAD ===\n";
+    {
+        Harness h;
+        h.apply(make_add(1, Side::Buy, 100, 300, 10, 1));
+        h.apply(make_add(2, Side::Buy, 100, 200, 20, 2));
+        h.apply(make_add(3, Side::Sell, 110, 500, 5, 3));
+        const uint32_t v = h.sim.place(0, Side::Buy, 100, 100, 4);
+        std::cout << "placed ahead=" << h.sim.queue_ahead(v) << "\n";
+        failures += check("ahead is the level aggregate", h.sim.queue_ahead(v) == 500);
+
+        h.apply(make_exec(1, Side::Buy, 100, 5));
+        failures += check("execution ahead shrinks the queue", h.sim.queue_ahead(v) == 400 && h.sim.fills().empty());
+        h.apply(make_delete(2, Side::Buy, 6));
+        failures += check("deletion ahead shrinks the queue", h.sim.queue_ahead(v) == 200);
+        h.apply(make_add(4, Side::Buy, 100, 80, 30, 7));
+        failures += check("later add queues behind", h.sim.queue_ahead(v) == 200);
+        h.apply(make_exec(1, Side::Buy, 200, 8));
+        failures += check("queue ahead consumed, no fill yet", h.sim.queue_ahead(v) == 0 && h.sim.fills().empty());
+        h.apply(make_exec(4, Side::Buy, 60, 9));
+        failures += check("execution behind fills the virtual order", h.filled(0) == 60 && h.sim.remaining(v) == 40);
+        h.apply(make_exec(4, Side::Buy, 20, 10));
+        failures += check("partial fill continues", h.filled(0) == 80 && h.sim.remaining(v) == 20);
+        std::cout << "fills=" << h.sim.fills().size() << " remaining=" << h.sim.remaining(v)
+                  << " resting=" << h.sim.resting() << "\n";
+        failures += check("fill time is the execution's", h.sim.fills().back().timestamp == 10);
+    }
+
+    // ----- executions through a better virtual price sweep it -----
+    std::cout << "=== SWEEP / MARKETABLE ===\n";
+    {
+        Harness h;
+        h.apply(make_add(1, Side::Buy, 100, 300, 10, 1));
+        h.apply(make_add(2, Side::Sell, 110, 500, 5, 2));
+        const uint32_t inside = h.sim.place(0, Side::Sell, 105, 100, 3);   // inside the spread
+        const uint32_t deeper = h.sim.place(0, Side::Sell, 120, 100, 3);   // behind the best ask
+        failures += check("empty level has nothing ahead", h.sim.queue_ahead(inside) == 0);
+        h.apply(make_exec(2, Side::Sell, 50, 4));
+        failures += check("better ask swept completely", h.sim.remaining(inside) == 0 && h.filled(0) == 100);
+        failures += check("worse ask untouched", h.sim.remaining(deeper) == 100 && h.sim.resting() == 1);
+
+        h.sim.clear_fills();
+        const uint32_t cross = h.sim.place(0, Side::Buy, 110, 70, 5);
+        failures += check("marketable order fills at once", h.sim.remaining(cross) == 0 && h.filled(0) == 70);
+        failures += check("cancel removes the rest", h.sim.cancel(deeper) && h.sim.resting() == 0 && !h.sim.cancel(deeper));
+    }
+
+    // ----- replace reductions and priority ties -----
+    std::cout << "=== REPLACE ===\n";
+    {
+        Harness h;
+        h.apply(make_add(1, Side::Sell, 110, 300, 10, 1));
+        const uint32_t v = h.sim.place(0, Side::Sell, 110, 100, 2);
+        h.apply(make_replace(1, Side::Sell, 110, 120, 3));
+        failures += check("in-place reduction shrinks the queue", h.sim.queue_ahead(v) == 120);
+        h.apply(make_replace(1, Side::Sell, 110, 500, 4));   // loses priority: requeued behind
+        failures += check("requeued order leaves the queue ahead", h.sim.queue_ahead(v) == 0);
+        h.apply(make_exec(1, Side::Sell, 30, 5));
+        failures += check("requeued order's execution fills us", h.filled(0) == 30);
+    }
+
+    // ----- owners do not interact; the real book is untouched -----
+    std::cout << "=== OWNERS ===\n";
+    {
+        Harness h;
+        h.apply(make_add(1, Side::Buy, 100, 300, 10, 1));
+        h.apply(make_add(2, Side::Buy, 100, 100, 20, 2));
+        h.apply(make_add(3, Side::Sell, 110, 500, 5, 3));
+        std::vector<std::pair<Price, Quantity>> bids_before, asks_before, bids_after, asks_after;
+        h.book.snapshot_n(5, bids_before, asks_before);
+
+        const uint32_t a = h.sim.place(0, Side::Buy, 100, 200, 4);
+        const uint32_t b = h.sim.place(1, Side::Buy, 100, 200, 4);
+        h.book.snapshot_n(5, bids_after, asks_after);
+        failures += check("book not mutated by virtual orders",
+                          bids_before == bids_after && asks_before == asks_after &&
+                          h.book.best_bid_quantity() == 400);
+        failures += check("owners see the same queue", h.sim.queue_ahead(a) == 400 && h.sim.queue_ahead(b) == 400);
+
+        h.apply(make_exec(1, Side::Buy, 300, 5));
+        h.apply(make_exec(2, Side::Buy, 100, 6));
+        h.apply(make_add(4, Side::Buy, 100, 150, 30, 7));
+        h.apply(make_exec(4, Side::Buy, 150, 8));
+        failures += check("each owner fills independently", h.filled(0) == 150 && h.filled(1) == 150);
+    }
+
+    // ----- real capture: one shared simulator, many strategies -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    double base_ms = 0;
+    for (size_t count : {size_t(1), size_t(64), size_t(512)}) {
+        StrategyFan fan;
+        Orderbook book;
+        QueueFillSimulator sim(book);
+        const double ms = run_fan(FILE_PATH, count, fan, book, sim);
+        if (count == 1) base_ms = ms;
+
+        size_t fills = 0;
+        for (const auto& s : fan.strategies) fills += s->fills();
+        std::cout << "strategies=" << count << " fills=" << fills << " resting=" << sim.resting()
+                  << " ms=" << ms << " per_strategy_ms=" << (ms - base_ms) / count << "\n";
+        failures += check("working orders cancelled at the close", sim.resting() == 0);
+        if (count == 1) {
+            const Strategy& s = *fan.strategies[0];
+            std::cout << "strategy0 pos=" << s.position() << " pnl=" << s.realized_pnl() << "\n";
+            failures += check("queue fills stay within limits", s.position() <= 25 && s.pending_buy() == 0);
+        }
+    }
+
+    std::cout << (failures == 0 ? "[FILL SIM] ALL PASS" : "[FILL SIM] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
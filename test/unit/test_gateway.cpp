@@ -0,0 +1,239 @@
+// test_gateway.cpp
+#include "order_gateway.h"
+#include "ouch.h"
+#include "spsc_ring.h"
+#include "itch_parser.h"
+#include "orderbook.h"
+#include "orderbook_filter.h"
+#include "replay.h"
+#include "replay_observers.h"
+#include "strategy.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+static bool same(const ouch::Message& a, const ouch::Message& b) {
+    return a.type == b.type && a.timestamp == b.timestamp && a.token == b.token && a.book == b.book &&
+           a.side == b.side && a.quantity == b.quantity && a.price == b.price && a.order_id == b.order_id &&
+           a.match_id == b.match_id && a.reason == b.reason && a.time_in_force == b.time_in_force;
+}
+
+// message with only the fields its type carries
+static ouch::Message sample(ouch::Type type) {
+    ouch::Message m;
+    m.type = type;
+    m.token = 12345678901234ull;
+    if (type != ouch::Type::EnterOrder && type != ouch::Type::CancelOrder) m.timestamp = 0x0102030405060708ull;
+    if (type == ouch::Type::CancelOrder) return m;
+    if (type == ouch::Type::Rejected) { m.reason = 7; return m; }
+    m.book = 73616;
+    if (type != ouch::Type::Executed) m.side = Side::Sell;
+    if (type != ouch::Type::Rejected) m.quantity = 0x1122334455ull;
+    if (type != ouch::Type::Canceled) m.price = 9990;
+    if (type == ouch::Type::Accepted) m.order_id = 42;
+    if (type == ouch::Type::Executed) m.match_id = 99;
+    if (type == ouch::Type::Canceled) { m.price = 0; m.reason = 1; }
+    return m;
+}
+
+// polls until want reports arrived or a second passed
+static std::vector<ExecutionReport> collect(OrderGateway& gw, size_t want) {
+    std::vector<ExecutionReport> out;
+    const uint64_t deadline = OrderGateway::now_ns() + 1000000000ull;
+    while (out.size() < want && OrderGateway::now_ns() < deadline) {
+        if (gw.poll([&](const ExecutionReport& r) { out.push_back(r); }) == 0) std::this_thread::yield();
+    }
+    return out;
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- wire format -----
+    std::cout << "=== OUCH ===\n";
+    {
+        const ouch::Type types[] = { ouch::Type::EnterOrder, ouch::Type::CancelOrder, ouch::Type::Accepted,
+                                     ouch::Type::Executed, ouch::Type::Canceled, ouch::Type::Rejected };
+        bool round_trip = true;
+        std::vector<char> stream;
+        for (ouch::Type t : types) {
+            char frame[ouch::MAX_FRAME];
+            const ouch::Message m = sample(t);
+            const size_t n = ouch::encode(frame, m);
+            ouch::Message back;
+            round_trip = round_trip && n == ouch::LENGTH_SIZE + ouch::message_size(t) &&
+                         ouch::decode(frame, n, back) == n && same(m, back);
+            stream.insert(stream.end(), frame, frame + n);
+        }
+        failures += check("every type round-trips", round_trip);
+
+        char frame[ouch::MAX_FRAME];
+        const size_t n = ouch::encode(frame, sample(ouch::Type::EnterOrder));
+        failures += check("enter order layout", n == 35 && frame[0] == 0 && frame[1] == 33 && frame[2] == 'O' &&
+                                                std::string(frame + 3, ouch::TOKEN_SIZE) == "12345678901234" &&
+                                                frame[21] == 'S');
+
+        ouch::Message m;
+        failures += check("partial frame waits", ouch::decode(frame, n - 1, m) == 0 && ouch::decode(frame, 1, m) == 0);
+
+        size_t off = 0, count = 0;
+        for (size_t used; (used = ouch::decode(&stream[off], stream.size() - off, m)) != 0; off += used) ++count;
+        failures += check("back-to-back frames", count == 6 && off == stream.size());
+
+        const char unknown[] = { 0, 3, 'Z', 1, 2 };
+        failures += check("unknown type is skipped", ouch::decode(unknown, sizeof(unknown), m) == 5 &&
+                                                     m.type == ouch::Type::Unknown);
+    }
+
+    // ----- SPSC ring -----
+    std::cout << "=== RING ===\n";
+    {
+        SpscRing<int> ring(5);
+        failures += check("capacity rounds up", ring.capacity() == 8);
+        bool fifo = true;
+        int next_in = 0, next_out = 0;
+        for (int round = 0; round < 5; ++round) {          // wraps the indices several times
+            while (ring.try_push(next_in)) ++next_in;
+            int v;
+            for (int k = 0; k < 5 && ring.try_pop(v); ++k) fifo = fifo && v == next_out++;
+        }
+        int v;
+        while (ring.try_pop(v)) fifo = fifo && v == next_out++;
+        failures += check("fifo across wrap-around", fifo && next_in == next_out && ring.size() == 0);
+
+        SpscRing<uint64_t> big(1024);
+        const uint64_t N = 1000000;
+        bool ordered = true;
+        const auto t0 = std::chrono::steady_clock::now();
+        std::thread consumer([&] {
+            uint64_t expect = 0, x;
+            while (expect < N) {
+                if (big.try_pop(x)) { ordered = ordered && x == expect; ++expect; }
+                else std::this_thread::yield();
+            }
+        });
+        for (uint64_t i = 0; i < N; ) {
+            if (big.try_push(i)) ++i;
+            else std::this_thread::yield();
+        }
+        consumer.join();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "two-thread items=" << N << " ns_per_item=" << ms * 1e6 / N << "\n";
+        failures += check("two threads keep order", ordered);
+    }
+
+    // ----- gateway against the stub exchange -----
+    std::cout << "=== LOOPBACK ===\n";
+    {
+        StubExchange exchange;
+        OrderGateway gw("127.0.0.1", exchange.local_port());
+        failures += check("session up", exchange.ok() && gw.ok());
+
+        const size_t N = 1000;
+        Quantity entered = 0;
+        for (size_t i = 0; i < N; ++i) {
+            const Quantity q = 100 + i % 7;
+            if (gw.enter(static_cast<uint32_t>(i % 3), 73616, (i & 1) ? Side::Sell : Side::Buy,
+                         9980 + static_cast<Price>(i % 5) * 10, q) != 0) entered += q;
+        }
+        const std::vector<ExecutionReport> reports = collect(gw, 2 * N);   // Accepted + Executed each
+        Quantity executed = 0;
+        bool resolved = true;
+        for (const ExecutionReport& r : reports) {
+            if (r.type != ouch::Type::Executed) continue;
+            executed += r.quantity;
+            resolved = resolved && r.owner == (r.token - 1) % 3 && r.side == (((r.token - 1) & 1) ? Side::Sell : Side::Buy) &&
+                       r.price == 9980 + static_cast<Price>((r.token - 1) % 5) * 10 && r.received_ns >= r.tick_ns;
+        }
+        std::cout << "orders=" << gw.sent() << " accepted=" << gw.accepted() << " executed=" << gw.executed()
+                  << " ring_full=" << gw.ring_full() << " open=" << gw.open_orders() << "\n";
+        failures += check("every order acked and filled",
+                          gw.sent() == N && gw.accepted() == N && gw.executed() == N && gw.open_orders() == 0);
+        failures += check("reports carry the order's owner, side and price", resolved);
+        failures += check("total quantity filled", executed > 0 && executed == entered);
+
+        const uint64_t bad = gw.enter(1, 73616, Side::Buy, 0, 100);
+        const std::vector<ExecutionReport> rej = collect(gw, 1);
+        failures += check("zero price rejected", rej.size() == 1 && rej[0].type == ouch::Type::Rejected &&
+                                                 rej[0].token == bad && rej[0].quantity == 100);
+        failures += check("closed order cannot be canceled", !gw.cancel(bad) && !gw.cancel(1) && !gw.cancel(999999));
+
+        // round trip one order at a time
+        const size_t RT = 2000;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < RT; ++i) {
+            gw.enter(0, 73616, Side::Buy, 9980, 1);
+            collect(gw, 2);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        gw.stop();
+        const LatencySummary wire = gw.tick_to_wire(), ack = gw.tick_to_ack();
+        std::cout << "round_trips=" << RT << " us_per_round_trip=" << ms * 1e3 / RT
+                  << " tick_to_wire_ns p50=" << wire.p50 << " p99=" << wire.p99
+                  << " tick_to_ack_ns p50=" << ack.p50 << " p99=" << ack.p99 << "\n";
+        failures += check("latency sampled per order", wire.count == N + 1 + RT && ack.count == N + 1 + RT &&
+                                                       wire.p50 <= wire.p99 && ack.p99 <= ack.max);
+        failures += check("stopped gateway refuses orders", !gw.ok() && gw.enter(0, 73616, Side::Buy, 9980, 1) == 0);
+    }
+    {
+        StubExchange resting_exchange(/*fill=*/false);
+        OrderGateway gw("127.0.0.1", resting_exchange.local_port());
+        const uint64_t token = gw.enter(5, 73616, Side::Sell, 9990, 300);
+        const std::vector<ExecutionReport> acked = collect(gw, 1);
+        const bool queued = gw.cancel(token);
+        const std::vector<ExecutionReport> gone = collect(gw, 1);
+        failures += check("resting order acked, then canceled",
+                          acked.size() == 1 && acked[0].type == ouch::Type::Accepted && queued &&
+                          gone.size() == 1 && gone[0].type == ouch::Type::Canceled && gone[0].quantity == 300 &&
+                          gone[0].side == Side::Sell && gw.open_orders() == 0);
+    }
+    {
+        OrderGateway nobody("127.0.0.1", 1);
+        failures += check("connect failure reported", !nobody.ok() && nobody.enter(0, 1, Side::Buy, 1, 1) == 0);
+    }
+
+    // ----- strategy on the capture through the gateway -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    const OrderbookId TARGET_BOOK = 73616;
+    const OrderbookFilter subscribed{TARGET_BOOK};
+    StubExchange exchange;
+    OrderGateway gw("127.0.0.1", exchange.local_port());
+    Strategy strat(TARGET_BOOK, 100, 1000, 0);
+    strat.set_trade_log(nullptr);
+    strat.set_gateway(&gw, 3);
+    {
+        std::ifstream file(FILE_PATH, std::ios::binary);
+        ItchParser parser(file);
+        parser.set_filter(&subscribed);
+        Orderbook book;
+        NullObserver obs;
+        replay_day_top_driven(parser, TARGET_BOOK, book, strat, obs);
+    }
+    gw.stop();
+    const LatencySummary ack = gw.tick_to_ack();
+    std::cout << "orders=" << gw.sent() << " executed=" << gw.executed() << " fills=" << strat.fills()
+              << " pos=" << strat.position() << " pnl=" << strat.realized_pnl()
+              << " tick_to_ack_ns p50=" << ack.p50 << " p99=" << ack.p99 << "\n";
+    failures += check("strategy traded through the gateway", gw.sent() > 0 && strat.fills() > 0);
+    failures += check("every execution booked before the close", gw.executed() == strat.fills() && gw.open_orders() == 0);
+    failures += check("positions reconcile",
+                      static_cast<Position>(strat.bought()) - static_cast<Position>(strat.sold()) == strat.position() &&
+                      strat.pending_buy() == 0 && strat.pending_sell() == 0);
+
+    std::cout << (failures == 0 ? "[GATEWAY] ALL PASS" : "[GATEWAY] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// test_latency.cpp
+#include "latency_model.h"
+#include "itch_parser.h"
+#include "orderbook.h"
+#include "orderbook_filter.h"
+#include "replay.h"
+#include "replay_observers.h"
+#include "strategy.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+static const OrderbookId BOOK = 123;
+
+// --- helpers to create events ---
+static Event make_state(const char* state, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::OrderbookState;
+    e.orderbook_id = BOOK;
+    e.orderbook_state = state;
+    e.nanosec = static_cast<Nanoseconds>(ns);
+    e.timestamp = ns;
+    return e;
+}
+static Event make_add(OrderId id, Side s, Price px, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = ns;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    e.nanosec = static_cast<Nanoseconds>(ns);
+    e.timestamp = ns;
+    return e;
+}
+static Event make_exec(OrderId id, Side s, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::ExecuteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.quantity = qty;
+    e.nanosec = static_cast<Nanoseconds>(ns);
+    e.timestamp = ns;
+    return e;
+}
+
+// histogram from (upper_ns, count) pairs
+static std::vector<LatencyBucket> hist(std::initializer_list<std::pair<Timestamp, uint64_t>> pairs) {
+    std::vector<LatencyBucket> out;
+    for (const auto& p : pairs) {
+        LatencyBucket b;
+        b.upper_ns = p.first;
+        b.count = p.second;
+        out.push_back(b);
+    }
+    return out;
+}
+
+// scripted packet source for the replay loop: one event per packet
+struct VectorSource {
+    std::vector<Event> events;
+    size_t next = 0;
+
+    bool good() const { return next < events.size(); }
+    std::vector<Event> next_packet() { return std::vector<Event>(1, events[next++]); }
+};
+
+// tight 100/110, then the ask vanishes at ns=3 -> BUY 100 @ 110 sent at ns=3
+static std::vector<Event> gap_script(const Event& after_signal) {
+    std::vector<Event> s;
+    s.push_back(make_state("P_SUREKLI_ISLEM", 1));
+    s.push_back(make_add(1, Side::Buy, 100, 1000, 2));
+    s.push_back(make_add(2, Side::Sell, 110, 1000, 2));
+    s.push_back(make_add(3, Side::Sell, 120, 1000, 2));
+    s.push_back(make_exec(2, Side::Sell, 1000, 3));
+    s.push_back(after_signal);
+    s.push_back(make_add(9, Side::Sell, 130, 1000, 12));
+    s.push_back(make_state("P_MARJ_YAYIN_KAPANIS", 20));
+    return s;
+}
+
+struct ScriptResult {
+    Position position;
+    size_t   missed;
+    LatencyStats stats;
+};
+
+static ScriptResult run_script(const Event& after_signal, LatencyModel model) {
+    VectorSource source;
+    source.events = gap_script(after_signal);
+    Orderbook book;
+    Strategy strat(BOOK, /*order_qty=*/100, /*max_pos=*/500, /*min_pos=*/0);
+    strat.set_trade_log(nullptr);
+    LatencyQueue latency(model);
+    strat.set_latency(&latency);
+    NullObserver obs;
+    replay_day_top_driven(source, BOOK, book, strat, obs, nullptr, &latency);
+    return ScriptResult{ strat.position(), strat.missed(), latency.stats() };
+}
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- models -----
+    std::cout << "=== MODELS ===\n";
+    {
+        LatencyModel f = LatencyModel::fixed(250);
+        failures += check("fixed", f.sample() == 250 && f.sample() == 250);
+
+        LatencyModel a = LatencyModel::normal(1000, 200, 7), b = LatencyModel::normal(1000, 200, 7);
+        bool same = true;
+        double sum = 0;
+        const int N = 100000;
+        for (int i = 0; i < N; ++i) {
+            const Timestamp x = a.sample();
+            same = same && x == b.sample();
+            sum += static_cast<double>(x);
+        }
+        std::cout << "normal mean=" << sum / N << "\n";
+        failures += check("normal is reproducible per seed", same);
+        failures += check("normal mean near 1000", sum / N > 990 && sum / N < 1010);
+
+        LatencyModel z = LatencyModel::normal(10, 1000);
+        bool non_negative = true;
+        for (int i = 0; i < 1000; ++i) non_negative = non_negative && z.sample() < 100000;
+        failures += check("normal truncated at zero", non_negative);
+
+        // 1 : 0 : 3 over (0,100], (100,200], (200,400]
+        LatencyModel h = LatencyModel::histogram(hist({ {100, 1}, {200, 0}, {400, 3} }));
+        size_t low = 0, high = 0, outside = 0;
+        for (int i = 0; i < N; ++i) {
+            const Timestamp x = h.sample();
+            if (x >= 1 && x <= 100) ++low;
+            else if (x > 200 && x <= 400) ++high;
+            else ++outside;
+        }
+        std::cout << "histogram low=" << low << " high=" << high << " outside=" << outside << "\n";
+        failures += check("histogram respects buckets and weights",
+                          outside == 0 && low > N / 4 - 1000 && low < N / 4 + 1000);
+
+        const char* path = "/tmp/test_latency_hist.txt";
+        {
+            std::ofstream out(path);
+            out << "# upper_ns count\n50 10\n\n150 30  # tail\n";
+        }
+        std::vector<LatencyBucket> buckets;
+        const bool loaded = LatencyModel::load_histogram(path, buckets);
+        std::remove(path);
+        failures += check("histogram file", loaded && buckets.size() == 2 &&
+                          buckets[1].upper_ns == 150 && buckets[1].count == 30);
+        failures += check("missing histogram file", !LatencyModel::load_histogram("/nonexistent/hist", buckets));
+    }
+
+    // ----- event-time queue -----
+    std::cout << "=== QUEUE ===\n";
+    {
+        LatencyQueue q(LatencyModel::fixed(0));
+        q.send(0, Side::Buy, 1, 1, 30);
+        q.send(1, Side::Buy, 2, 1, 10);
+        q.send(2, Side::Buy, 3, 1, 20);
+        q.send(3, Side::Buy, 4, 1, 10);
+        std::vector<uint32_t> order;
+        q.release(20, [&](const DelayedOrder& o) { order.push_back(o.owner); });
+        failures += check("released by arrival, ties in send order",
+                          order == std::vector<uint32_t>({1, 3, 2}) && q.in_flight() == 1);
+        q.clear();
+        failures += check("clear drops orders in flight", q.in_flight() == 0 && q.stats().dropped == 1);
+    }
+
+    // ----- orders meet the book at arrival -----
+    std::cout << "=== ARRIVAL ===\n";
+    {
+        const Event quiet = make_add(4, Side::Buy, 90, 1000, 5);       // deep bid, gap stays open
+        const Event closes = make_add(4, Side::Buy, 110, 1000, 5);     // someone else takes the gap
+        const Event at_ten = make_add(4, Side::Buy, 110, 1000, 10);
+
+        ScriptResult r = run_script(quiet, LatencyModel::fixed(5));
+        failures += check("gap still open at arrival: filled", r.position == 100 && r.missed == 0);
+
+        r = run_script(closes, LatencyModel::fixed(5));
+        failures += check("gap closed before arrival: missed", r.position == 0 && r.missed == 1);
+
+        r = run_script(closes, LatencyModel::fixed(0));
+        failures += check("zero latency beats the next batch", r.position == 100 && r.missed == 0);
+
+        r = run_script(at_ten, LatencyModel::fixed(7));
+        failures += check("arrival equal to a batch goes first", r.position == 100 && r.missed == 0);
+
+        r = run_script(quiet, LatencyModel::fixed(50));
+        failures += check("in flight at the close: dropped", r.position == 0 && r.stats.dropped == 1);
+    }
+
+    // ----- full day -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    const OrderbookId TARGET_BOOK = 73616;
+    const OrderbookFilter subscribed{TARGET_BOOK};
+    auto run_day = [&](LatencyQueue* latency, Strategy& strat) {
+        std::ifstream file(FILE_PATH, std::ios::binary);
+        ItchParser parser(file);
+        parser.set_filter(&subscribed);
+        Orderbook book;
+        strat.set_trade_log(nullptr);
+        strat.set_latency(latency);
+        NullObserver obs;
+        const auto t0 = std::chrono::steady_clock::now();
+        replay_day_top_driven(parser, TARGET_BOOK, book, strat, obs, nullptr, latency);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    Strategy instant(TARGET_BOOK, 100, 1000, 0);
+    const double instant_ms = run_day(nullptr, instant);
+
+    LatencyQueue zero;
+    Strategy delayed0(TARGET_BOOK, 100, 1000, 0);
+    run_day(&zero, delayed0);
+    std::cout << "instant pnl=" << instant.realized_pnl() << " zero_latency pnl=" << delayed0.realized_pnl() << "\n";
+    failures += check("zero latency reproduces instant fills",
+                      delayed0.realized_pnl() == instant.realized_pnl() &&
+                      delayed0.position() == instant.position() && delayed0.fills() == instant.fills());
+
+    LatencyQueue jitter(LatencyModel::histogram(hist({ {500, 60}, {2000, 30}, {10000, 10} })));
+    Strategy delayed(TARGET_BOOK, 100, 1000, 0);
+    const double jitter_ms = run_day(&jitter, delayed);
+    const LatencyStats& ls = jitter.stats();
+    std::cout << "histogram sent=" << ls.sent << " arrived=" << ls.arrived << " dropped=" << ls.dropped
+              << " missed=" << delayed.missed() << " pos=" << delayed.position() << " pnl=" << delayed.realized_pnl()
+              << " mean_ns=" << (ls.sent ? ls.total_latency / ls.sent : 0) << "\n";
+    std::cout << "instant_ms=" << instant_ms << " latency_ms=" << jitter_ms << "\n";
+    failures += check("every order arrives, is dropped or is still accounted",
+                      ls.sent == ls.arrived + ls.dropped && delayed.fills() + delayed.missed() == ls.arrived);
+
+    // queue throughput: a day's worth of orders many times over
+    LatencyQueue bulk(LatencyModel::normal(5000, 2000));
+    const size_t ORDERS = 1000000;
+    size_t released = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ORDERS; ++i) {
+        bulk.send(0, Side::Buy, 100, 1, i * 10);
+        bulk.release(i * 10, [&](const DelayedOrder&) { ++released; });
+    }
+    const double bulk_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "queue orders=" << ORDERS << " released=" << released << " in_flight=" << bulk.in_flight()
+              << " ns_per_order=" << bulk_ms * 1e6 / ORDERS << "\n";
+
+    std::cout << (failures == 0 ? "[LATENCY] ALL PASS" : "[LATENCY] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+// test_memory.cpp
+#include "orderbook.h"
+#include "itch_parser.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const OrderbookId BOOK = 123;
+
+static Event make_add(OrderId id, Side s, Price px, Quantity qty, RankingTime rt) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = rt;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    e.timestamp = rt;
+    return e;
+}
+static Event make_exec(OrderId id, Side s, Quantity qty) {
+    Event e{};
+    e.type = MessageType::ExecuteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.quantity = qty;
+    return e;
+}
+static Event make_del(OrderId id, Side s) {
+    Event e{};
+    e.type = MessageType::DeleteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    return e;
+}
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+// kB of this process's memory currently backed by transparent huge pages
+static long anon_huge_kb() {
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string key;
+    long kb = 0;
+    while (in >> key) {
+        if (key == "AnonHugePages:") { in >> kb; return kb; }
+        in.ignore(1 << 10, '\n');
+    }
+    return -1;
+}
+
+struct BenchResult {
+    double ns_per_op = 0;
+    uint64_t total_bytes = 0;
+    uint64_t orders = 0;
+};
+
+// random adds/executions/deletes over a deep book: pointer chasing across
+// list, tree and hash nodes, dominated by cache and TLB misses
+static BenchResult bench(NodeArena* arena) {
+    const size_t RESTING = 200000;
+    const size_t OPS = 400000;
+    Orderbook ob(arena);
+    std::mt19937 rng(31);
+    struct Live { OrderId id; Side side; Quantity qty; };
+    std::vector<Live> live;
+    live.reserve(RESTING);
+    OrderId next = 1;
+    RankingTime t = 1;
+    auto add = [&]() {
+        const Side s = (rng() & 1) ? Side::Buy : Side::Sell;
+        const Price px = s == Side::Buy ? 100000 - (rng() % 2000) * 10 : 100010 + (rng() % 2000) * 10;
+        const Quantity q = 1 + rng() % 1000;
+        ob.apply(make_add(next, s, px, q, t++));
+        live.push_back(Live{ next++, s, q });
+    };
+    while (live.size() < RESTING) add();
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < OPS; ++i) {
+        const size_t k = rng() % live.size();
+        Live& o = live[k];
+        if (rng() & 1) {
+            ob.apply(make_del(o.id, o.side));
+            live[k] = live.back();
+            live.pop_back();
+            add();
+        } else if (o.qty > 1) {
+            ob.apply(make_exec(o.id, o.side, 1));
+            o.qty -= 1;
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    BenchResult r;
+    r.ns_per_op = std::chrono::duration<double, std::nano>(t1 - t0).count() / OPS;
+    r.total_bytes = ob.memory().total.bytes;
+    r.orders = ob.order_count();
+    return r;
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- scripted accounting -----
+    std::cout << "=== ACCOUNTING ===\n";
+    {
+        Orderbook ob;
+        const BookMemory empty = ob.memory();
+        for (OrderId i = 1; i <= 1000; ++i) {
+            const Side s = (i % 2) ? Side::Buy : Side::Sell;
+            const Price px = s == Side::Buy ? 1000 - static_cast<Price>(i % 10) * 10 : 1010 + static_cast<Price>(i % 10) * 10;
+            ob.apply(make_add(i, s, px, 100, i));
+        }
+        const BookMemory full = ob.memory();
+        std::cout << "orders=" << full.orders.bytes << " levels=" << full.levels.bytes
+                  << " index=" << full.index.bytes << " total=" << full.total.bytes << "\n";
+        failures += check("one node per order, level and id", full.orders.nodes == 1000 && full.levels.nodes == 10 &&
+                                                              full.index.nodes == 1000 && empty.total.bytes == 0);
+        failures += check("total is the sum of the structures",
+                          full.total.bytes == full.orders.bytes + full.levels.bytes + full.index.bytes + full.queues.bytes);
+
+        QueuePosition p;
+        ob.queue_position(500, p);
+        failures += check("queue index charged on first query", ob.memory().queues.bytes > 0);
+
+        for (OrderId i = 1; i <= 1000; ++i) ob.apply(make_del(i, (i % 2) ? Side::Buy : Side::Sell));
+        const BookMemory drained = ob.memory();
+        failures += check("nodes returned when the book empties",
+                          drained.orders.bytes == 0 && drained.levels.bytes == 0 && drained.queues.bytes == 0 &&
+                          drained.index.nodes == 0 && drained.orders.nodes == 0);
+        failures += check("peak survives the drain", drained.total.peak_bytes >= full.total.bytes &&
+                                                     drained.orders.peak_bytes == full.orders.bytes);
+    }
+
+    // ----- arena: size classes, reuse, large blocks -----
+    std::cout << "=== ARENA ===\n";
+    {
+        NodeArena arena(HugePages::Off);
+        void* a = arena.allocate(40);
+        void* b = arena.allocate(40);
+        failures += check("one chunk mapped on first use", arena.stats().chunks == 1 &&
+                                                           arena.stats().reserved_bytes == NodeArena::HUGE_PAGE_BYTES);
+        failures += check("nodes rounded to 16 bytes", arena.stats().used_bytes == 96 &&
+                                                       static_cast<char*>(b) - static_cast<char*>(a) == 48);
+        arena.deallocate(a, 40);
+        failures += check("freed node reused by its size class", arena.allocate(33) == a && arena.allocate(40) != a);
+        void* big = arena.allocate(4096);
+        failures += check("large blocks go to the heap", arena.stats().large_bytes == 4096);
+        arena.deallocate(big, 4096);
+        for (int i = 0; i < 50000; ++i) arena.allocate(64);
+        failures += check("chunks added as needed", arena.stats().chunks == 2 && arena.stats().large_bytes == 0);
+
+        NodeArena explicit_pages(HugePages::Explicit);
+        explicit_pages.allocate(64);
+        std::cout << "explicit huge pages -> " << to_string(explicit_pages.mode()) << "\n";
+        failures += check("explicit huge pages map or fall back", explicit_pages.stats().chunks == 1);
+    }
+
+    // ----- capture: every book of the day, heap vs. arena -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    {
+        NodeArena arena(HugePages::Transparent);
+        std::unordered_map<OrderbookId, std::unique_ptr<Orderbook>> heap_books, arena_books;
+        std::ifstream file(FILE_PATH, std::ios::binary);
+        ItchParser parser(file);
+        size_t events = 0;
+        while (parser.good()) {
+            for (const Event& ev : parser.next_packet()) {
+                if (ev.orderbook_id == 0) continue;
+                std::unique_ptr<Orderbook>& h = heap_books[ev.orderbook_id];
+                std::unique_ptr<Orderbook>& a = arena_books[ev.orderbook_id];
+                if (!h) h.reset(new Orderbook());
+                if (!a) a.reset(new Orderbook(&arena));
+                h->apply(ev);
+                a->apply(ev);
+                ++events;
+            }
+        }
+        uint64_t heap_bytes = 0, arena_bytes = 0, peaks = 0, orders = 0;
+        for (const auto& kv : heap_books) {
+            heap_bytes += kv.second->memory().total.bytes;
+            peaks += kv.second->memory().total.peak_bytes;
+            orders += kv.second->order_count();
+        }
+        for (const auto& kv : arena_books) arena_bytes += kv.second->memory().total.bytes;
+        std::cout << "events=" << events << " books=" << heap_books.size() << " orders=" << orders
+                  << " bytes=" << heap_bytes << " sum_of_peaks=" << peaks
+                  << " bytes_per_order=" << (orders ? heap_bytes / orders : 0)
+                  << " arena_reserved=" << arena.stats().reserved_bytes
+                  << " arena_peak_used=" << arena.stats().peak_used_bytes << "\n";
+        failures += check("accounting independent of the backing", events > 0 && heap_bytes == arena_bytes);
+    }
+
+    // ----- benchmark: heap vs. 4 KB arena vs. huge-page arena -----
+    std::cout << "=== BENCHMARK ===\n";
+    {
+        const BenchResult heap = bench(nullptr);
+        std::cout << "heap:        ns_per_op=" << heap.ns_per_op << " bytes=" << heap.total_bytes << "\n";
+        BenchResult small, huge;
+        {
+            NodeArena arena(HugePages::Off);
+            small = bench(&arena);
+            std::cout << "arena 4K:    ns_per_op=" << small.ns_per_op
+                      << " reserved=" << arena.stats().reserved_bytes << "\n";
+        }
+        {
+            NodeArena arena(HugePages::Transparent);
+            huge = bench(&arena);
+            std::cout << "arena 2M:    ns_per_op=" << huge.ns_per_op
+                      << " reserved=" << arena.stats().reserved_bytes
+                      << " AnonHugePages_kB=" << anon_huge_kb() << "\n";
+        }
+        failures += check("same book whatever the backing", heap.orders == small.orders && heap.orders == huge.orders &&
+                                                            heap.total_bytes == small.total_bytes &&
+                                                            heap.total_bytes == huge.total_bytes);
+    }
+
+    std::cout << (failures == 0 ? "[MEMORY] ALL PASS" : "[MEMORY] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+// test_mold_sequencer.cpp
+#include "itch_parser.h"
+#include "moldudp64.h"
+#include "mold_retransmit.h"
+#include "mold_sequencer.h"
+#include "udp_feed.h"
+#include "udp_receiver.h"
+#include "udp_sender.h"
+#include "util/tape_writer.h"
+#include "types/event.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+using Packet = std::vector<char>;
+
+// ----- synthetic session: many small packets -----
+static TapeWriter make_tape(size_t n) {
+    TapeWriter w("SEQSESS001", 1, 300);
+    const OrderbookId BOOK = 73616;
+    Nanoseconds ns = 1000;
+    std::srand(11);
+
+    w.state(ns, BOOK, "P_SUREKLI_ISLEM");
+    for (size_t i = 1; i <= n; ++i) {
+        ns += std::rand() % 3;
+        const Side side = (i % 2) ? Side::Buy : Side::Sell;
+        w.add(ns, i, BOOK, side, static_cast<RankingSeqNum>(i), 100 + i,
+              side == Side::Buy ? 9990 : 10000, 5000 + i);
+        if (i % 5 == 0) w.execute(ns, i, BOOK, side, 10, i);
+        if (i % 9 == 0) w.flush();
+    }
+    w.state(ns + 1, BOOK, "P_MARJ_YAYIN_KAPANIS");
+    w.end_session();
+    return w;
+}
+
+// packets a and b (consecutive) as one packet starting at a's sequence
+static Packet merge(const Packet& a, const Packet& b) {
+    mold::PacketHeader ha, hb;
+    mold::read_header(a.data(), a.size(), ha);
+    mold::read_header(b.data(), b.size(), hb);
+    Packet out(a);
+    out.insert(out.end(), b.begin() + mold::HEADER_SIZE, b.end());
+    ha.count = static_cast<uint16_t>(ha.count + hb.count);
+    mold::write_header(&out[0], ha);
+    return out;
+}
+
+static std::vector<Event> decode_all(const std::vector<Packet>& packets) {
+    ItchParser decoder;
+    std::vector<Event> events;
+    for (const Packet& p : packets) decoder.parse_packet(p.data(), p.size(), events);
+    return events;
+}
+
+static size_t count_diff(const std::vector<Event>& a, const std::vector<Event>& b) {
+    size_t diff = a.size() > b.size() ? a.size() - b.size() : b.size() - a.size();
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].order_id != b[i].order_id ||
+            a[i].nanosec != b[i].nanosec || a[i].quantity != b[i].quantity) ++diff;
+    }
+    return diff;
+}
+
+static void print_stats(const char* label, const SequencerStats& s) {
+    std::cout << label << " packets=" << s.packets << " delivered=" << s.delivered
+              << " dup=" << s.duplicates << " overlap=" << s.overlaps
+              << " gaps=" << s.gaps << " buffered=" << s.buffered
+              << " lost=" << s.lost << "\n";
+}
+
+int main() {
+    int failures = 0;
+    TapeWriter tape = make_tape(400);
+    const std::vector<Packet>& packets = tape.packets();
+    const std::vector<Event> expected = decode_all(packets);
+    std::cout << "packets=" << packets.size() << " events=" << expected.size() << "\n";
+
+    // ----- reordered, duplicated and overlapping delivery -----
+    std::cout << "=== REORDER / DUPLICATE / OVERLAP ===\n";
+    {
+        std::vector<Packet> arrivals;
+        for (size_t i = 0; i < packets.size(); ++i) {
+            if (i % 10 == 3 && i + 1 < packets.size()) {
+                arrivals.push_back(packets[i + 1]);      // swapped pair
+                arrivals.push_back(packets[i]);
+                arrivals.push_back(packets[i]);          // late duplicate
+                ++i;
+            } else if (i % 10 == 7 && i + 1 < packets.size()) {
+                arrivals.push_back(packets[i]);
+                arrivals.push_back(merge(packets[i], packets[i + 1]));   // overlaps i
+                ++i;
+            } else {
+                arrivals.push_back(packets[i]);
+            }
+        }
+
+        MoldSequencer seq(1);
+        std::vector<Packet> released;
+        for (const Packet& p : arrivals) {
+            seq.offer(p.data(), p.size());
+            for (const auto& v : seq.ready()) released.push_back(Packet(v.data, v.data + v.len));
+        }
+        const std::vector<Event> got = decode_all(released);
+        print_stats("[SEQ]", seq.stats());
+        const size_t diff = count_diff(expected, got);
+        std::cout << "events=" << got.size() << " diff=" << diff
+                  << " ended=" << (seq.ended() ? "yes" : "no") << "\n";
+        if (diff != 0 || !seq.ended() || seq.stats().overlaps == 0 || seq.stats().duplicates == 0) ++failures;
+    }
+
+    // ----- gap announced only by a heartbeat, then skipped -----
+    std::cout << "=== HEARTBEAT GAP / SKIP ===\n";
+    {
+        MoldSequencer seq(1);
+        for (size_t i = 0; i + 2 < packets.size(); ++i) seq.offer(packets[i].data(), packets[i].size());
+        mold::PacketHeader last;
+        mold::read_header(packets[packets.size() - 2].data(), packets[packets.size() - 2].size(), last);
+
+        TapeWriter hb("SEQSESS001", last.next_seq());
+        const Packet heartbeat = hb.control_packet(mold::HEARTBEAT);
+        seq.offer(heartbeat.data(), heartbeat.size());
+        std::cout << "in_gap=" << (seq.in_gap() ? "yes" : "no")
+                  << " missing=" << seq.missing_count() << " expected_missing=" << last.count << "\n";
+        if (!seq.in_gap() || seq.missing_count() != last.count) ++failures;
+
+        const uint64_t skipped = seq.skip_gap();
+        std::cout << "skipped=" << skipped << " in_gap=" << (seq.in_gap() ? "yes" : "no") << "\n";
+        if (skipped != last.count || seq.in_gap()) ++failures;
+    }
+
+    // ----- loopback with drops, recovered from a stand-in request server -----
+    std::cout << "=== LOOPBACK RECOVERY ===\n";
+    {
+        std::stringstream capture;
+        tape.write(capture);
+        MoldRequestServer server(capture);
+        if (!server.ok()) return 1;
+
+        std::atomic<bool> stop(false);
+        std::thread server_thread([&]() { while (!stop.load()) server.serve(10); });
+
+        UdpReceiverConfig cfg;
+        cfg.bind_addr = "127.0.0.1";
+        cfg.rcvbuf_bytes = 0;
+        cfg.timeout_ms = 20;
+        UdpReceiver rx(cfg);
+        UdpSender tx("127.0.0.1", rx.local_port());
+        MoldRequestClient client("127.0.0.1", server.local_port());
+        if (!rx.ok() || !tx.ok() || !client.ok()) return 1;
+
+        ItchParser decoder;
+        UdpFeed feed(rx, decoder);
+        feed.set_recovery(&client);
+
+        std::vector<Event> got;
+        size_t sent = 0, dropped = 0;
+        auto last_progress = std::chrono::steady_clock::now();
+        while (feed.good() && std::chrono::steady_clock::now() - last_progress < std::chrono::seconds(2)) {
+            while (sent < packets.size() && sent < feed.packets() + dropped + 16) {
+                // lost on the wire (the end-of-session packet is repeated by
+                // real servers, so it is always delivered here)
+                if (sent % 10 == 4 && sent + 1 < packets.size()) ++dropped;
+                else tx.send(packets[sent].data(), packets[sent].size());
+                ++sent;
+            }
+            auto events = feed.next_packet();
+            if (!events.empty()) last_progress = std::chrono::steady_clock::now();
+            got.insert(got.end(), events.begin(), events.end());
+        }
+        stop = true;
+        server_thread.join();
+
+        const size_t diff = count_diff(expected, got);
+        std::cout << "dropped=" << dropped << " events=" << got.size() << " diff=" << diff
+                  << " lost=" << feed.sequencer().stats().lost
+                  << " recovered=" << (client.responses() > 0 ? "yes" : "no")
+                  << " end_of_session=" << (feed.good() ? "no" : "yes") << "\n";
+        if (diff != 0 || feed.good() || client.requests() == 0) ++failures;
+    }
+
+    std::cout << "[MOLD SEQUENCER] " << (failures == 0 ? "ALL PASS" : "FAILURES") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 // test_orderbook.cpp
 #include "orderbook.h"
+#include "depth_view.h"
 #include "types/event.h"
 #include <iostream>
 #include <vector>
@@ -39,6 +40,7 @@ static Event make_state(OrderbookId book, const char* state, uint64_t ns) {
     e.orderbook_id = book;
     e.orderbook_state = state;
     e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 static Event make_add(OrderbookId book, OrderId id, Side s, Price px, Quantity qty,
@@ -53,6 +55,7 @@ static Event make_add(OrderbookId book, OrderId id, Side s, Price px, Quantity q
     e.ranking_time = rt;
     e.ranking_seq_num = rsn;
     e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 static Event make_exec(OrderbookId book, OrderId id, Side s, Quantity qty, uint64_t ns) {
@@ -63,6 +66,21 @@ static Event make_exec(OrderbookId book, OrderId id, Side s, Quantity qty, uint6
     e.side = s;
     e.quantity = qty;
     e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_replace(OrderbookId book, OrderId id, Side s, Price px, Quantity qty,
+                          RankingSeqNum rsn, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::ReplaceOrder;
+    e.orderbook_id = book;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_seq_num = rsn;
+    e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 static Event make_del(OrderbookId book, OrderId id, Side s, uint64_t ns) {
@@ -72,6 +90,7 @@ static Event make_del(OrderbookId book, OrderId id, Side s, uint64_t ns) {
     e.order_id = id;
     e.side = s;
     e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 
@@ -79,11 +98,22 @@ int main() {
     const OrderbookId BOOK = 123;
     Orderbook ob;
 
+    // collect best bid/ask change records while the book is built
+    std::vector<TopOfBookChanged> top_changes;
+    ob.set_top_sink(&top_changes);
+
+    // mirror the depth incrementally from level deltas
+    std::vector<LevelDelta> deltas;
+    DepthView view;
+    ob.set_depth_sink(&deltas);
+
     uint64_t ns = 1;
     size_t applied = 0;
 
     auto apply_and_maybe_snapshot = [&](const Event& ev) {
         ob.apply(ev);
+        view.apply(deltas);
+        deltas.clear();
         ++applied;
         if ((applied % 10) == 0) {
             print_topN(ob, 10, ns, BOOK);
@@ -128,11 +158,49 @@ int main() {
     apply_and_maybe_snapshot(make_add(BOOK, 3001, Side::Sell, ob.best_ask_price(), 2500, 99, 1, ns));
     apply_and_maybe_snapshot(make_add(BOOK, 3002, Side::Buy, ob.best_bid_price(), 2500, 99, 2, ns));
 
+    // 8) replace: size-only reduction in place, size increase re-queued,
+    //    price change moves the best bid
+    apply_and_maybe_snapshot(make_replace(BOOK, 3001, Side::Sell, ob.best_ask_price(), 1500, 100, ns));
+    apply_and_maybe_snapshot(make_replace(BOOK, 2001, Side::Sell, 30, 3000, 101, ns));
+    apply_and_maybe_snapshot(make_replace(BOOK, 1009, Side::Buy, 15, 10000, 102, ns));
+    std::cout << "[REPLACE] orders=" << ob.order_count()
+              << " best_bid=" << ob.best_bid_price() << " x " << ob.best_bid_quantity()
+              << " best_ask=" << ob.best_ask_price() << " x " << ob.best_ask_quantity() << "\n";
+
+    // 9) auction equilibrium is recorded without touching the book
+    Event eq{};
+    eq.type = MessageType::EquilibriumPrice;
+    eq.orderbook_id = BOOK;
+    eq.price = 55;
+    eq.quantity = 4000;
+    eq.ask_quantity = 3500;
+    apply_and_maybe_snapshot(eq);
+    std::cout << "[EQUILIBRIUM] price=" << ob.equilibrium_price()
+              << " qty=" << ob.equilibrium_quantity() << "\n";
+
     // final snapshot if needed
     if ((applied % 10) != 0) {
         print_topN(ob, 10, ns, BOOK);
     }
 
+    // top-of-book change records (only emitted when the best price moved)
+    std::cout << "\n=== TOP-OF-BOOK CHANGES (" << top_changes.size() << ") ===\n";
+    for (const auto& c : top_changes) {
+        std::cout << "[TOP] ns=" << c.timestamp
+                  << " cause=" << static_cast<char>(c.cause)
+                  << " id=" << c.order_id
+                  << " bid " << c.old_bid << "->" << c.new_bid
+                  << " ask " << c.old_ask << "->" << c.new_ask << "\n";
+    }
+
+    // incremental depth view must equal a fresh snapshot
+    std::vector<std::pair<Price, Quantity>> ob_bids, ob_asks, view_bids, view_asks;
+    ob.snapshot_n(100, ob_bids, ob_asks);
+    view.snapshot_n(100, view_bids, view_asks);
+    const bool depth_match = (ob_bids == view_bids && ob_asks == view_asks);
+    std::cout << "\n[DEPTH VIEW] levels bid=" << view_bids.size() << " ask=" << view_asks.size()
+              << (depth_match ? " MATCH" : " MISMATCH") << "\n";
+
     std::cout << "\n[TEST_ORDERBOOK DONE] total_events=" << applied << "\n";
-    return 0;
+    return depth_match ? 0 : 1;
 }
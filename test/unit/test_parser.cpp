@@ -1,6 +1,10 @@
 // test_parser.cpp
 #include "itch_parser.h"
+#include "orderbook_filter.h"
 #include "types/event.h"
+#include "util/tape_writer.h"
+#include "util/endian.h"
+#include "moldudp64.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -8,6 +12,7 @@
 #include <iomanip>
 #include <sstream>
 #include <map>
+#include <chrono>
 
 // pretty printer for events
 static void print_event(const Event& ev) {
@@ -37,6 +42,9 @@ static void print_event(const Event& ev) {
                       << " book=" << ev.orderbook_id
                       << " side=" << (ev.side == Side::Buy ? "B" : "S"); 
             break;
+        case MessageType::Seconds:
+            std::cout << "SECONDS ts=" << ev.timestamp;
+            break;
         default: 
             std::cout << "OTHER"; 
             break;
@@ -52,6 +60,7 @@ struct ParserStats {
     size_t add_events = 0;
     size_t exec_events = 0;
     size_t del_events = 0;
+    size_t seconds_events = 0;
     size_t other_events = 0;
     size_t target_book_events = 0;
     
@@ -63,6 +72,7 @@ struct ParserStats {
         std::cout << "  - Add events: " << add_events << "\n";
         std::cout << "  - Exec events: " << exec_events << "\n";
         std::cout << "  - Del events: " << del_events << "\n";
+        std::cout << "  - Seconds events: " << seconds_events << "\n";
         std::cout << "  - Other events: " << other_events << "\n";
         std::cout << "Target book events: " << target_book_events << "\n";
         std::cout << "========================\n";
@@ -128,6 +138,7 @@ int main() {
                 case MessageType::AddOrder: ++stats.add_events; break;
                 case MessageType::ExecuteOrder: ++stats.exec_events; break;
                 case MessageType::DeleteOrder: ++stats.del_events; break;
+                case MessageType::Seconds: ++stats.seconds_events; break;
                 default: ++stats.other_events; break;
             }
             
@@ -174,6 +185,177 @@ int main() {
     auto corrupted_events = corrupted_parser.next_packet();
     std::cout << "Corrupted data returned " << corrupted_events.size() << " events (expected 0)\n";
     
+    // Test Seconds ('T') messages: same ns offset in two seconds must differ
+    std::cout << "Testing Seconds message timestamps..." << std::endl;
+    TapeWriter tape("TSECONDS01", 1);
+    tape.seconds(36000);
+    tape.add(999999999, 1, TARGET_BOOK, Side::Buy, 1, 100, 9990, 1);
+    tape.add(500, 2, TARGET_BOOK, Side::Buy, 2, 100, 9990, 2);
+    tape.flush();
+    tape.seconds(36001);
+    tape.add(500, 3, TARGET_BOOK, Side::Buy, 3, 100, 9990, 3);
+    tape.end_session();
+    std::stringstream seconds_stream;
+    tape.write(seconds_stream);
+    ItchParser seconds_parser(seconds_stream);
+    std::vector<Event> timed;
+    while (seconds_parser.good()) {
+        auto events = seconds_parser.next_packet();
+        timed.insert(timed.end(), events.begin(), events.end());
+    }
+    for (const auto& ev : timed) {
+        std::cout << "  type=" << static_cast<char>(ev.type) << " ns=" << ev.nanosec
+                  << " ts=" << ev.timestamp << "\n";
+    }
+    const bool seconds_ok = timed.size() == 5 &&
+        timed[0].type == MessageType::Seconds && timed[1].timestamp == 36000999999999ull &&
+        timed[2].timestamp == 36000000000500ull && timed[4].timestamp == 36001000000500ull &&
+        timed[2].nanosec == timed[4].nanosec;
+    std::cout << "Seconds timestamps " << (seconds_ok ? "OK" : "WRONG") << "\n";
+
+    // Test the remaining message types: every field written must come back
+    std::cout << "Testing full message set..." << std::endl;
+    TapeWriter full("TFULLSET01", 1);
+    full.system_event(1, 'O');
+    full.directory(2, TARGET_BOOK, "THYAO.E", 3, 1);
+    full.tick_size(3, TARGET_BOOK, 10, 0, 19990);
+    full.equilibrium(4, TARGET_BOOK, 1200, 900, 9990, 9980, 10000);
+    full.add(5, 77, TARGET_BOOK, Side::Sell, 1, 500, 10000, 5);
+    full.replace(6, 77, TARGET_BOOK, Side::Sell, 2, 400, 10010);
+    full.execute_price(7, 77, TARGET_BOOK, Side::Sell, 100, 4242, 10010, true);
+    full.trade(8, 4343, TARGET_BOOK, Side::Buy, 300, 10020, false);
+    full.end_session();
+    std::stringstream full_stream;
+    full.write(full_stream);
+    ItchParser full_parser(full_stream);
+    std::vector<Event> all;
+    while (full_parser.good()) {
+        auto events = full_parser.next_packet();
+        all.insert(all.end(), events.begin(), events.end());
+    }
+    std::string types;
+    for (const auto& ev : all) types += static_cast<char>(ev.type);
+    std::cout << "  types=" << types << "\n";
+    const bool full_ok = all.size() == 8 &&
+        all[0].event_code == 'O' &&
+        all[1].symbol == "THYAO.E" && all[1].price_decimals == 3 && all[1].round_lot == 1 &&
+        all[2].tick_size == 10 && all[2].price_to == 19990 &&
+        all[3].price == 9990 && all[3].quantity == 1200 && all[3].ask_quantity == 900 &&
+        all[3].best_bid == 9980 && all[3].best_ask == 10000 &&
+        all[5].quantity == 400 && all[5].price == 10010 && all[5].ranking_seq_num == 2 &&
+        all[6].match_id == 4242 && all[6].price == 10010 && all[6].at_cross && all[6].printable &&
+        all[7].match_id == 4343 && all[7].quantity == 300 && all[7].price == 10020 &&
+        all[7].orderbook_id == TARGET_BOOK && !all[7].at_cross && all[7].timestamp == 8;
+    std::cout << "Full message set " << (full_ok ? "OK" : "WRONG") << "\n";
+
+    // Test resync mode: corrupt framing is skipped, clean packets survive
+    std::cout << "Testing resync after corrupted framing..." << std::endl;
+    TapeWriter clean("TRESYNC001", 1);
+    for (OrderId id = 1; id <= 90; ++id) {
+        clean.add(static_cast<Nanoseconds>(id), id, TARGET_BOOK, Side::Buy, 1, 100, 9990, id);
+        if (id % 3 == 0) clean.flush();
+    }
+    std::vector<std::vector<char>> pkts = clean.packets();   // 30 packets, 3 adds each
+    endian::write_u16_be(&pkts[5][mold::SESSION_SIZE + 8], 0x4000);   // bad count
+    endian::write_u16_be(&pkts[20][mold::HEADER_SIZE], 0);           // bad length
+    pkts[25][mold::HEADER_SIZE + mold::LENGTH_SIZE] = 0x01;             // bad type byte
+    std::string garbage(37, '\x5a');                                    // noise between packets
+    std::stringstream corrupt_stream;
+    uint64_t expected_skip = garbage.size();
+    for (size_t i = 0; i < pkts.size(); ++i) {
+        if (i == 11) corrupt_stream << garbage;
+        if (i == 5 || i == 20 || i == 25) expected_skip += pkts[i].size();
+        corrupt_stream.write(pkts[i].data(), static_cast<std::streamsize>(pkts[i].size()));
+    }
+    ItchParser resync_parser(corrupt_stream);
+    resync_parser.set_resync(true);
+    std::vector<Event> recovered;
+    while (resync_parser.good()) {
+        auto events = resync_parser.next_packet();
+        recovered.insert(recovered.end(), events.begin(), events.end());
+    }
+    bool resync_ok = recovered.size() == 81;
+    for (size_t i = 0, next = 1; resync_ok && i < recovered.size(); ++i, ++next) {
+        if (next == 16 || next == 61 || next == 76) next += 3;   // packets 5, 20, 25
+        resync_ok = recovered[i].order_id == next;
+    }
+    const ResyncStats& rs = resync_parser.resync_stats();
+    std::cout << "  events=" << recovered.size() << " resyncs=" << rs.resyncs
+              << " skipped=" << rs.skipped_bytes << " lost=" << rs.lost_messages << "\n";
+    resync_ok = resync_ok && rs.resyncs == 4 && rs.skipped_bytes == expected_skip && rs.lost_messages == 9;
+    std::cout << "Resync " << (resync_ok ? "OK" : "WRONG") << "\n";
+
+    // Test the orderbook_id filter on a synthetic full-exchange session:
+    // many books, one subscribed, compared against decode-then-filter
+    std::cout << "Testing filtered parsing..." << std::endl;
+    const OrderbookId BOOKS = 800;
+    const OrderbookId FIRST_BOOK = TARGET_BOOK - BOOKS / 2;
+    TapeWriter exchange("TEXCHANGE1", 1);
+    exchange.seconds(36000);
+    exchange.system_event(0, 'O');
+    for (OrderbookId b = 0; b < BOOKS; ++b) {
+        exchange.state(1, FIRST_BOOK + b, "P_SUREKLI_ISLEM");
+    }
+    OrderId next_id = 1;
+    for (Nanoseconds ns = 2; ns < 200; ++ns) {
+        for (OrderbookId b = 0; b < BOOKS; ++b) {
+            const OrderbookId book = FIRST_BOOK + b;
+            const OrderId id = next_id++;
+            exchange.add(ns, id, book, Side::Buy, id, 100, 10000 - (ns % 7) * 10, ns);
+            if (ns % 3 == 0) exchange.execute(ns, id, book, Side::Buy, 40, id);
+            exchange.remove(ns, id, book, Side::Buy);
+        }
+    }
+    exchange.end_session();
+    const std::vector<std::vector<char>>& wire = exchange.packets();
+
+    const OrderbookFilter subscribed{TARGET_BOOK};
+    auto parse_all = [&](const OrderbookFilter* filter, std::vector<Event>& out) {
+        ItchParser decoder;
+        decoder.set_filter(filter);
+        out.clear();
+        for (const auto& pkt : wire) decoder.parse_packet(pkt.data(), pkt.size(), out);
+        return decoder.filtered();
+    };
+
+    std::vector<Event> full_events, filtered_events;
+    parse_all(nullptr, full_events);
+    const size_t skipped = parse_all(&subscribed, filtered_events);
+
+    // same events as decoding everything and dropping other books afterwards
+    std::vector<Event> expected;
+    for (const auto& ev : full_events) {
+        if (ev.orderbook_id == TARGET_BOOK || ev.type == MessageType::Seconds ||
+            ev.type == MessageType::SystemEvent) expected.push_back(ev);
+    }
+    bool filter_ok = expected.size() == filtered_events.size() &&
+                     skipped == full_events.size() - expected.size();
+    for (size_t i = 0; filter_ok && i < expected.size(); ++i) {
+        filter_ok = expected[i].type == filtered_events[i].type &&
+                    expected[i].order_id == filtered_events[i].order_id &&
+                    expected[i].timestamp == filtered_events[i].timestamp;
+    }
+    std::cout << "  messages=" << full_events.size() << " books=" << BOOKS
+              << " kept=" << filtered_events.size() << " skipped=" << skipped << "\n";
+    std::cout << "Filtered parsing " << (filter_ok ? "OK" : "WRONG") << "\n";
+
+    // speedup of filtered over full decode (timing varies by machine)
+    const int ROUNDS = 20;
+    auto time_ns = [&](const OrderbookFilter* filter) {
+        std::vector<Event> out;
+        out.reserve(full_events.size());
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < ROUNDS; ++r) parse_all(filter, out);
+        const auto t1 = std::chrono::steady_clock::now();
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    };
+    const double full_ns = time_ns(nullptr);
+    const double filtered_ns = time_ns(&subscribed);
+    const double msgs = static_cast<double>(full_events.size()) * ROUNDS;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  [BENCH] full=" << full_ns / msgs << " ns/msg filtered=" << filtered_ns / msgs
+              << " ns/msg speedup=" << std::setprecision(2) << full_ns / filtered_ns << "x\n";
+
     std::cout << "\n[TEST_PARSER DONE] Successfully tested ITCH parser\n";
     return 0;
 }
@@ -0,0 +1,221 @@
+// test_queue_position.cpp
+#include "orderbook.h"
+#include "itch_parser.h"
+#include "orderbook_filter.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const OrderbookId BOOK = 123;
+
+static Event make_add(OrderId id, Side s, Price px, Quantity qty, RankingTime rt) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = rt;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    e.timestamp = rt;
+    return e;
+}
+static Event make_exec(OrderId id, Side s, Quantity qty) {
+    Event e{};
+    e.type = MessageType::ExecuteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.quantity = qty;
+    return e;
+}
+static Event make_replace(OrderId id, Side s, Price px, Quantity qty) {
+    Event e{};
+    e.type = MessageType::ReplaceOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    return e;
+}
+static Event make_del(OrderId id, Side s) {
+    Event e{};
+    e.type = MessageType::DeleteOrder;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    return e;
+}
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+// reference answer: walk the level's FIFO from the front
+static bool naive(const Orderbook& ob, OrderId id, Side side, Price price, QueuePosition& out) {
+    const PriceLevel* level = ob.find_level(side, price);
+    if (!level) return false;
+    out = QueuePosition();
+    for (const Order& o : level->fifo) {
+        if (o.id == id) {
+            out.side = side;
+            out.price = price;
+            out.quantity = o.quantity;
+            return true;
+        }
+        out.quantity_ahead += o.quantity;
+        ++out.orders_ahead;
+    }
+    return false;
+}
+
+static bool same(const QueuePosition& a, const QueuePosition& b) {
+    return a.side == b.side && a.price == b.price && a.quantity == b.quantity &&
+           a.quantity_ahead == b.quantity_ahead && a.orders_ahead == b.orders_ahead;
+}
+
+static bool at(const Orderbook& ob, OrderId id, Quantity ahead, uint32_t orders) {
+    QueuePosition p;
+    return ob.queue_position(id, p) && p.quantity_ahead == ahead && p.orders_ahead == orders;
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- scripted FIFO -----
+    std::cout << "=== SCRIPTED ===\n";
+    {
+        Orderbook ob;
+        ob.apply(make_add(1, Side::Buy, 100, 300, 1));
+        ob.apply(make_add(2, Side::Buy, 100, 200, 2));
+        ob.apply(make_add(3, Side::Buy, 100, 100, 3));
+        ob.apply(make_add(9, Side::Sell, 110, 50, 1));
+
+        QueuePosition p;
+        failures += check("front of the queue", ob.queue_position(1, p) && p.orders_ahead == 0 &&
+                                                p.quantity_ahead == 0 && p.quantity == 300 && p.price == 100);
+        failures += check("behind two orders", at(ob, 3, 500, 2));
+        failures += check("unknown order", !ob.queue_position(77, p));
+
+        ob.apply(make_exec(1, Side::Buy, 120));              // index is built now: incremental updates
+        failures += check("partial execution ahead", at(ob, 3, 380, 2) && at(ob, 2, 180, 1));
+        ob.apply(make_del(2, Side::Buy));
+        failures += check("deletion ahead", at(ob, 3, 180, 1));
+        ob.apply(make_add(4, Side::Buy, 100, 70, 4));
+        failures += check("append behind", at(ob, 4, 280, 2));
+        ob.apply(make_replace(1, Side::Buy, 100, 150));      // size-only reduction keeps priority
+        failures += check("reduction keeps priority", at(ob, 1, 0, 0) && at(ob, 4, 250, 2));
+        ob.apply(make_replace(1, Side::Buy, 100, 400));      // increase goes to the back
+        failures += check("increase loses priority", at(ob, 1, 170, 2) && at(ob, 3, 0, 0));
+        ob.apply(make_add(5, Side::Buy, 100, 25, 0));        // earlier ranking time: mid-queue insert
+        failures += check("out-of-order insert rebuilds", at(ob, 5, 0, 0) && at(ob, 3, 25, 1) && at(ob, 1, 195, 3));
+        ob.apply(make_replace(4, Side::Buy, 90, 70));
+        failures += check("price change moves the order", at(ob, 4, 0, 0) && at(ob, 1, 125, 2));
+    }
+
+    // ----- randomized against a FIFO walk -----
+    std::cout << "=== RANDOM ===\n";
+    {
+        Orderbook ob;
+        std::mt19937 rng(23);
+        struct Live { OrderId id; Side side; Price price; Quantity qty; };
+        std::vector<Live> live;
+        OrderId next = 1;
+        bool ok = true;
+        size_t queries = 0;
+        for (RankingTime t = 1; t <= 30000 && ok; ++t) {
+            const unsigned r = rng() % 10;
+            if (r < 5 || live.empty()) {
+                const Side s = (rng() & 1) ? Side::Buy : Side::Sell;
+                const Price px = s == Side::Buy ? 1000 - (rng() % 5) * 10 : 1010 + (rng() % 5) * 10;
+                const Quantity q = 1 + rng() % 500;
+                const RankingTime rt = (rng() % 20 == 0) ? t / 2 : t;          // some late arrivals
+                ob.apply(make_add(next, s, px, q, rt));
+                live.push_back(Live{ next++, s, px, q });
+            } else {
+                const size_t i = rng() % live.size();
+                Live& o = live[i];
+                bool gone = false;
+                if (r < 7) {
+                    ob.apply(make_del(o.id, o.side));
+                    gone = true;
+                } else if (r < 9) {
+                    const Quantity q = 1 + rng() % 300;
+                    ob.apply(make_exec(o.id, o.side, q));
+                    gone = q >= o.qty;
+                    if (!gone) o.qty -= q;
+                } else {
+                    o.price = o.side == Side::Buy ? 1000 - (rng() % 5) * 10 : 1010 + (rng() % 5) * 10;
+                    o.qty = 1 + rng() % 500;
+                    ob.apply(make_replace(o.id, o.side, o.price, o.qty));
+                }
+                if (gone) { live[i] = live.back(); live.pop_back(); }
+            }
+            for (int k = 0; k < 3 && !live.empty(); ++k) {
+                const Live& o = live[rng() % live.size()];
+                QueuePosition fast, slow;
+                ok = ok && ob.queue_position(o.id, fast) && naive(ob, o.id, o.side, o.price, slow) && same(fast, slow);
+                ++queries;
+            }
+        }
+        std::cout << "queries=" << queries << " orders=" << ob.order_count() << "\n";
+        failures += check("queue positions match the FIFO walk", ok);
+    }
+
+    // ----- capture: every resting order checked now and then, timing -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    const OrderbookId TARGET_BOOK = 73616;
+    const OrderbookFilter subscribed{TARGET_BOOK};
+    std::ifstream file(FILE_PATH, std::ios::binary);
+    ItchParser parser(file);
+    parser.set_filter(&subscribed);
+    Orderbook ob;
+    std::vector<OrderId> added;
+    bool ok = true;
+    size_t events = 0, queries = 0;
+    double fast_ns = 0, slow_ns = 0;
+    uint64_t sink = 0;
+    while (parser.good()) {
+        for (const Event& ev : parser.next_packet()) {
+            if (ev.orderbook_id != TARGET_BOOK) continue;
+            ob.apply(ev);
+            ++events;
+            if (ev.type == MessageType::AddOrder) added.push_back(ev.order_id);
+            if (events % 64 != 0) continue;
+            for (size_t i = added.size() > 64 ? added.size() - 64 : 0; i < added.size(); ++i) {
+                QueuePosition fast, slow;
+                const auto t0 = std::chrono::steady_clock::now();
+                const bool found = ob.queue_position(added[i], fast);
+                const auto t1 = std::chrono::steady_clock::now();
+                if (!found) continue;
+                naive(ob, added[i], fast.side, fast.price, slow);
+                const auto t2 = std::chrono::steady_clock::now();
+                ok = ok && same(fast, slow);
+                sink += fast.quantity_ahead + slow.orders_ahead;
+                fast_ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+                slow_ns += std::chrono::duration<double, std::nano>(t2 - t1).count();
+                ++queries;
+            }
+        }
+    }
+    std::cout << "events=" << events << " queries=" << queries
+              << " ns_per_query indexed=" << (queries ? fast_ns / queries : 0)
+              << " fifo_walk=" << (queries ? slow_ns / queries : 0) << " (sink " << (sink != 0) << ")\n";
+    failures += check("capture positions match the FIFO walk", ok && queries > 0);
+
+    std::cout << (failures == 0 ? "[QUEUE POSITION] ALL PASS" : "[QUEUE POSITION] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
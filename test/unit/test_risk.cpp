@@ -0,0 +1,282 @@
+// test_risk.cpp
+#include "risk_engine.h"
+#include "itch_parser.h"
+#include "latency_model.h"
+#include "orderbook.h"
+#include "orderbook_filter.h"
+#include "replay.h"
+#include "replay_observers.h"
+#include "strategy.h"
+#include "types/event.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static int check(const char* name, bool ok) {
+    std::cout << "[" << (ok ? "PASS" : "FAIL") << "] " << name << "\n";
+    return ok ? 0 : 1;
+}
+
+static InstrumentLimits limits(Position max_pos, Position min_pos) {
+    InstrumentLimits l;
+    l.max_position = max_pos;
+    l.min_position = min_pos;
+    return l;
+}
+
+static const OrderbookId BOOK = 123;
+
+static Event make_event(MessageType type, OrderId id, Side s, Price px, Quantity qty) {
+    Event e{};
+    e.type = type;
+    e.orderbook_id = BOOK;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_seq_num = static_cast<RankingSeqNum>(id);
+    return e;
+}
+
+// engine and strategy reservations while delayed orders arrive
+struct Reservations {
+    Position position;
+    Quantity working;       ///< Engine working quantity on the traded side
+    Quantity pending;       ///< Strategy pending quantity on the traded side
+    Quantity other_side;    ///< Engine working quantity on the other side
+};
+
+/**
+ * Two orders in flight on one side (fixed 5 ns latency): the first arrives
+ * while its gap is open and fills, the second arrives after somebody else
+ * closed the gap and is missed. Buy script: tight 100/110, the 110 ask
+ * vanishes twice; sell script: tight 100/110, the 100 bid vanishes twice.
+ */
+static void latency_script(Side side, Reservations& after_fill, Reservations& after_miss) {
+    const bool buy = side == Side::Buy;
+    const Side other = buy ? Side::Sell : Side::Buy;
+    const Price gap = buy ? 110 : 100;                  // vanishing price = order price
+    const Price behind = buy ? 120 : 90;                // next level behind it
+
+    Orderbook book;
+    Strategy strat(BOOK, 100, 500, -500);
+    strat.set_trade_log(nullptr);
+    RiskEngine risk;
+    const uint32_t slot = risk.add_instrument(BOOK, limits(500, -500));
+    strat.set_risk(&risk, slot);
+    LatencyQueue latency(LatencyModel::fixed(5));
+    strat.set_latency(&latency);
+
+    auto step = [&](Timestamp ns, const Event& ev) {
+        latency.release(ns, [&](const DelayedOrder& o) { strat.on_arrival(o, book); });
+        Event e = ev;
+        e.timestamp = e.ranking_time = ns;
+        book.apply(e);
+        TopOfBookChanged top;
+        top.new_bid = book.best_bid_price();
+        top.new_ask = book.best_ask_price();
+        strat.on_top_change(ns, book, top);
+    };
+    auto snapshot = [&](Reservations& r) {
+        r.position = risk.position(slot);
+        r.working = buy ? risk.working_buy(slot) : risk.working_sell(slot);
+        r.pending = buy ? strat.pending_buy() : strat.pending_sell();
+        r.other_side = buy ? risk.working_sell(slot) : risk.working_buy(slot);
+    };
+
+    Event open = make_event(MessageType::OrderbookState, 0, Side::Unknown, 0, 0);
+    open.orderbook_state = "P_SUREKLI_ISLEM";
+    step(1, open);
+    step(2, make_event(MessageType::AddOrder, 1, side, buy ? 100 : 110, 1000));
+    step(2, make_event(MessageType::AddOrder, 2, other, gap, 1000));
+    step(2, make_event(MessageType::AddOrder, 3, other, behind, 1000));
+    step(3, make_event(MessageType::ExecuteOrder, 2, other, 0, 1000));     // order A, arrives at 8
+    step(4, make_event(MessageType::AddOrder, 4, other, gap, 1000));
+    step(5, make_event(MessageType::ExecuteOrder, 4, other, 0, 1000));     // order B, arrives at 10
+    step(8, make_event(MessageType::AddOrder, 5, other, behind, 1000));    // A fills
+    snapshot(after_fill);
+    step(9, make_event(MessageType::AddOrder, 6, side, gap, 1000));        // gap taken
+    step(10, make_event(MessageType::AddOrder, 7, other, behind, 1000));   // B missed
+    snapshot(after_miss);
+}
+
+int main() {
+    int failures = 0;
+
+    // ----- signed positions and working orders -----
+    std::cout << "=== POSITION ===\n";
+    {
+        RiskEngine risk;
+        const uint32_t s = risk.add_instrument(100, limits(300, -200));
+        failures += check("unknown slot", risk.submit(RiskEngine::NO_SLOT, Side::Buy, 10, 1, 0) == RiskCheck::UnknownInstrument);
+        failures += check("slot lookup", risk.slot(100) == s && risk.slot(7) == RiskEngine::NO_SLOT);
+
+        failures += check("short within limit", risk.submit(s, Side::Sell, 1000, 150, 0) == RiskCheck::Ok);
+        failures += check("working sell counts", risk.submit(s, Side::Sell, 1000, 100, 0) == RiskCheck::PositionLimit);
+        risk.on_fill(s, Side::Sell, 1000, 150);
+        std::cout << "position=" << risk.position(s) << " working_sell=" << risk.working_sell(s) << "\n";
+        failures += check("fill moves working into position", risk.position(s) == -150 && risk.working_sell(s) == 0);
+        failures += check("down to min_position", risk.submit(s, Side::Sell, 1000, 50, 0) == RiskCheck::Ok &&
+                                                   risk.submit(s, Side::Sell, 1000, 1, 0) == RiskCheck::PositionLimit);
+        risk.on_cancel(s, Side::Sell, 50);
+        failures += check("cancel frees the room", risk.working_sell(s) == 0 &&
+                                                   risk.submit(s, Side::Buy, 1000, 450, 0) == RiskCheck::Ok &&
+                                                   risk.submit(s, Side::Buy, 1000, 1, 0) == RiskCheck::PositionLimit);
+
+        const uint32_t open = risk.add_instrument(101, InstrumentLimits());
+        failures += check("default limits check nothing", risk.submit(open, Side::Buy, 1000, 1000000, 0) == RiskCheck::Ok &&
+                                                          risk.submit(open, Side::Sell, 1000, 3000000, 0) == RiskCheck::Ok);
+        const uint32_t long_only = risk.add_instrument(102, limits(100, 0));
+        failures += check("min_position 0 still bounds a long-only book",
+                          risk.submit(long_only, Side::Sell, 1000, 1, 0) == RiskCheck::PositionLimit);
+    }
+
+    // ----- instrument and portfolio notionals -----
+    std::cout << "=== NOTIONAL ===\n";
+    {
+        PortfolioLimits portfolio;
+        portfolio.max_gross_notional = 1500000;
+        RiskEngine risk(portfolio);
+        InstrumentLimits l = limits(10000, -10000);
+        l.max_notional = 1000000;
+        const uint32_t a = risk.add_instrument(1, l);
+        const uint32_t b = risk.add_instrument(2, l);
+        risk.mark(a, 1000);
+        risk.mark(b, 1000);
+
+        failures += check("instrument notional", risk.submit(a, Side::Buy, 1000, 1001, 0) == RiskCheck::InstrumentNotional);
+        failures += check("worst side counts", risk.submit(a, Side::Buy, 1000, 800, 0) == RiskCheck::Ok &&
+                                               risk.submit(a, Side::Sell, 1000, 900, 0) == RiskCheck::Ok &&
+                                               risk.notional(a) == 900000);
+        failures += check("portfolio notional across books",
+                          risk.submit(b, Side::Sell, 1000, 700, 0) == RiskCheck::PortfolioNotional &&
+                          risk.submit(b, Side::Sell, 1000, 600, 0) == RiskCheck::Ok &&
+                          risk.gross_notional() == 1500000);
+        risk.mark(a, 500);
+        std::cout << "gross after mark=" << risk.gross_notional() << "\n";
+        failures += check("mark reprices the portfolio", risk.gross_notional() == 450000 + 600000);
+        risk.on_cancel(a, Side::Sell, 900);
+        risk.on_cancel(a, Side::Buy, 800);
+        failures += check("flat instrument has no notional", risk.notional(a) == 0 && risk.gross_notional() == 600000);
+    }
+
+    // ----- fat-finger band and order rate -----
+    std::cout << "=== BAND / RATE ===\n";
+    {
+        RiskEngine risk;
+        InstrumentLimits l = limits(1000000, -1000000);
+        l.price_band_bps = 100;                  // 1%
+        l.max_orders = 3;
+        l.rate_window_ns = 1000;                 // 3 orders per microsecond
+        const uint32_t s = risk.add_instrument(5, l);
+        risk.mark(s, 10000);
+
+        failures += check("inside the band", risk.submit(s, Side::Buy, 10100, 1, 0) == RiskCheck::Ok);
+        failures += check("outside the band", risk.submit(s, Side::Buy, 10101, 1, 0) == RiskCheck::PriceBand &&
+                                              risk.submit(s, Side::Sell, 9899, 1, 0) == RiskCheck::PriceBand);
+        failures += check("burst up to max_orders", risk.submit(s, Side::Buy, 10000, 1, 0) == RiskCheck::Ok &&
+                                                     risk.submit(s, Side::Buy, 10000, 1, 0) == RiskCheck::Ok &&
+                                                     risk.submit(s, Side::Buy, 10000, 1, 0) == RiskCheck::OrderRate);
+        failures += check("refill by event time", risk.submit(s, Side::Buy, 10000, 1, 333) == RiskCheck::OrderRate &&
+                                                   risk.submit(s, Side::Buy, 10000, 1, 334) == RiskCheck::Ok);
+        failures += check("rejects are counted per reason", risk.count(RiskCheck::PriceBand) == 2 &&
+                                                             risk.count(RiskCheck::OrderRate) == 2 &&
+                                                             risk.checks() == 8);
+    }
+
+    // ----- delayed orders: one reservation per order -----
+    std::cout << "=== LATENCY ===\n";
+    {
+        const Side sides[] = { Side::Buy, Side::Sell };
+        for (Side side : sides) {
+            const Position sign = side == Side::Buy ? 1 : -1;
+            Reservations fill, miss;
+            latency_script(side, fill, miss);
+            std::cout << (side == Side::Buy ? "buy" : "sell") << " after fill: position=" << fill.position
+                      << " working=" << fill.working << " pending=" << fill.pending
+                      << " | after miss: position=" << miss.position << " working=" << miss.working
+                      << " pending=" << miss.pending << "\n";
+            failures += check(side == Side::Buy ? "buy fill keeps the order in flight working"
+                                                : "sell fill keeps the order in flight working",
+                              fill.position == 100 * sign && fill.working == 100 && fill.pending == 100 &&
+                              fill.other_side == 0);
+            failures += check(side == Side::Buy ? "buy miss releases the rest" : "sell miss releases the rest",
+                              miss.position == 100 * sign && miss.working == 0 && miss.pending == 0 &&
+                              miss.other_side == 0);
+        }
+    }
+
+    // ----- strategy on the capture: shorting, engine in step -----
+    const char* FILE_PATH = "data/itch_data_250815_HI2.dat";
+    if (!std::ifstream(FILE_PATH)) {
+        std::cerr << "Error: Could not open file " << FILE_PATH << std::endl;
+        return 1;
+    }
+    std::cout << "=== CAPTURE ===\n";
+    const OrderbookId TARGET_BOOK = 73616;
+    const OrderbookFilter subscribed{TARGET_BOOK};
+    auto replay = [&](Strategy& strat, std::ostream* log) {
+        std::ifstream file(FILE_PATH, std::ios::binary);
+        ItchParser parser(file);
+        parser.set_filter(&subscribed);
+        Orderbook book;
+        NullObserver obs;
+        strat.set_trade_log(log);
+        replay_day_top_driven(parser, TARGET_BOOK, book, strat, obs);
+    };
+
+    Strategy long_only(TARGET_BOOK, 100, 1000, 0);
+    replay(long_only, nullptr);
+    Strategy with_engine(TARGET_BOOK, 100, 1000, 0);
+    RiskEngine loose;
+    with_engine.set_risk(&loose, loose.add_instrument(TARGET_BOOK, limits(1000, 0)));
+    replay(with_engine, nullptr);
+    failures += check("engine with the strategy's limits changes nothing",
+                      with_engine.realized_pnl() == long_only.realized_pnl() &&
+                      with_engine.position() == long_only.position() && with_engine.risk_rejects() == 0);
+
+    Strategy shorting(TARGET_BOOK, 100, 1000, -1000);
+    RiskEngine risk;
+    InstrumentLimits l = limits(1000, -1000);
+    l.max_notional = 4000000;
+    const uint32_t slot = risk.add_instrument(TARGET_BOOK, l);
+    shorting.set_risk(&risk, slot);
+    std::ostringstream short_log;
+    replay(shorting, &short_log);
+    std::cout << "long_only pos=" << long_only.position() << " pnl=" << long_only.realized_pnl()
+              << " | shorting pos=" << shorting.position() << " pnl=" << shorting.realized_pnl()
+              << " sold=" << shorting.sold() << " rejects=" << shorting.risk_rejects()
+              << " notional_rejects=" << risk.count(RiskCheck::InstrumentNotional) << "\n";
+    failures += check("short selling below zero", short_log.str().find("pos=-") != std::string::npos);
+    failures += check("engine position matches strategy", risk.position(slot) == shorting.position() &&
+                                                          risk.working_buy(slot) == 0 && risk.working_sell(slot) == 0);
+    failures += check("notional cap bites", shorting.risk_rejects() > 0 &&
+                                            risk.notional(slot) <= l.max_notional);
+
+    // hot-path cost
+    RiskEngine bench;
+    InstrumentLimits bl = limits(1000000000, -1000000000);
+    bl.max_notional = 1000000000000;
+    bl.price_band_bps = 500;
+    bl.max_orders = 1000;
+    bl.rate_window_ns = 1000;
+    for (OrderbookId book = 1; book <= 64; ++book) bench.add_instrument(book, bl);
+    const size_t N = 1000000;
+    size_t ok = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N; ++i) {
+        const uint32_t s = static_cast<uint32_t>(i & 63);
+        const Side side = (i & 64) ? Side::Sell : Side::Buy;
+        if (bench.submit(s, side, 10000 + static_cast<Price>(i & 7), 10, i * 100) == RiskCheck::Ok) {
+            ++ok;
+            bench.on_fill(s, side, 10000, 10);
+        }
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "checks=" << N << " ok=" << ok << " ns_per_check_and_fill=" << ms * 1e6 / N << "\n";
+
+    std::cout << (failures == 0 ? "[RISK] ALL PASS" : "[RISK] FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+// test_shm_book.cpp
+#include "orderbook.h"
+#include "shm_book.h"
+#include "types/event.h"
+
+#include <iostream>
+#include <string>
+#include <cstdint>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ----- event factories -----
+static Event make_state(OrderbookId book, const char* state, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::OrderbookState;
+    e.orderbook_id = book;
+    e.orderbook_state = state;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_add(OrderbookId book, OrderId id, Side s, Price px, Quantity qty,
+                      RankingTime rt, RankingSeqNum rsn, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = book;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = rt;
+    e.ranking_seq_num = rsn;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+
+static void print_snapshot(const shm_book::Snapshot& s) {
+    std::cout << "book=" << s.book_id << " ns=" << s.nanosec << " updates=" << s.updates
+              << " open=" << s.trading_open
+              << " bbo=" << s.best_bid << "x" << s.best_bid_qty
+              << " / " << s.best_ask << "x" << s.best_ask_qty << "\n";
+    for (uint32_t i = 0; i < s.bid_levels; ++i)
+        std::cout << "  bid " << s.bids[i].price << " x " << s.bids[i].quantity << "\n";
+    for (uint32_t i = 0; i < s.ask_levels; ++i)
+        std::cout << "  ask " << s.asks[i].price << " x " << s.asks[i].quantity << "\n";
+}
+
+int main() {
+    const OrderbookId BOOK = 73616;
+    const OrderbookId OTHER = 70000;
+    const std::string NAME = "/orderbook_test_" + std::to_string(getpid());
+    int failures = 0;
+
+    // ----- basic publish / read -----
+    std::cout << "=== PUBLISH / READ ===\n";
+    ShmBookPublisher pub(NAME, /*slots=*/4, /*depth=*/3);
+    if (!pub.ok()) return 1;
+
+    Orderbook ob;
+    uint64_t ns = 100;
+    ob.apply(make_state(BOOK, "P_SUREKLI_ISLEM", ns));
+    ob.apply(make_add(BOOK, 1, Side::Buy,  10000, 100, 1, 1, ns));
+    ob.apply(make_add(BOOK, 2, Side::Buy,   9990, 200, 1, 2, ns));
+    ob.apply(make_add(BOOK, 3, Side::Buy,   9980, 300, 1, 3, ns));
+    ob.apply(make_add(BOOK, 4, Side::Buy,   9970, 400, 1, 4, ns));
+    ob.apply(make_add(BOOK, 5, Side::Sell, 10010, 150, 1, 5, ns));
+    ob.apply(make_add(BOOK, 6, Side::Sell, 10020, 250, 1, 6, ns));
+    pub.publish(BOOK, ob, ns);
+
+    ShmBookReader reader(NAME);
+    if (!reader.ok()) return 1;
+
+    shm_book::Snapshot snap;
+    if (reader.read(OTHER, snap)) {
+        std::cout << "[FAIL] unpublished book readable\n";
+        ++failures;
+    }
+    if (!reader.read(BOOK, snap)) {
+        std::cout << "[FAIL] published book not readable\n";
+        return 1;
+    }
+    print_snapshot(snap);
+    if (snap.best_bid != 10000 || snap.best_ask != 10010 || snap.bid_levels != 3 ||
+        snap.ask_levels != 2 || snap.bids[2].price != 9980 || snap.best_ask_qty != 150) {
+        std::cout << "[FAIL] snapshot mismatch\n";
+        ++failures;
+    }
+
+    // second book lands in its own slot
+    Orderbook other;
+    other.apply(make_add(OTHER, 7, Side::Sell, 5000, 10, 1, 1, ns));
+    pub.publish(OTHER, other, ns);
+    if (!reader.read(OTHER, snap) || snap.book_id != OTHER || snap.best_ask != 5000 || snap.bid_levels != 0) {
+        std::cout << "[FAIL] second book mismatch\n";
+        ++failures;
+    }
+
+    // ----- concurrent reader process -----
+    // Update k improves both sides with a new level of quantity k, so a
+    // consistent snapshot has bid 1000+k x k and ask 200000-k x k.
+    std::cout << "=== CONCURRENT READER ===\n";
+    const uint64_t UPDATES = 50000;
+    const uint64_t base_updates = snap.updates;
+
+    std::cout.flush();
+    pid_t child = fork();
+    if (child == 0) {
+        ShmBookReader r(NAME);
+        if (!r.ok()) _exit(2);
+        shm_book::Snapshot s;
+        uint64_t torn = 0, reads = 0;
+        do {
+            r.read(OTHER, s);
+            ++reads;
+            const uint64_t k = s.updates - base_updates;
+            if (k == 0) continue;   // writer has not started yet
+            if (s.best_bid != 1000 + k || s.best_ask != 200000 - k ||
+                s.best_bid_qty != k || s.best_ask_qty != k ||
+                s.bids[0].price != s.best_bid || s.asks[0].quantity != k) ++torn;
+        } while (s.updates - base_updates < UPDATES);
+        std::cout << "[CHILD] torn=" << torn << (reads > UPDATES / 100 ? "" : " (few reads)") << std::endl;
+        _exit(torn == 0 ? 0 : 1);
+    }
+
+    Orderbook live;
+    for (uint64_t k = 1; k <= UPDATES; ++k) {
+        ++ns;
+        live.apply(make_add(OTHER, 100 + 2 * k, Side::Buy,  static_cast<Price>(1000 + k),   k, 1, 3, ns));
+        live.apply(make_add(OTHER, 101 + 2 * k, Side::Sell, static_cast<Price>(200000 - k), k, 1, 3, ns));
+        pub.publish(OTHER, live, ns);
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    const bool child_ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    std::cout << "[CONCURRENT] " << (child_ok ? "CONSISTENT" : "TORN READS") << "\n";
+    if (!child_ok) ++failures;
+
+    pub.unlink();
+    std::cout << "[SHM BOOK] " << (failures == 0 ? "ALL PASS" : "FAILURES") << "\n";
+    return failures == 0 ? 0 : 1;
+}
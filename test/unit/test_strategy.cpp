@@ -59,6 +59,7 @@ static Event make_state(OrderbookId book, const char* state, uint64_t ns) {
     e.orderbook_id = book;
     e.orderbook_state = state;
     e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 static Event make_add(OrderbookId book, OrderId id, Side s, Price px, Quantity qty,
@@ -73,6 +74,7 @@ static Event make_add(OrderbookId book, OrderId id, Side s, Price px, Quantity q
     e.ranking_time = rt;
     e.ranking_seq_num = rsn;
     e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 static Event make_exec(OrderbookId book, OrderId id, Side s, Quantity qty, uint64_t ns) {
@@ -83,6 +85,7 @@ static Event make_exec(OrderbookId book, OrderId id, Side s, Quantity qty, uint6
     e.side = s;
     e.quantity = qty; // no price in spec
     e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 static Event make_del(OrderbookId book, OrderId id, Side s, uint64_t ns) {
@@ -92,6 +95,7 @@ static Event make_del(OrderbookId book, OrderId id, Side s, uint64_t ns) {
     e.order_id = id;
     e.side = s;
     e.nanosec = ns;
+    e.timestamp = ns;
     return e;
 }
 
@@ -150,8 +154,8 @@ int main() {
 
     auto push = [&](const Event& ev) {
         // boundary BEFORE store/apply
-        if (!have_batch) { batch_ns = ev.nanosec; have_batch = true; }
-        else if (ev.nanosec != batch_ns) { flush_batch(batch_ns); batch_ns = ev.nanosec; have_batch = true; }
+        if (!have_batch) { batch_ns = ev.timestamp; have_batch = true; }
+        else if (ev.timestamp != batch_ns) { flush_batch(batch_ns); batch_ns = ev.timestamp; have_batch = true; }
 
         ob.apply(ev);
         ns_batch.push_back(ev);
@@ -299,4 +303,30 @@ int main() {
     std::cout << "\n[SIM DONE] final pos=" << strat.position()
               << " pnl=" << strat.realized_pnl() << "\n";
 
+    // ------------------------------------------------------------------
+    // BANDED TICKS: BIST table, prices in the 50-100 TL band (tick 0.05 TL
+    // = 50 units). With the default 10-unit tick this gap would be ignored.
+    // ------------------------------------------------------------------
+    std::cout << "\n=== BANDED TICKS: 60.000/60.050 -> ask vanishes -> BUY @60050 ===" << std::endl;
+    Orderbook ob2;
+    Strategy  strat2(BOOK, /*order_qty=*/100, /*max_pos=*/500, /*min_pos=*/0, TickTable::bist_equity());
+    std::vector<Event> b2;
+
+    b2.push_back(make_state(BOOK, "P_SUREKLI_ISLEM", 1));
+    b2.push_back(make_add(BOOK, 5000, Side::Buy,  60000, LOT, 1, 1, 1));
+    b2.push_back(make_add(BOOK, 6000, Side::Sell, 60050, LOT, 1, 2, 1));
+    b2.push_back(make_add(BOOK, 6001, Side::Sell, 60100, LOT, 1, 3, 1));
+    for (const auto& ev : b2) ob2.apply(ev);
+    strat2.on_batch(1, ob2, b2);   // tight 60000/60050 (one 50-unit tick)
+    print_top(ob2);
+
+    b2.clear();
+    b2.push_back(make_exec(BOOK, 6000, Side::Sell, LOT, 2));
+    for (const auto& ev : b2) ob2.apply(ev);
+    strat2.on_batch(2, ob2, b2);   // gap 60000/60100 -> BUY @60050
+    print_top(ob2);
+
+    std::cout << "\n[BANDED DONE] pos=" << strat2.position()
+              << " pnl=" << strat2.realized_pnl() << " (expected pos=100 pnl=-6005000)\n";
+
 }
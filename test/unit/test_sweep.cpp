@@ -0,0 +1,145 @@
+// test_sweep.cpp
+#include "orderbook.h"
+#include "strategy.h"
+#include "strategy_sweep.h"
+#include "types/event.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+// ----- event factories -----
+static Event make_state(OrderbookId book, const char* state, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::OrderbookState;
+    e.orderbook_id = book;
+    e.orderbook_state = state;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_add(OrderbookId book, OrderId id, Side s, Price px, Quantity qty,
+                      RankingTime rt, RankingSeqNum rsn, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::AddOrder;
+    e.orderbook_id = book;
+    e.order_id = id;
+    e.side = s;
+    e.price = px;
+    e.quantity = qty;
+    e.ranking_time = rt;
+    e.ranking_seq_num = rsn;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+static Event make_exec(OrderbookId book, OrderId id, Side s, Quantity qty, uint64_t ns) {
+    Event e{};
+    e.type = MessageType::ExecuteOrder;
+    e.orderbook_id = book;
+    e.order_id = id;
+    e.side = s;
+    e.quantity = qty;
+    e.nanosec = ns;
+    e.timestamp = ns;
+    return e;
+}
+
+// ----- random tape around a fixed mid, prone to 1-tick gaps -----
+struct LiveOrder { OrderId id; Side side; Quantity qty; };
+
+static std::vector<Event> make_tape(OrderbookId book, size_t n) {
+    std::vector<Event> tape;
+    std::vector<LiveOrder> live;
+    const Price MID = 10000;
+    OrderId next_id = 1;
+    uint64_t ns = 100;
+    std::srand(42);
+
+    tape.push_back(make_state(book, "P_SUREKLI_ISLEM", ns));
+    for (size_t i = 0; i < n; ++i) {
+        if (std::rand() % 3 == 0) ns += 1 + std::rand() % 5;
+        const bool add = live.size() < 6 || (live.size() < 25 && std::rand() % 10 < 4);
+        if (add) {
+            const Side s = (std::rand() % 2) ? Side::Buy : Side::Sell;
+            const Price off = static_cast<Price>((std::rand() % 4) * 10);
+            const Price px = (s == Side::Buy) ? MID - 10 - off : MID + off;
+            const Quantity q = 100 * (1 + std::rand() % 3);
+            live.push_back(LiveOrder{ next_id, s, q });
+            tape.push_back(make_add(book, next_id, s, px, q, ns, 0, ns));
+            ++next_id;
+        } else {
+            const size_t k = std::rand() % live.size();
+            tape.push_back(make_exec(book, live[k].id, live[k].side, live[k].qty, ns));
+            live.erase(live.begin() + k);
+        }
+    }
+    tape.push_back(make_state(book, "P_MARJ_YAYIN_KAPANIS", ns + 1));
+    return tape;
+}
+
+// ----- drive any strategy-like object through ns batches -----
+template <typename S>
+static void run_tape(const std::vector<Event>& tape, Orderbook& ob, S& strat) {
+    std::vector<Event> batch;
+    uint64_t batch_ns = 0;
+    for (const auto& ev : tape) {
+        if (!batch.empty() && ev.timestamp != batch_ns) {
+            strat.on_batch(batch_ns, ob, batch);
+            batch.clear();
+        }
+        batch_ns = ev.timestamp;
+        ob.apply(ev);
+        batch.push_back(ev);
+    }
+    if (!batch.empty()) strat.on_batch(batch_ns, ob, batch);
+}
+
+int main() {
+    const OrderbookId BOOK = 123;
+    const std::vector<Event> tape = make_tape(BOOK, 20000);
+
+    // sweep: all configs in one pass
+    StrategySweep sweep(BOOK);
+    sweep.add_grid(/*order_qty=*/{50, 100, 300},
+                   /*max_pos=*/{200, 1000},
+                   /*min_pos=*/{0, 100},
+                   /*tick=*/{10},
+                   /*gap_ticks=*/{2});
+    {
+        Orderbook ob;
+        run_tape(tape, ob, sweep);
+    }
+
+    std::cout << "=== SWEEP RESULTS (" << sweep.size() << " configs, "
+              << tape.size() << " events) ===\n";
+    sweep.write_results(std::cout);
+
+    // reference: one Strategy + replay per config (Strategy logs silenced)
+    size_t mismatches = 0;
+    for (size_t i = 0; i < sweep.size(); ++i) {
+        const SweepParams p = sweep.params(i);
+        Orderbook ob;
+        Strategy strat(BOOK, p.order_quantity, p.max_position, p.min_position);
+
+        std::ostringstream sink;
+        std::streambuf* old = std::cout.rdbuf(sink.rdbuf());
+        run_tape(tape, ob, strat);
+        std::cout.rdbuf(old);
+
+        const bool same = static_cast<int64_t>(strat.position()) == sweep.position(i) &&
+                          strat.realized_pnl() == sweep.realized_pnl(i);
+        if (!same) {
+            ++mismatches;
+            std::cout << "[MISMATCH] config " << i
+                      << " strategy pos=" << strat.position() << " pnl=" << strat.realized_pnl()
+                      << " sweep pos=" << sweep.position(i) << " pnl=" << sweep.realized_pnl(i) << "\n";
+        }
+    }
+
+    std::cout << "\n[TEST_SWEEP DONE] configs=" << sweep.size()
+              << " mismatches=" << mismatches << "\n";
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+// test_udp.cpp
+#include "itch_parser.h"
+#include "moldudp64.h"
+#include "udp_feed.h"
+#include "udp_receiver.h"
+#include "udp_sender.h"
+#include "util/pacer.h"
+#include "util/tape_writer.h"
+#include "types/event.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+// ----- synthetic capture: states, adds, executions, deletes, one unknown type -----
+static TapeWriter make_tape(size_t n) {
+    TapeWriter w("TESTSESS01", 1, 400);   // small packets -> many datagrams
+    const OrderbookId BOOK = 73616;
+    Nanoseconds ns = 1000;
+    std::srand(7);
+
+    w.state(ns, BOOK, "P_SUREKLI_ISLEM");
+    for (size_t i = 1; i <= n; ++i) {
+        ns += std::rand() % 3;
+        const Side side = (i % 2) ? Side::Buy : Side::Sell;
+        const Price px = side == Side::Buy ? 9990 - 10 * (std::rand() % 3) : 10000 + 10 * (std::rand() % 3);
+        w.add(ns, i, BOOK, side, static_cast<RankingSeqNum>(i), 100 + i, px, 5000 + i);
+        if (i % 7 == 0) w.execute(ns, i, BOOK, side, 50, i);
+        if (i % 11 == 0) w.remove(ns, i - 1, BOOK, (i % 2) ? Side::Sell : Side::Buy);
+        if (i % 50 == 0) w.raw('X', "\x01\x02\x03", 3);
+        if (i % 13 == 0) w.flush();
+    }
+    w.state(ns + 1, BOOK, "P_MARJ_YAYIN_KAPANIS");
+    w.end_session();
+    return w;
+}
+
+static bool same_event(const Event& a, const Event& b) {
+    return a.type == b.type && a.nanosec == b.nanosec && a.orderbook_id == b.orderbook_id &&
+           a.order_id == b.order_id && a.side == b.side && a.quantity == b.quantity &&
+           a.price == b.price && a.ranking_time == b.ranking_time &&
+           a.ranking_seq_num == b.ranking_seq_num && a.orderbook_state == b.orderbook_state;
+}
+
+int main() {
+    int failures = 0;
+    TapeWriter tape = make_tape(500);
+
+    // ----- reference: decode the capture through the istream path -----
+    std::stringstream capture;
+    tape.write(capture);
+    ItchParser file_parser(capture);
+    std::vector<Event> expected;
+    while (file_parser.good()) {
+        auto events = file_parser.next_packet();
+        expected.insert(expected.end(), events.begin(), events.end());
+    }
+    std::cout << "packets=" << tape.packets().size() << " events=" << expected.size() << "\n";
+
+    // ----- framing: next_raw_packet returns the packets byte for byte -----
+    std::cout << "=== RAW FRAMING ===\n";
+    std::stringstream capture2;
+    tape.write(capture2);
+    ItchParser framer(capture2);
+    std::vector<char> raw;
+    size_t framed = 0, mismatched = 0;
+    while (framer.good()) {
+        if (!framer.next_raw_packet(raw)) continue;
+        if (raw != tape.packets()[framed]) ++mismatched;
+        ++framed;
+    }
+    // the end-of-session packet has count 0xFFFF and is rejected by the file framer
+    std::cout << "framed=" << framed << " mismatched=" << mismatched << "\n";
+    if (framed + 1 != tape.packets().size() || mismatched != 0) ++failures;
+
+    // ----- truncated datagram: complete messages decode, the rest is dropped -----
+    std::cout << "=== TRUNCATED DATAGRAM ===\n";
+    {
+        ItchParser decoder;
+        const std::vector<char>& p = tape.packets()[0];
+        std::vector<Event> full, cut;
+        const size_t n_full = decoder.parse_packet(p.data(), p.size(), full);
+        const size_t n_cut  = decoder.parse_packet(p.data(), p.size() - 5, cut);
+        std::cout << "full=" << full.size() << " cut=" << cut.size() << "\n";
+        if (n_cut + 1 != n_full || cut.size() + 1 != full.size()) ++failures;
+    }
+
+    // ----- loopback: the same packets as datagrams through UdpFeed -----
+    std::cout << "=== LOOPBACK ===\n";
+    UdpReceiverConfig cfg;
+    cfg.bind_addr = "127.0.0.1";
+    cfg.port = 0;
+    cfg.rcvbuf_bytes = 0;
+    cfg.batch = 8;
+    UdpReceiver rx(cfg);
+    if (!rx.ok()) return 1;
+
+    UdpSender tx("127.0.0.1", rx.local_port());
+    if (!tx.ok()) return 1;
+
+    ItchParser decoder;
+    UdpFeed feed(rx, decoder);
+    std::vector<Event> received;
+    bool stamped = true;
+    size_t sent = 0;
+    while (feed.good()) {
+        // keep a few datagrams in flight so default socket buffers suffice
+        while (sent < tape.packets().size() && sent < feed.packets() + 16) {
+            const std::vector<char>& p = tape.packets()[sent++];
+            tx.send(p.data(), p.size());
+        }
+        const uint64_t before = feed.packets();
+        auto events = feed.next_packet();
+        if (feed.packets() == before && sent == tape.packets().size()) break;   // timed out: datagram lost
+        if (!events.empty() && feed.last_rx_ns() == 0) stamped = false;
+        received.insert(received.end(), events.begin(), events.end());
+    }
+
+    size_t diff = 0;
+    for (size_t i = 0; i < expected.size() && i < received.size(); ++i) {
+        if (!same_event(expected[i], received[i])) ++diff;
+    }
+    std::cout << "received=" << received.size() << " diff=" << diff
+              << " end_of_session=" << (feed.good() ? "no" : "yes")
+              << " kernel_timestamps=" << (stamped ? "yes" : "no") << "\n";
+    if (received.size() != expected.size() || diff != 0 || feed.good() || !stamped) ++failures;
+
+    // ----- pacing: capture timestamps (seconds + ns) drive the send schedule -----
+    std::cout << "=== PACING ===\n";
+    {
+        // 20 packets 1 ms apart, crossing a second boundary after the 10th
+        TapeWriter paced("PACESESS01", 1);
+        paced.seconds(36000);
+        for (uint32_t i = 0; i < 20; ++i) {
+            if (i == 10) paced.seconds(36001);
+            const Nanoseconds ns = (i < 10 ? 990000000u : 0u) + (i % 10) * 1000000u;
+            paced.add(ns, i + 1, 73616, Side::Buy, i + 1, 100, 9990, i);
+            paced.flush();
+        }
+
+        uint32_t seconds = 0;
+        uint64_t t = 0, first = 0, prev = 0;
+        bool monotonic = true;
+        std::vector<uint64_t> stamps;
+        for (const auto& p : paced.packets()) {
+            if (!ItchParser::packet_time(p.data(), p.size(), seconds, t)) continue;
+            if (stamps.empty()) first = t;
+            else if (t != prev + 1000000) monotonic = false;
+            stamps.push_back(t);
+            prev = t;
+        }
+        std::cout << "stamped=" << stamps.size() << " first=" << first
+                  << " span_ns=" << (prev - first) << " spacing_1ms=" << (monotonic ? "yes" : "no") << "\n";
+        if (stamps.size() != 20 || first != 36000990000000ull || !monotonic) ++failures;
+
+        Pacer pacer(1.0);
+        for (uint64_t s : stamps) pacer.wait(s);
+        const uint64_t elapsed = pacer.elapsed_ns();
+        const bool on_schedule = elapsed >= pacer.span_ns() && elapsed < pacer.span_ns() + 20000000;
+        std::cout << "paced span_us=" << pacer.span_ns() / 1000
+                  << " on_schedule=" << (on_schedule ? "yes" : "no") << "\n";
+        if (!on_schedule) ++failures;
+    }
+
+    std::cout << "[UDP] " << (failures == 0 ? "ALL PASS" : "FAILURES") << "\n";
+    return failures == 0 ? 0 : 1;
+}